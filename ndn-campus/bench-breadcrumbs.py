@@ -0,0 +1,82 @@
+#!/usr/bin/env python
+# -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+
+# Runs ccn-mobility-jl with each forwarding baseline (flood, smart, bestr),
+# without and with --breadcrumbs, for the same RngRuns, and reports what
+# moving the FIB entries along with the producer saves: Interests sent out
+# of network faces, Interests timed out in the PITs, and the satisfied
+# Interests with their mean full delay and retransmissions.
+#
+#   ./bench-breadcrumbs.py -r 5
+#   ./bench-breadcrumbs.py -s flood,bestr -e 0.5 -- --fastmac
+
+from __future__ import print_function
+
+import argparse
+import glob
+import os
+
+import runstats
+
+parser = argparse.ArgumentParser(description='Producer mobility breadcrumbs benchmark')
+parser.add_argument('-b', '--binary', dest='binary', type=str, default='build/ccn-mobility-jl',
+                    help='Scenario binary [build/ccn-mobility-jl]')
+parser.add_argument('-s', '--strategies', dest='strategies', type=str, default='flood,smart,bestr',
+                    help='Baselines to compare [flood,smart,bestr]')
+parser.add_argument('-e', '--expiry', dest='expiry', type=float, default=0.0,
+                    help='Seconds routers keep the previous breadcrumbs [0]')
+parser.add_argument('-r', '--runs', dest='runs', type=int, default=3,
+                    help='RngRuns per baseline and mode [3]')
+parser.add_argument('-d', '--dir', dest='dir', type=str, default='results/bench-breadcrumbs',
+                    help='Results directory [results/bench-breadcrumbs]')
+parser.add_argument('args', metavar='arg', type=str, nargs='*',
+                    help='Extra scenario arguments, e.g. --mobile=4')
+
+args = parser.parse_args()
+
+FLAGS = {'flood': [], 'smart': ['--smart'], 'bestr': ['--bestr']}
+
+# Interests out of network faces, app faces excluded, and PIT timeouts
+def interests(results):
+    sent, timeouts = 0, 0
+    for cols in runstats.rows(results, '*-aggregate-trace-*'):
+        if len(cols) < 6:
+            continue
+        if cols[4] == 'OutInterests' and not cols[3].startswith('dev=local'):
+            sent += int(float(cols[5]))
+        elif cols[4] == 'TimedOutInterests':
+            timeouts += int(float(cols[5]))
+    return sent, timeouts
+
+def run(strategy, breadcrumbs, rngrun):
+    mode = strategy + ('-breadcrumbs' if breadcrumbs else '')
+    results = os.path.join(args.dir, mode, 'run-%02d' % rngrun)
+    for old in glob.glob(os.path.join(results, '*-trace-*')):
+        os.remove(old)
+
+    extra = ['--breadcrumbs', '--expiry=%f' % args.expiry] if breadcrumbs else []
+    cmd = [args.binary, '--trace', '--results=%s' % results,
+           '--RngRun=%d' % rngrun] + FLAGS[strategy] + extra + args.args
+    runstats.run(cmd, results)
+
+    sent, timeouts = interests(results)
+    return {'sent': sent, 'timeouts': timeouts}, runstats.delays(results)
+
+strategies = args.strategies.split(',')
+for strategy in strategies:
+    if strategy not in FLAGS:
+        parser.error('unknown strategy %s, use flood, smart or bestr' % strategy)
+
+runs = range(1, args.runs + 1)
+keys = [('sent', 'sent'), ('timeouts', 'timeouts'), ('interests', 'satisfied'),
+        ('delay', 'delay (s)'), ('retx', 'retx')]
+
+for strategy in strategies:
+    without = runstats.summary([run(strategy, False, i) for i in runs])
+    crumbs = runstats.summary([run(strategy, True, i) for i in runs])
+
+    print('%-12s %12s %12s %10s' % (strategy, 'default', 'breadcrumbs', 'change'))
+    for key, label in keys:
+        print('%-12s %12.4f %12.4f %9.1f%%' % (label, without[key], crumbs[key],
+                                               runstats.change(without[key], crumbs[key])))
+    print()
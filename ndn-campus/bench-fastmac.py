@@ -0,0 +1,57 @@
+#!/usr/bin/env python
+# -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+
+# Runs ccn-mobility-jl with the full Wi-Fi MAC and with --fastmac for the
+# same RngRuns, then reports how much faster the ideal association is and
+# how far it moves the NDN metrics of the app delay traces: satisfied
+# Interests, mean full delay, mean retransmissions and mean hop count.
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+
+import runstats
+
+parser = argparse.ArgumentParser(description='Full MAC vs ideal association benchmark')
+parser.add_argument('-b', '--binary', dest='binary', type=str, default='build/ccn-mobility-jl',
+                    help='Scenario binary [build/ccn-mobility-jl]')
+parser.add_argument('-r', '--runs', dest='runs', type=int, default=3,
+                    help='RngRuns per mode [3]')
+parser.add_argument('-o', '--outage', dest='outage', type=float, default=0.0,
+                    help='Handoff outage of --fastmac, in seconds [0]')
+parser.add_argument('-n', '--nearest', dest='nearest', action='store_true', default=False,
+                    help='Follow the closest AP instead of the schedule')
+parser.add_argument('-d', '--dir', dest='dir', type=str, default='results/bench-fastmac',
+                    help='Results directory [results/bench-fastmac]')
+parser.add_argument('args', metavar='arg', type=str, nargs='*',
+                    help='Extra scenario arguments, e.g. --clients=4')
+
+args = parser.parse_args()
+
+def run(mode, rngrun, extra):
+    results = os.path.join(args.dir, mode, 'run-%02d' % rngrun)
+    timing = os.path.join(results, 'timing.json')
+    cmd = [args.binary, '--trace', '--results=%s' % results, '--timing=%s' % timing,
+           '--RngRun=%d' % rngrun] + extra + args.args
+    runstats.run(cmd, results)
+
+    with open(timing) as f:
+        record = json.loads(f.readlines()[-1])
+
+    return {'run': record['phases'].get('run', 0.0), 'total': record['total']}, runstats.delays(results)
+
+fast = ['--fastmac', '--outage=%f' % args.outage] + (['--nearest'] if args.nearest else [])
+
+full = runstats.summary([run('full', i, []) for i in range(1, args.runs + 1)])
+ideal = runstats.summary([run('fastmac', i, fast) for i in range(1, args.runs + 1)])
+
+print('%-12s %12s %12s %10s' % ('', 'full MAC', 'fastmac', 'change'))
+for key, label in [('run', 'run (s)'), ('total', 'total (s)'), ('interests', 'interests'),
+                   ('delay', 'delay (s)'), ('retx', 'retx'), ('hops', 'hops')]:
+    change = runstats.change(full[key], ideal[key])
+    print('%-12s %12.4f %12.4f %9.1f%%' % (label, full[key], ideal[key], change))
+
+if ideal['run'] > 0:
+    print('Speedup of Simulator::Run (): %.2fx' % (full['run'] / ideal['run']))
@@ -0,0 +1,86 @@
+#!/usr/bin/env python
+# -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+
+# Runs disaster-ccn-scenario1_zl with each --placement decision for the same
+# RngRuns, so every node has the same content store and the aggregate cache
+# budget is equal, then compares each decision with Always: network wide
+# cache hit ratio, Data the server had to produce, satisfied Interests and
+# their mean full delay and hop count.
+#
+#   ./bench-placement.py -r 5
+#   ./bench-placement.py -p Always,Lcd -- --csbytes=3145728
+
+from __future__ import print_function
+
+import argparse
+import glob
+import os
+
+import runstats
+
+parser = argparse.ArgumentParser(description='Cache placement benchmark')
+parser.add_argument('-b', '--binary', dest='binary', type=str, default='build/disaster-ccn-scenario1_zl',
+                    help='Scenario binary [build/disaster-ccn-scenario1_zl]')
+parser.add_argument('-p', '--placements', dest='placements', type=str, default='Always,Lcd,ProbCache,Betweenness',
+                    help='Decisions to compare, the first one is the baseline [Always,Lcd,ProbCache,Betweenness]')
+parser.add_argument('-r', '--runs', dest='runs', type=int, default=3,
+                    help='RngRuns per decision [3]')
+parser.add_argument('-d', '--dir', dest='dir', type=str, default='results/bench-placement',
+                    help='Results directory [results/bench-placement]')
+parser.add_argument('args', metavar='arg', type=str, nargs='*',
+                    help='Extra scenario arguments, e.g. --duration=30')
+
+args = parser.parse_args()
+
+# Cache hits and misses of every node
+def caches(results):
+    hits, misses = 0, 0
+    for cols in runstats.rows(results, '*-cs-trace-*'):
+        if len(cols) >= 4 and cols[2] == 'CacheHits':
+            hits += int(cols[3])
+        elif len(cols) >= 4 and cols[2] == 'CacheMisses':
+            misses += int(cols[3])
+    return hits, misses
+
+# Data the producer app handed to the server node
+def served(results):
+    servers = set()
+    for filename in glob.glob(os.path.join(results, '*-servers-*')):
+        with open(filename) as f:
+            servers.update(line.strip() for line in f if line.strip())
+
+    data = 0
+    for cols in runstats.rows(results, '*-aggregate-trace-*'):
+        if len(cols) >= 6 and cols[1] in servers and cols[3].startswith('dev=local') and cols[4] == 'InData':
+            data += int(float(cols[5]))
+    return data
+
+def run(placement, rngrun):
+    results = os.path.join(args.dir, placement, 'run-%02d' % rngrun)
+    for old in glob.glob(os.path.join(results, '*-trace-*')):
+        os.remove(old)
+
+    cmd = [args.binary, '--placement=%s' % placement, '--results=%s' % results,
+           '--RngRun=%d' % rngrun] + args.args
+    runstats.run(cmd, results)
+
+    hits, misses = caches(results)
+    values = {'hitratio': float(hits) / (hits + misses) if hits + misses else 0.0,
+              'served': served(results)}
+    return values, runstats.delays(results)
+
+placements = args.placements.split(',')
+results = [runstats.summary([run(p, i) for i in range(1, args.runs + 1)]) for p in placements]
+
+keys = [('hitratio', 'hit ratio'), ('served', 'served Data'), ('interests', 'interests'),
+        ('delay', 'delay (s)'), ('hops', 'hops')]
+
+print('%-12s' % '' + ''.join('%14s' % p for p in placements))
+for key, label in keys:
+    print('%-12s' % label + ''.join('%14.4f' % r[key] for r in results))
+
+baseline = results[0]
+for placement, result in zip(placements[1:], results[1:]):
+    print('%s vs %s: hit ratio %+.1f%%, server load %+.1f%%' % (placement, placements[0],
+          runstats.change(baseline['hitratio'], result['hitratio']),
+          runstats.change(baseline['served'], result['served'])))
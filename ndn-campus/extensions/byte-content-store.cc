@@ -0,0 +1,247 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * byte-content-store.cc
+ *
+ *  Exact name content stores bounded in bytes.
+ */
+
+#include "byte-content-store.h"
+
+#include <unordered_map>
+
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/simulator.h>
+#include <ns3-dev/ns3/uinteger.h>
+
+#include "ndn-capture.h"
+
+NS_LOG_COMPONENT_DEFINE ("ndn.cs.ByteStore");
+
+namespace ns3 {
+namespace ndn {
+namespace cs {
+
+namespace {
+
+struct NameHash
+{
+	size_t operator() (const Name &name) const
+	{
+		return NdnCapture::Hash (name, name.size ());
+	}
+};
+
+struct Stored
+{
+	Ptr<Entry> entry;
+	uint32_t cost;
+	Time at;
+};
+
+} // anonymous namespace
+
+struct ByteStore::Index
+{
+	typedef std::unordered_map<Name, Stored, NameHash> Map;
+
+	Map entries;
+};
+
+NS_OBJECT_ENSURE_REGISTERED (ByteStore);
+
+TypeId
+ByteStore::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::ndn::cs::ByteStore")
+		.SetGroupName ("Ndn")
+		.SetParent<ContentStore> ()
+		.AddAttribute ("MaxBytes",
+				"Bytes of payload and names the store holds at most",
+				UintegerValue (10485760),
+				MakeUintegerAccessor (&ByteStore::m_maxBytes),
+				MakeUintegerChecker<uint64_t> ())
+		.AddAttribute ("MaxSize",
+				"Entries the store holds at most, 0 for no limit",
+				UintegerValue (0),
+				MakeUintegerAccessor (&ByteStore::m_maxSize),
+				MakeUintegerChecker<uint32_t> ())
+		;
+	return tid;
+}
+
+ByteStore::ByteStore ()
+	: m_index (new Index)
+	, m_maxBytes (10485760)
+	, m_maxSize (0)
+	, m_bytes (0)
+{
+}
+
+ByteStore::~ByteStore ()
+{
+	delete m_index;
+}
+
+void
+ByteStore::DoDispose (void)
+{
+	// Entries point back at the store
+	m_index->entries.clear ();
+	m_bytes = 0;
+	ContentStore::DoDispose ();
+}
+
+void
+ByteStore::DoAccess (const Name &name)
+{
+}
+
+bool
+ByteStore::DoAdmit (Ptr<const Data> data, uint32_t cost)
+{
+	return true;
+}
+
+Ptr<Data>
+ByteStore::Lookup (Ptr<const Interest> interest)
+{
+	DoAccess (interest->GetName ());
+
+	Index::Map::iterator i = m_index->entries.find (interest->GetName ());
+	if (i == m_index->entries.end ())
+	{
+		m_cacheMissesTrace (interest);
+		return 0;
+	}
+
+	Ptr<const Data> data = i->second.entry->GetData ();
+	if (!data->GetFreshness ().IsZero () && Simulator::Now () - i->second.at > data->GetFreshness ())
+	{
+		NS_LOG_DEBUG ("Stale " << data->GetName ());
+		Remove (PeekPointer (i->second.entry));
+		m_cacheMissesTrace (interest);
+		return 0;
+	}
+
+	DoHit (PeekPointer (i->second.entry));
+	m_cacheHitsTrace (interest, data);
+	return Create<Data> (*data);
+}
+
+bool
+ByteStore::Add (Ptr<const Data> data)
+{
+	uint32_t cost = GetCost (data);
+	if (cost > m_maxBytes || m_index->entries.find (data->GetName ()) != m_index->entries.end ()
+			|| !DoAdmit (data, cost))
+	{
+		return false;
+	}
+
+	while (!m_index->entries.empty ()
+			&& (m_bytes + cost > m_maxBytes || (m_maxSize != 0 && m_index->entries.size () >= m_maxSize)))
+	{
+		Remove (DoVictim ());
+	}
+
+	Stored &stored = m_index->entries[data->GetName ()];
+	stored.entry = Create<Entry> (this, data);
+	stored.cost = cost;
+	stored.at = Simulator::Now ();
+	m_bytes += cost;
+
+	DoInsert (PeekPointer (stored.entry), cost);
+	return true;
+}
+
+void
+ByteStore::Remove (Entry *entry)
+{
+	Index::Map::iterator i = m_index->entries.find (entry->GetName ());
+	NS_ASSERT (i != m_index->entries.end () && PeekPointer (i->second.entry) == entry);
+
+	DoRemove (entry);
+	m_bytes -= i->second.cost;
+	m_index->entries.erase (i);
+}
+
+void
+ByteStore::Print (std::ostream &os) const
+{
+	for (Index::Map::const_iterator i = m_index->entries.begin (); i != m_index->entries.end (); ++i)
+	{
+		os << i->first << "\t" << i->second.cost << std::endl;
+	}
+}
+
+uint32_t
+ByteStore::GetSize () const
+{
+	return m_index->entries.size ();
+}
+
+Ptr<Entry>
+ByteStore::Begin ()
+{
+	return m_index->entries.empty () ? 0 : m_index->entries.begin ()->second.entry;
+}
+
+Ptr<Entry>
+ByteStore::End ()
+{
+	return 0;
+}
+
+Ptr<Entry>
+ByteStore::Next (Ptr<Entry> entry)
+{
+	Index::Map::iterator i = m_index->entries.find (entry->GetName ());
+	if (i == m_index->entries.end () || ++i == m_index->entries.end ())
+	{
+		return 0;
+	}
+	return i->second.entry;
+}
+
+uint64_t
+ByteStore::GetBytes (void) const
+{
+	return m_bytes;
+}
+
+uint64_t
+ByteStore::GetMaxBytes (void) const
+{
+	return m_maxBytes;
+}
+
+uint32_t
+ByteStore::GetCost (Ptr<const Data> data)
+{
+	uint32_t cost = data->GetPayload ()->GetSize ();
+
+	const Name &name = data->GetName ();
+	for (Name::const_iterator i = name.begin (); i != name.end (); ++i)
+	{
+		cost += i->size ();
+	}
+
+	return cost;
+}
+
+} // namespace cs
+} // namespace ndn
+} // namespace ns3
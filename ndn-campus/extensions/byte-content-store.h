@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * byte-content-store.h
+ *
+ *  Base of the content stores bounded in bytes instead of entries. Each
+ *  Data costs its payload plus its name components, and the store evicts
+ *  until a new one fits in MaxBytes, so the cache memory of a node no
+ *  longer depends on the object sizes of the run. MaxSize still bounds the
+ *  entries when set.
+ *
+ *  Lookups match the exact name of the Data, as the scenarios ask for
+ *  /prefix/<seq>, through a hash table instead of the ndnSIM trie. Data
+ *  with a freshness is dropped on the first lookup after it went stale.
+ *
+ *  Subclasses only choose the victims, through the Do* hooks. Entries are
+ *  owned by the store: a policy may keep raw pointers to them between
+ *  DoInsert () and DoRemove ().
+ */
+
+#ifndef BYTE_CONTENT_STORE_H_
+#define BYTE_CONTENT_STORE_H_
+
+#include <ostream>
+#include <stdint.h>
+
+#include <ns3-dev/ns3/ndnSIM-module.h>
+
+namespace ns3 {
+namespace ndn {
+namespace cs {
+
+class ByteStore : public ContentStore
+{
+public:
+	static TypeId GetTypeId (void);
+
+	ByteStore ();
+	virtual ~ByteStore ();
+
+	virtual Ptr<Data> Lookup (Ptr<const Interest> interest);
+	virtual bool Add (Ptr<const Data> data);
+	virtual void Print (std::ostream &os) const;
+	virtual uint32_t GetSize () const;
+
+	virtual Ptr<Entry> Begin ();
+	virtual Ptr<Entry> End ();
+	virtual Ptr<Entry> Next (Ptr<Entry> entry);
+
+	// Bytes held, never above GetMaxBytes ()
+	uint64_t GetBytes (void) const;
+	uint64_t GetMaxBytes (void) const;
+
+	// Bytes data takes in the store
+	static uint32_t GetCost (Ptr<const Data> data);
+
+protected:
+	virtual void DoDispose (void);
+
+	// Every lookup, before the hooks below. Nothing by default
+	virtual void DoAccess (const Name &name);
+	// Data not stored yet is about to be, before any victim is asked for.
+	// False drops it. Admits everything by default
+	virtual bool DoAdmit (Ptr<const Data> data, uint32_t cost);
+	// A new entry was stored
+	virtual void DoInsert (Entry *entry, uint32_t cost) = 0;
+	// A lookup found entry
+	virtual void DoHit (Entry *entry) = 0;
+	// Entry to evict next, only asked while something is stored
+	virtual Entry *DoVictim (void) = 0;
+	// Entry leaves the store, evicted or stale
+	virtual void DoRemove (Entry *entry) = 0;
+
+	// Takes entry out of the store, calling DoRemove ()
+	void Remove (Entry *entry);
+
+private:
+	struct Index;
+
+	Index *m_index;
+	uint64_t m_maxBytes;
+	uint32_t m_maxSize;
+	uint64_t m_bytes;
+};
+
+} // namespace cs
+} // namespace ndn
+} // namespace ns3
+
+#endif /* BYTE_CONTENT_STORE_H_ */
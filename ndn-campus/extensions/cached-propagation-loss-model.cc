@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * cached-propagation-loss-model.cc
+ *
+ *  Loss between static nodes computed once.
+ */
+
+#include "cached-propagation-loss-model.h"
+
+#include <unordered_map>
+
+#include <ns3-dev/ns3/abort.h>
+#include <ns3-dev/ns3/constant-position-mobility-model.h>
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/pointer.h>
+
+NS_LOG_COMPONENT_DEFINE ("CachedPropagationLossModel");
+
+namespace ns3 {
+
+class CachedPropagationLossModel::Cache
+{
+public:
+	struct Node
+	{
+		uint32_t id;
+		// Bumped on every course change, invalidating the cached pairs
+		uint32_t generation;
+		bool fixed;
+	};
+
+	struct Loss
+	{
+		uint32_t generationA;
+		uint32_t generationB;
+		double db;
+	};
+
+	Cache () : hits (0), misses (0) {}
+
+	std::unordered_map<const MobilityModel *, Node> nodes;
+	std::unordered_map<uint64_t, Loss> losses;
+	uint64_t hits;
+	uint64_t misses;
+};
+
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+		.SetParent<PropagationLossModel> ()
+		.AddConstructor<CachedPropagationLossModel> ()
+		.AddAttribute ("Model",
+				"Deterministic loss model whose results are cached",
+				PointerValue (),
+				MakePointerAccessor (&CachedPropagationLossModel::m_model),
+				MakePointerChecker<PropagationLossModel> ())
+		;
+	return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+	: m_cache (new Cache)
+{
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel ()
+{
+	delete m_cache;
+}
+
+uint64_t
+CachedPropagationLossModel::GetMisses (void) const
+{
+	return m_cache->misses;
+}
+
+uint64_t
+CachedPropagationLossModel::GetHits (void) const
+{
+	return m_cache->hits;
+}
+
+void
+CachedPropagationLossModel::DoDispose (void)
+{
+	NS_LOG_INFO (m_cache->hits << " cached and " << m_cache->misses << " computed losses");
+
+	m_cache->nodes.clear ();
+	m_cache->losses.clear ();
+	m_model = 0;
+	PropagationLossModel::DoDispose ();
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+	NS_ABORT_MSG_UNLESS (m_model != 0, "CachedPropagationLossModel needs a Model");
+
+	Cache::Node *nodes[2] = { 0, 0 };
+	Ptr<MobilityModel> mobility[2] = { a, b };
+
+	for (int i = 0; i < 2; i++)
+	{
+		std::unordered_map<const MobilityModel *, Cache::Node>::iterator n = m_cache->nodes.find (PeekPointer (mobility[i]));
+		if (n == m_cache->nodes.end ())
+		{
+			Cache::Node node;
+			node.id = m_cache->nodes.size ();
+			node.generation = 0;
+			node.fixed = DynamicCast<ConstantPositionMobilityModel> (mobility[i]) != 0;
+
+			if (node.fixed)
+			{
+				mobility[i]->TraceConnectWithoutContext ("CourseChange",
+						MakeCallback (&CachedPropagationLossModel::CourseChanged,
+								const_cast<CachedPropagationLossModel *> (this)));
+			}
+
+			n = m_cache->nodes.insert (std::make_pair (PeekPointer (mobility[i]), node)).first;
+		}
+		nodes[i] = &n->second;
+	}
+
+	if (!nodes[0]->fixed || !nodes[1]->fixed)
+	{
+		m_cache->misses++;
+		return m_model->CalcRxPower (txPowerDbm, a, b);
+	}
+
+	uint64_t key = ((uint64_t)nodes[0]->id << 32) | nodes[1]->id;
+	std::unordered_map<uint64_t, Cache::Loss>::iterator l = m_cache->losses.find (key);
+
+	if (l != m_cache->losses.end () && l->second.generationA == nodes[0]->generation
+			&& l->second.generationB == nodes[1]->generation)
+	{
+		m_cache->hits++;
+		return txPowerDbm - l->second.db;
+	}
+
+	double rxPowerDbm = m_model->CalcRxPower (txPowerDbm, a, b);
+
+	Cache::Loss loss;
+	loss.generationA = nodes[0]->generation;
+	loss.generationB = nodes[1]->generation;
+	loss.db = txPowerDbm - rxPowerDbm;
+	m_cache->losses[key] = loss;
+	m_cache->misses++;
+
+	return rxPowerDbm;
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+	return (m_model != 0) ? m_model->AssignStreams (stream) : 0;
+}
+
+void
+CachedPropagationLossModel::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+	std::unordered_map<const MobilityModel *, Cache::Node>::iterator n = m_cache->nodes.find (PeekPointer (mobility));
+	if (n != m_cache->nodes.end ())
+	{
+		n->second.generation++;
+	}
+}
+
+} // namespace ns3
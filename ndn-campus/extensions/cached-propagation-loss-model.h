@@ -0,0 +1,71 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * cached-propagation-loss-model.h
+ *
+ *  Remembers the loss Model gives between two ConstantPositionMobilityModel
+ *  nodes, so APs, routers and other static nodes compute it once instead of
+ *  on every frame. Pairs with a moving node are always passed to Model.
+ *  A cached loss is dropped when one of its nodes fires CourseChange, e.g.
+ *  on SetPosition ().
+ *
+ *  Model must be deterministic and have no next model of its own. Chain the
+ *  random layers, such as Nakagami fading, after this one as usual:
+ *
+ *    channel.AddPropagationLoss ("ns3::CachedPropagationLossModel",
+ *        "Model", PointerValue (CreateObject<ThreeLogDistancePropagationLossModel> ()));
+ *    channel.AddPropagationLoss ("ns3::NakagamiPropagationLossModel");
+ */
+
+#ifndef CACHED_PROPAGATION_LOSS_MODEL_H_
+#define CACHED_PROPAGATION_LOSS_MODEL_H_
+
+#include <stdint.h>
+
+#include <ns3-dev/ns3/mobility-model.h>
+#include <ns3-dev/ns3/propagation-loss-model.h>
+
+namespace ns3 {
+
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+	static TypeId GetTypeId (void);
+
+	CachedPropagationLossModel ();
+	virtual ~CachedPropagationLossModel ();
+
+	// Losses computed by Model and served from the cache
+	uint64_t GetMisses (void) const;
+	uint64_t GetHits (void) const;
+
+protected:
+	virtual void DoDispose (void);
+
+private:
+	class Cache;
+
+	virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+	virtual int64_t DoAssignStreams (int64_t stream);
+
+	void CourseChanged (Ptr<const MobilityModel> mobility);
+
+	Ptr<PropagationLossModel> m_model;
+	Cache *m_cache;
+};
+
+} // namespace ns3
+
+#endif /* CACHED_PROPAGATION_LOSS_MODEL_H_ */
@@ -0,0 +1,752 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * (c) 2009, GTech Systems, Inc. - Alfred Park <park@gtech-systems.com>
+ *
+ * campus-builder.cc
+ *
+ *  DARPA NMS campus network topology, taken out of the scenarios.
+ */
+
+#include "campus-builder.h"
+#include "placement-content-store.h"
+#include "shm-interface.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <ns3-dev/ns3/global-value.h>
+#include <ns3-dev/ns3/internet-module.h>
+#include <ns3-dev/ns3/ipv4-list-routing-helper.h>
+#include <ns3-dev/ns3/ipv4-nix-vector-helper.h>
+#include <ns3-dev/ns3/ipv4-static-routing-helper.h>
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/mpi-interface.h>
+#include <ns3-dev/ns3/ndnSIM-module.h>
+#include <ns3-dev/ns3/node-list.h>
+#include <ns3-dev/ns3/point-to-point-module.h>
+#include <ns3-dev/ns3/string.h>
+
+NS_LOG_COMPONENT_DEFINE ("CampusBuilder");
+
+namespace ns3 {
+
+// Helpers shared by all campuses
+struct CampusBuilder::Links
+{
+	Links (bool nix)
+	{
+		p2p_1gb5ms.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+		p2p_1gb5ms.SetChannelAttribute ("Delay", StringValue ("5ms"));
+		p2p_2gb200ms.SetDeviceAttribute ("DataRate", StringValue ("2Gbps"));
+		p2p_2gb200ms.SetChannelAttribute ("Delay", StringValue ("200ms"));
+		p2p_100mb1ms.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+		p2p_100mb1ms.SetChannelAttribute ("Delay", StringValue ("1ms"));
+
+		list.Add (staticRouting, 0);
+		list.Add (nixRouting, 10);
+
+		if (nix)
+		{
+			stack.SetRoutingHelper (list); // has effect on the next Install ()
+		}
+	}
+
+	// Points the address helper at a /24, or whatever mask is given
+	void SetBase (const std::ostringstream &oss, const char *mask = "255.255.255.0")
+	{
+		address.SetBase (oss.str ().c_str (), mask);
+	}
+
+	PointToPointHelper p2p_2gb200ms, p2p_1gb5ms, p2p_100mb1ms;
+	Ipv4NixVectorHelper nixRouting;
+	Ipv4StaticRoutingHelper staticRouting;
+	Ipv4ListRoutingHelper list;
+	InternetStackHelper stack;
+	Ipv4AddressHelper address;
+};
+
+namespace {
+
+NodeContainer
+Pair (Ptr<Node> a, Ptr<Node> b)
+{
+	NodeContainer pair;
+	pair.Add (a);
+	pair.Add (b);
+	return pair;
+}
+
+void
+Override (std::string &value, const std::string &layer)
+{
+	if (!layer.empty ())
+	{
+		value = layer;
+	}
+}
+
+} // anonymous namespace
+
+CampusBuilder::CampusBuilder (uint32_t campuses, uint32_t lanSize)
+: m_nCampuses (campuses)
+, m_lanSize (lanSize)
+, m_nix (true)
+, m_campuses (campuses)
+{
+}
+
+void
+CampusBuilder::SetNix (bool nix)
+{
+	m_nix = nix;
+}
+
+void
+CampusBuilder::Build (void)
+{
+	Links links (m_nix);
+
+	if (IsDistributed ())
+	{
+		std::cout << "Partitioning " << m_nCampuses << " campuses over "
+				<< GetSystemCount () << (ShmInterface::IsEnabled () ? " processes" : " ranks") << std::endl;
+	}
+
+	for (uint32_t z = 0; z < m_nCampuses; ++z)
+	{
+		BuildCampus (z, links);
+	}
+
+	if (m_nCampuses > 1)
+	{
+		BuildRing (links);
+	}
+}
+
+void
+CampusBuilder::BuildCampus (uint32_t z, Links &l)
+{
+	Campus &c = m_campuses[z];
+	uint32_t systemId = GetSystemId (z);
+	std::ostringstream oss;
+
+	std::cout << "Creating Campus Network " << z << ":" << std::endl;
+	// Create Net0
+	std::cout << "  SubNet [ 0";
+	c.net0.Create (3, systemId);
+	l.stack.Install (c.net0);
+
+	NetDeviceContainer ndc0[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		ndc0[i] = l.p2p_1gb5ms.Install (c.net0.Get (i), c.net0.Get ((i + 1) % 3));
+	}
+
+	// Create Net1
+	std::cout << " 1";
+	c.net1.Create (6, systemId);
+	l.stack.Install (c.net1);
+
+	// Links of net1 node i to its parent, node 1 has none of its own
+	const int net1Parent[6] = { 1, -1, 0, 0, 1, 1 };
+	NetDeviceContainer ndc1[6];
+	for (int i = 0; i < 6; ++i)
+	{
+		if (net1Parent[i] < 0)
+		{
+			continue;
+		}
+
+		ndc1[i] = l.p2p_1gb5ms.Install (c.net1.Get (i), c.net1.Get (net1Parent[i]));
+	}
+
+	// Connect Net0 <-> Net1
+	NetDeviceContainer ndc0_1 = l.p2p_1gb5ms.Install (Pair (c.net0.Get (2), c.net1.Get (0)));
+	oss.str ("");
+	oss << 10 + z << ".1.252.0";
+	l.SetBase (oss);
+	l.address.Assign (ndc0_1);
+
+	// Create Net2
+	std::cout << " 2";
+	c.net2.Create (14, systemId);
+	l.stack.Install (c.net2);
+
+	const int net2Parent[14] = { 1, 3, 0, 2, 2, 3, 5, 2, 3, 4, 5, 6, 6, 6 };
+	NetDeviceContainer ndc2[14];
+	for (int i = 0; i < 14; ++i)
+	{
+		ndc2[i] = l.p2p_1gb5ms.Install (c.net2.Get (i), c.net2.Get (net2Parent[i]));
+	}
+
+	c.net2Lan.resize (7);
+	for (int i = 0; i < 7; ++i)
+	{
+		oss.str ("");
+		oss << 10 + z << ".4." << 15 + i << ".0";
+		l.SetBase (oss);
+		for (uint32_t j = 0; j < m_lanSize; ++j)
+		{
+			Ptr<Node> host = CreateObject<Node> (systemId);
+			l.stack.Install (host);
+			c.net2Lan[i].Add (host);
+			l.address.Assign (l.p2p_100mb1ms.Install (host, c.net2.Get (i + 7)));
+		}
+	}
+
+	// Create Net3
+	std::cout << " 3 ]" << std::endl;
+	c.net3.Create (9, systemId);
+	l.stack.Install (c.net3);
+
+	const int net3Parent[9] = { 1, 2, 3, 1, 0, 0, 2, 3, 3 };
+	NetDeviceContainer ndc3[9];
+	for (int i = 0; i < 9; ++i)
+	{
+		ndc3[i] = l.p2p_1gb5ms.Install (c.net3.Get (i), c.net3.Get (net3Parent[i]));
+	}
+
+	c.net3Lan.resize (5);
+	for (int i = 0; i < 5; ++i)
+	{
+		oss.str ("");
+		oss << 10 + z << ".5." << 10 + i << ".0";
+		l.SetBase (oss, "255.255.255.255");
+		for (uint32_t j = 0; j < m_lanSize; ++j)
+		{
+			Ptr<Node> host = CreateObject<Node> (systemId);
+			l.stack.Install (host);
+			c.net3Lan[i].Add (host);
+			l.address.Assign (l.p2p_100mb1ms.Install (host, c.net3.Get (i + 4)));
+		}
+	}
+
+	std::cout << "  Connecting Subnets..." << std::endl;
+	// Create Lone Routers (Node 4 & 5)
+	c.loneRouters.Create (2, systemId);
+	l.stack.Install (c.loneRouters);
+	NetDeviceContainer ndcLR = l.p2p_1gb5ms.Install (c.loneRouters);
+
+	// Connect Net2/Net3 through Lone Routers to Net0
+	struct { uint32_t router; Ptr<Node> peer; const char *net; } uplinks[6] = {
+		{ 0, c.net0.Get (0), ".1.253.0" },
+		{ 1, c.net0.Get (1), ".1.254.0" },
+		{ 0, c.net2.Get (0), ".4.253.0" },
+		{ 1, c.net2.Get (1), ".4.254.0" },
+		{ 1, c.net3.Get (0), ".5.253.0" },
+		{ 1, c.net3.Get (1), ".5.254.0" }
+	};
+
+	for (int i = 0; i < 6; ++i)
+	{
+		NetDeviceContainer ndc = l.p2p_1gb5ms.Install (Pair (c.loneRouters.Get (uplinks[i].router), uplinks[i].peer));
+		oss.str ("");
+		oss << 10 + z << uplinks[i].net;
+		l.SetBase (oss);
+		l.address.Assign (ndc);
+	}
+
+	// Assign IP addresses
+	std::cout << "  Assigning IP addresses..." << std::endl;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		oss.str ("");
+		oss << 10 + z << ".1." << 1 + i << ".0";
+		l.SetBase (oss);
+		l.address.Assign (ndc0[i]);
+	}
+
+	for (int i = 0; i < 6; ++i)
+	{
+		if (net1Parent[i] < 0)
+		{
+			continue;
+		}
+		oss.str ("");
+		oss << 10 + z << ".2." << 1 + i << ".0";
+		l.SetBase (oss);
+		l.address.Assign (ndc1[i]);
+	}
+
+	oss.str ("");
+	oss << 10 + z << ".3.1.0";
+	l.SetBase (oss);
+	l.address.Assign (ndcLR);
+
+	for (int i = 0; i < 14; ++i)
+	{
+		oss.str ("");
+		oss << 10 + z << ".4." << 1 + i << ".0";
+		l.SetBase (oss);
+		l.address.Assign (ndc2[i]);
+	}
+
+	for (int i = 0; i < 9; ++i)
+	{
+		oss.str ("");
+		oss << 10 + z << ".5." << 1 + i << ".0";
+		l.SetBase (oss);
+		l.address.Assign (ndc3[i]);
+	}
+}
+
+void
+CampusBuilder::BuildRing (Links &l)
+{
+	std::ostringstream oss;
+
+	// Between MPI ranks these become remote channels, between processes
+	// they have to be shared memory ones
+	std::cout << "Forming Ring Topology..." << std::endl;
+	for (uint32_t z = 0; z < m_nCampuses; ++z)
+	{
+		uint32_t next = (z + 1) % m_nCampuses;
+		NetDeviceContainer ndc;
+		if (ShmInterface::IsEnabled () && GetSystemId (z) != GetSystemId (next))
+		{
+			ndc = ShmPointToPointChannel::Install (GetNet0 (z, 0), GetNet0 (next, 0),
+					DataRate ("2Gbps"), MilliSeconds (200));
+		}
+		else
+		{
+			ndc = l.p2p_2gb200ms.Install (Pair (GetNet0 (z, 0), GetNet0 (next, 0)));
+		}
+		oss.str ("");
+		oss << "254.1." << z + 1 << ".0";
+		l.SetBase (oss);
+		l.address.Assign (ndc);
+	}
+}
+
+uint32_t
+CampusBuilder::GetNCampuses (void) const
+{
+	return m_nCampuses;
+}
+
+uint32_t
+CampusBuilder::GetLanSize (void) const
+{
+	return m_lanSize;
+}
+
+Ptr<Node>
+CampusBuilder::GetNet0 (uint32_t campus, uint32_t i) const
+{
+	return m_campuses[campus].net0.Get (i);
+}
+
+Ptr<Node>
+CampusBuilder::GetNet1 (uint32_t campus, uint32_t i) const
+{
+	return m_campuses[campus].net1.Get (i);
+}
+
+Ptr<Node>
+CampusBuilder::GetLoneRouter (uint32_t campus, uint32_t i) const
+{
+	return m_campuses[campus].loneRouters.Get (i);
+}
+
+Ptr<Node>
+CampusBuilder::GetNet2 (uint32_t campus, uint32_t i) const
+{
+	return m_campuses[campus].net2.Get (i);
+}
+
+Ptr<Node>
+CampusBuilder::GetNet3 (uint32_t campus, uint32_t i) const
+{
+	return m_campuses[campus].net3.Get (i);
+}
+
+Ptr<Node>
+CampusBuilder::GetNet2Lan (uint32_t campus, uint32_t lan, uint32_t host) const
+{
+	return m_campuses[campus].net2Lan[lan].Get (host);
+}
+
+Ptr<Node>
+CampusBuilder::GetNet3Lan (uint32_t campus, uint32_t lan, uint32_t host) const
+{
+	return m_campuses[campus].net3Lan[lan].Get (host);
+}
+
+NodeContainer
+CampusBuilder::GetCampus (uint32_t campus) const
+{
+	const Campus &c = m_campuses[campus];
+	NodeContainer nodes (c.net0, c.net1, c.loneRouters, c.net2, c.net3);
+
+	for (size_t i = 0; i < c.net2Lan.size (); i++)
+	{
+		nodes.Add (c.net2Lan[i]);
+	}
+	for (size_t i = 0; i < c.net3Lan.size (); i++)
+	{
+		nodes.Add (c.net3Lan[i]);
+	}
+
+	return nodes;
+}
+
+NodeContainer
+CampusBuilder::GetTier (const std::string &tier) const
+{
+	NodeContainer nodes;
+
+	for (uint32_t z = 0; z < m_nCampuses; ++z)
+	{
+		const Campus &c = m_campuses[z];
+
+		if (tier == "gateway")
+		{
+			nodes.Add (c.net0.Get (0));
+		}
+		else if (tier == "core")
+		{
+			nodes.Add (c.net0.Get (1));
+			nodes.Add (c.net0.Get (2));
+		}
+		else if (tier == "lone-router")
+		{
+			nodes.Add (c.loneRouters);
+		}
+		else if (tier == "net1")
+		{
+			nodes.Add (c.net1);
+		}
+		else if (tier == "router" || tier == "lan-router")
+		{
+			// Routers with LANs hang off the last net2 and net3 nodes
+			bool lan = (tier == "lan-router");
+			for (uint32_t i = 0; i < c.net2.GetN (); i++)
+			{
+				if ((i >= 7) == lan)
+					nodes.Add (c.net2.Get (i));
+			}
+			for (uint32_t i = 0; i < c.net3.GetN (); i++)
+			{
+				if ((i >= 4) == lan)
+					nodes.Add (c.net3.Get (i));
+			}
+		}
+		else if (tier == "host")
+		{
+			for (size_t i = 0; i < c.net2Lan.size (); i++)
+				nodes.Add (c.net2Lan[i]);
+			for (size_t i = 0; i < c.net3Lan.size (); i++)
+				nodes.Add (c.net3Lan[i]);
+		}
+		else
+		{
+			NS_LOG_WARN ("Unknown tier " << tier);
+			break;
+		}
+	}
+
+	return nodes;
+}
+
+std::vector<std::string>
+CampusBuilder::GetTierNames (void)
+{
+	static const char *names[] = { "gateway", "core", "lone-router", "net1", "router", "lan-router", "host" };
+	return std::vector<std::string> (names, names + sizeof (names) / sizeof (names[0]));
+}
+
+void
+CampusBuilder::SetStackProfile (const std::string &tier, const StackProfile &profile)
+{
+	m_profiles[tier] = profile;
+}
+
+CampusBuilder::StackProfile
+CampusBuilder::GetStackProfile (const std::string &tier) const
+{
+	// Same defaults as ndn::StackHelper
+	StackProfile profile;
+	profile.contentStore = "ns3::ndn::cs::Lru";
+	profile.strategy = "ns3::ndn::fw::Flooding";
+	profile.pit = "ns3::ndn::pit::Persistent";
+
+	const char *layers[] = { "*", tier.c_str () };
+	for (int i = 0; i < 2; i++)
+	{
+		std::map<std::string, StackProfile>::const_iterator p = m_profiles.find (layers[i]);
+		if (p == m_profiles.end ())
+		{
+			continue;
+		}
+
+		const StackProfile &layer = p->second;
+		Override (profile.contentStore, layer.contentStore);
+		Override (profile.contentStoreSize, layer.contentStoreSize);
+		Override (profile.contentStoreBytes, layer.contentStoreBytes);
+		Override (profile.placement, layer.placement);
+		Override (profile.strategy, layer.strategy);
+		Override (profile.pit, layer.pit);
+		Override (profile.pitSize, layer.pitSize);
+	}
+
+	return profile;
+}
+
+bool
+CampusBuilder::LoadStackProfiles (const std::string &filename)
+{
+	std::ifstream file (filename.c_str ());
+	if (!file.is_open ())
+	{
+		std::cerr << "Could not open stack profiles " << filename << std::endl;
+		return false;
+	}
+
+	std::vector<std::string> tiers = GetTierNames ();
+	tiers.push_back ("*");
+
+	std::string line;
+	for (uint32_t number = 1; std::getline (file, line); number++)
+	{
+		std::istringstream in (line);
+		std::string tier, setting, value;
+		if (!(in >> tier) || tier[0] == '#')
+		{
+			continue;
+		}
+
+		in >> setting >> value;
+
+		StackProfile scratch;
+		bool known = std::find (tiers.begin (), tiers.end (), tier) != tiers.end ();
+		StackProfile &profile = known ? m_profiles[tier] : scratch;
+
+		std::string *field = 0;
+		if (setting == "cs")
+			field = &profile.contentStore;
+		else if (setting == "cs-size")
+			field = &profile.contentStoreSize;
+		else if (setting == "cs-bytes")
+			field = &profile.contentStoreBytes;
+		else if (setting == "placement")
+			field = &profile.placement;
+		else if (setting == "strategy")
+			field = &profile.strategy;
+		else if (setting == "pit")
+			field = &profile.pit;
+		else if (setting == "pit-size")
+			field = &profile.pitSize;
+
+		if (!known || field == 0 || value.empty ())
+		{
+			std::cerr << filename << ":" << number << ": expected \"<tier> <setting> <value>\", tier being *"
+					<< " or one of GetTierNames () and setting cs, cs-size, cs-bytes, placement, strategy, pit or pit-size" << std::endl;
+			return false;
+		}
+
+		*field = value;
+	}
+
+	return true;
+}
+
+void
+CampusBuilder::InstallStack (bool defaultRoutes) const
+{
+	bool betweenness = false;
+
+	std::vector<std::string> tiers = GetTierNames ();
+	for (size_t i = 0; i < tiers.size (); i++)
+	{
+		StackProfile profile = GetStackProfile (tiers[i]);
+
+		// HostUplink sends up without the FIB, which must only hold the
+		// prefixes of the producer applications
+		ndn::StackHelper helper;
+		helper.SetDefaultRoutes (defaultRoutes && profile.strategy != "ns3::ndn::fw::HostUplink");
+		if (profile.placement.empty ())
+		{
+			helper.SetContentStore (profile.contentStore,
+					profile.contentStoreSize.empty () ? "" : "MaxSize", profile.contentStoreSize,
+					profile.contentStoreBytes.empty () ? "" : "MaxBytes", profile.contentStoreBytes);
+		}
+		else
+		{
+			// The same store, as "Type[Name=Value|...]" for the Placement
+			std::vector<std::string> attributes;
+			if (!profile.contentStoreSize.empty ())
+				attributes.push_back ("MaxSize=" + profile.contentStoreSize);
+			if (!profile.contentStoreBytes.empty ())
+				attributes.push_back ("MaxBytes=" + profile.contentStoreBytes);
+
+			std::string store = profile.contentStore;
+			for (size_t a = 0; a < attributes.size (); a++)
+			{
+				store += (a ? "|" : "[") + attributes[a];
+			}
+			store += attributes.empty () ? "" : "]";
+
+			helper.SetContentStore ("ns3::ndn::cs::Placement", "Store", store, "Decision", profile.placement);
+			betweenness = betweenness || profile.placement == "Betweenness";
+		}
+		helper.SetForwardingStrategy (profile.strategy);
+		helper.SetPit (profile.pit, profile.pitSize.empty () ? "" : "MaxSize", profile.pitSize);
+
+		NodeContainer nodes = GetTier (tiers[i]);
+		helper.Install (nodes);
+
+		NS_LOG_INFO (tiers[i] << ": " << nodes.GetN () << " nodes, " << profile.contentStore
+				<< (profile.contentStoreSize.empty () ? "" : " MaxSize=") << profile.contentStoreSize
+				<< (profile.contentStoreBytes.empty () ? "" : " MaxBytes=") << profile.contentStoreBytes
+				<< (profile.placement.empty () ? "" : " placed ") << profile.placement
+				<< ", " << profile.strategy << ", " << profile.pit
+				<< (profile.pitSize.empty () ? "" : " MaxSize=") << profile.pitSize);
+	}
+
+	// Over the whole topology, every rank holds all the nodes, so the ranks
+	// agree on the centralities and the gateways compare across campuses
+	if (betweenness)
+	{
+		ndn::cs::Placement::ComputeCentralities (NodeContainer::GetGlobal ());
+	}
+}
+
+uint32_t
+CampusBuilder::GetSystemId (uint32_t campus) const
+{
+	if (!IsDistributed ())
+	{
+		return 0;
+	}
+
+	// Contiguous blocks of campuses per rank, so only the ring crosses ranks
+	return (uint64_t)campus * GetSystemCount () / m_nCampuses;
+}
+
+NodeContainer
+CampusBuilder::GetLocalNodes (void) const
+{
+	NodeContainer nodes;
+
+	for (uint32_t z = 0; z < m_nCampuses; ++z)
+	{
+		if (GetSystemId (z) == GetLocalSystemId ())
+		{
+			nodes.Add (GetCampus (z));
+		}
+	}
+
+	return nodes;
+}
+
+bool
+CampusBuilder::EnableMpi (int *argc, char ***argv)
+{
+	StringValue impl;
+	GlobalValue::GetValueByName ("SimulatorImplementationType", impl);
+
+	if (impl.Get () != "ns3::DistributedSimulatorImpl")
+	{
+		return false;
+	}
+
+	MpiInterface::Enable (argc, argv);
+	return true;
+}
+
+void
+CampusBuilder::DisableMpi (void)
+{
+	if (IsDistributed ())
+	{
+		MpiInterface::Disable ();
+	}
+}
+
+bool
+CampusBuilder::EnableShm (uint32_t processes)
+{
+	if (processes < 2)
+	{
+		return false;
+	}
+
+	if (MpiInterface::IsEnabled ())
+	{
+		NS_LOG_WARN ("Already running over MPI, not forking " << processes << " processes");
+		return false;
+	}
+
+	ShmInterface::Enable (processes);
+	return true;
+}
+
+bool
+CampusBuilder::DisableShm (void)
+{
+	return ShmInterface::Disable ();
+}
+
+bool
+CampusBuilder::IsDistributed (void)
+{
+	return GetSystemCount () > 1;
+}
+
+uint32_t
+CampusBuilder::GetLocalSystemId (void)
+{
+	return MpiInterface::IsEnabled () ? MpiInterface::GetSystemId () : ShmInterface::GetSystemId ();
+}
+
+uint32_t
+CampusBuilder::GetSystemCount (void)
+{
+	return MpiInterface::IsEnabled () ? MpiInterface::GetSize () : ShmInterface::GetSize ();
+}
+
+bool
+CampusBuilder::IsLocal (Ptr<Node> node)
+{
+	return !IsDistributed () || node->GetSystemId () == GetLocalSystemId ();
+}
+
+std::string
+CampusBuilder::RankLocal (const std::string &filename)
+{
+	if (!IsDistributed ())
+	{
+		return filename;
+	}
+
+	std::ostringstream rank;
+	rank << "-rank" << GetLocalSystemId ();
+
+	size_t dot = filename.rfind ('.');
+	size_t slash = filename.rfind ('/');
+
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+	{
+		return filename + rank.str ();
+	}
+
+	return filename.substr (0, dot) + rank.str () + filename.substr (dot);
+}
+
+} // namespace ns3
@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * campus-builder.h
+ *
+ *  Builds the DARPA NMS campus network topology used by the scenarios: a
+ *  number of campuses, each with subnets 0 to 3, two lone routers and LANs
+ *  of hosts, joined in a ring of 200 ms links between the net0 gateways.
+ *
+ *  When the simulator is ns3::DistributedSimulatorImpl every campus is
+ *  given to one MPI rank, contiguous campuses to the same rank, so the only
+ *  links between ranks are ring links and the lookahead is 200 ms.
+ *
+ *  EnableShm () does the same without MPI, forking one process per part of
+ *  the ring on the local machine (see shm-interface.h).
+ *
+ *  InstallStack () puts the NDN stack on every node with the stack profile
+ *  of its tier, e.g. small stores on the hosts and big ones on the core.
+ */
+
+#ifndef CAMPUS_BUILDER_H_
+#define CAMPUS_BUILDER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <ns3-dev/ns3/node.h>
+#include <ns3-dev/ns3/node-container.h>
+
+namespace ns3 {
+
+class CampusBuilder
+{
+public:
+	CampusBuilder (uint32_t campuses, uint32_t lanSize);
+
+	// Nix-vector routing for the IPv4 stack, on by default
+	void SetNix (bool nix);
+
+	// Creates nodes, links and addresses for every campus and the ring
+	void Build (void);
+
+	uint32_t GetNCampuses (void) const;
+	uint32_t GetLanSize (void) const;
+
+	// Same numbering as the original nodes_net* arrays
+	Ptr<Node> GetNet0 (uint32_t campus, uint32_t i) const;					// 0..2
+	Ptr<Node> GetNet1 (uint32_t campus, uint32_t i) const;					// 0..5
+	Ptr<Node> GetLoneRouter (uint32_t campus, uint32_t i) const;			// 0..1
+	Ptr<Node> GetNet2 (uint32_t campus, uint32_t i) const;					// 0..13
+	Ptr<Node> GetNet3 (uint32_t campus, uint32_t i) const;					// 0..8
+	Ptr<Node> GetNet2Lan (uint32_t campus, uint32_t lan, uint32_t host) const;	// lan 0..6
+	Ptr<Node> GetNet3Lan (uint32_t campus, uint32_t lan, uint32_t host) const;	// lan 0..4
+
+	// Every node of a campus
+	NodeContainer GetCampus (uint32_t campus) const;
+
+	// Nodes by role: gateway, core, lone-router, net1, router, lan-router, host
+	NodeContainer GetTier (const std::string &tier) const;
+	static std::vector<std::string> GetTierNames (void);
+
+	// NDN stack settings of a tier. Empty fields take the value of the "*"
+	// profile, then the StackHelper default
+	struct StackProfile
+	{
+		std::string contentStore;		// ContentStore type
+		std::string contentStoreSize;	// Its MaxSize, in entries
+		std::string contentStoreBytes;	// Its MaxBytes, for the ByteStores
+		std::string placement;			// cs::Placement decision in front of it
+		std::string strategy;			// Forwarding strategy type
+		std::string pit;				// Pit type
+		std::string pitSize;			// Its MaxSize, 0 for no limit
+	};
+
+	// Sets the profile of a tier, or of "*" for every tier
+	void SetStackProfile (const std::string &tier, const StackProfile &profile);
+	StackProfile GetStackProfile (const std::string &tier) const;
+
+	// Reads "<tier> <setting> <value>" lines, setting being cs, cs-size,
+	// cs-bytes, placement, strategy, pit or pit-size. Returns false on a
+	// malformed line
+	bool LoadStackProfiles (const std::string &filename);
+
+	// Installs the NDN stack on the nodes of every tier with its profile,
+	// then the centralities if a tier places by betweenness. Tiers
+	// forwarding with HostUplink never get default routes
+	void InstallStack (bool defaultRoutes) const;
+
+	// Rank or process a campus runs on
+	uint32_t GetSystemId (uint32_t campus) const;
+
+	// Nodes simulated by this process
+	NodeContainer GetLocalNodes (void) const;
+
+	// Starts MPI when the distributed simulator was selected. Call after
+	// parsing the command line and before creating any node
+	static bool EnableMpi (int *argc, char ***argv);
+	static void DisableMpi (void);
+
+	// Forks processes - 1 children to share the campuses, when processes is
+	// more than 1. Call before creating any node. DisableShm () waits for
+	// the children in the first process and returns false if one failed
+	static bool EnableShm (uint32_t processes);
+	static bool DisableShm (void);
+
+	static bool IsDistributed (void);
+	static uint32_t GetLocalSystemId (void);
+	static uint32_t GetSystemCount (void);
+	static bool IsLocal (Ptr<Node> node);
+
+	// Adds -rank<N> before the extension of filename on multi rank or multi
+	// process runs, so each writes its own traces. merge-ranks.py joins them
+	static std::string RankLocal (const std::string &filename);
+
+private:
+	struct Links;
+
+	struct Campus
+	{
+		NodeContainer net0;
+		NodeContainer net1;
+		NodeContainer loneRouters;
+		NodeContainer net2;
+		NodeContainer net3;
+		std::vector<NodeContainer> net2Lan;
+		std::vector<NodeContainer> net3Lan;
+	};
+
+	void BuildCampus (uint32_t z, Links &l);
+	void BuildRing (Links &l);
+
+	uint32_t m_nCampuses;
+	uint32_t m_lanSize;
+	bool m_nix;
+	std::vector<Campus> m_campuses;
+	std::map<std::string, StackProfile> m_profiles;
+};
+
+} // namespace ns3
+
+#endif /* CAMPUS_BUILDER_H_ */
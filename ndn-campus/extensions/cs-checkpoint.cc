@@ -0,0 +1,322 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * cs-checkpoint.cc
+ *
+ *  Content store checkpoints.
+ */
+
+#include "cs-checkpoint.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/node-list.h>
+#include <ns3-dev/ns3/simulator.h>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.CsCheckpoint");
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+const char kMagic[] = "ndn-cs-checkpoint";
+const int kVersion = 1;
+
+// Oldest use first
+bool
+OlderFirst (const std::pair<uint64_t, Ptr<const Data> > &a, const std::pair<uint64_t, Ptr<const Data> > &b)
+{
+	return a.first < b.first;
+}
+
+} // anonymous namespace
+
+// Stamps the Data of one node with a use counter
+class CsCheckpoint::Tracker : public SimpleRefCount<CsCheckpoint::Tracker>
+{
+public:
+	Tracker (Ptr<Node> node, Ptr<ContentStore> cs)
+	: m_node (node)
+	, m_cs (cs)
+	, m_clock (0)
+	{
+	}
+
+	void InData (Ptr<const Data> data, Ptr<const Face> face)
+	{
+		Touch (data->GetName ());
+	}
+
+	void CacheHits (Ptr<const Interest> interest, Ptr<const Data> data)
+	{
+		Touch (data->GetName ());
+	}
+
+	Ptr<Node> GetNode (void) const
+	{
+		return m_node;
+	}
+
+	Ptr<ContentStore> GetContentStore (void) const
+	{
+		return m_cs;
+	}
+
+	// Last use of name, 0 if never seen
+	uint64_t GetStamp (const Name &name) const
+	{
+		std::map<Name, uint64_t>::const_iterator i = m_stamps.find (name);
+		return (i != m_stamps.end ()) ? i->second : 0;
+	}
+
+	void Touch (const Name &name)
+	{
+		// Most stamped names are evicted sooner or later, forget them
+		// once there are twice as many stamps as entries. Before stamping,
+		// InData comes before the store adds the Data
+		size_t limit = std::max<size_t> (2 * m_cs->GetSize (), 1024);
+		if (m_stamps.size () >= limit)
+		{
+			std::map<Name, uint64_t> kept;
+			for (Ptr<cs::Entry> e = m_cs->Begin (); e != m_cs->End (); e = m_cs->Next (e))
+			{
+				kept[e->GetName ()] = GetStamp (e->GetName ());
+			}
+			m_stamps.swap (kept);
+		}
+
+		m_stamps[name] = ++m_clock;
+	}
+
+private:
+
+	Ptr<Node> m_node;
+	Ptr<ContentStore> m_cs;
+	uint64_t m_clock;
+	std::map<Name, uint64_t> m_stamps;
+};
+
+CsCheckpoint::CsCheckpoint ()
+{
+}
+
+CsCheckpoint::~CsCheckpoint ()
+{
+}
+
+void
+CsCheckpoint::Install (Ptr<Node> node)
+{
+	Ptr<ForwardingStrategy> fw = node->GetObject<ForwardingStrategy> ();
+	Ptr<ContentStore> cs = node->GetObject<ContentStore> ();
+	if (fw == 0 || cs == 0)
+	{
+		NS_LOG_WARN ("Node " << node->GetId () << " has no content store, not checkpointing it");
+		return;
+	}
+
+	Ptr<Tracker> tracker = Create<Tracker> (node, cs);
+	fw->TraceConnectWithoutContext ("InData", MakeCallback (&Tracker::InData, tracker));
+	cs->TraceConnectWithoutContext ("CacheHits", MakeCallback (&Tracker::CacheHits, tracker));
+
+	m_trackers.push_back (tracker);
+}
+
+void
+CsCheckpoint::Install (const NodeContainer &nodes)
+{
+	for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+	{
+		Install (*i);
+	}
+}
+
+void
+CsCheckpoint::InstallAll (void)
+{
+	for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+	{
+		Install (*i);
+	}
+}
+
+bool
+CsCheckpoint::Save (const std::string &filename) const
+{
+	std::list<Ptr<Tracker> > trackers = m_trackers;
+
+	// Without trackers every store is saved in its own iteration order
+	if (trackers.empty ())
+	{
+		for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+		{
+			Ptr<ContentStore> cs = (*i)->GetObject<ContentStore> ();
+			if (cs != 0)
+			{
+				trackers.push_back (Create<Tracker> (*i, cs));
+			}
+		}
+	}
+
+	std::ofstream out (filename.c_str (), std::ios::out | std::ios::trunc);
+	if (!out)
+	{
+		std::cerr << "CsCheckpoint: could not open " << filename << std::endl;
+		return false;
+	}
+
+	out << kMagic << " " << kVersion << " " << Simulator::Now ().GetSeconds ()
+			<< " " << trackers.size () << std::endl;
+
+	uint64_t total = 0;
+	for (std::list<Ptr<Tracker> >::const_iterator t = trackers.begin (); t != trackers.end (); ++t)
+	{
+		Ptr<ContentStore> cs = (*t)->GetContentStore ();
+
+		std::vector<std::pair<uint64_t, Ptr<const Data> > > entries;
+		for (Ptr<cs::Entry> e = cs->Begin (); e != cs->End (); e = cs->Next (e))
+		{
+			entries.push_back (std::make_pair ((*t)->GetStamp (e->GetName ()), e->GetData ()));
+		}
+		std::stable_sort (entries.begin (), entries.end (), OlderFirst);
+
+		out << "node " << (*t)->GetNode ()->GetId () << " " << entries.size () << std::endl;
+		for (size_t i = 0; i < entries.size (); ++i)
+		{
+			Ptr<const Data> data = entries[i].second;
+			out << data->GetName () << "\t" << data->GetPayload ()->GetSize ()
+					<< "\t" << data->GetFreshness ().GetNanoSeconds ()
+					<< "\t" << data->GetSignature () << std::endl;
+		}
+
+		total += entries.size ();
+	}
+
+	NS_LOG_INFO ("Saved " << total << " Data of " << trackers.size () << " nodes to " << filename);
+	return true;
+}
+
+void
+CsCheckpoint::SaveAt (Time at, const std::string &filename)
+{
+	Simulator::Schedule (at - Simulator::Now (), &CsCheckpoint::DoSave, this, filename);
+}
+
+void
+CsCheckpoint::DoSave (std::string filename)
+{
+	Save (filename);
+}
+
+bool
+CsCheckpoint::Load (const std::string &filename)
+{
+	// Loaded Data is stamped in file order, so a later save keeps it least
+	// recently used first
+	std::map<uint32_t, Ptr<Tracker> > trackers;
+	for (std::list<Ptr<Tracker> >::const_iterator t = m_trackers.begin (); t != m_trackers.end (); ++t)
+	{
+		trackers[(*t)->GetNode ()->GetId ()] = *t;
+	}
+
+	std::ifstream in (filename.c_str ());
+	if (!in)
+	{
+		std::cerr << "CsCheckpoint: could not open " << filename << std::endl;
+		return false;
+	}
+
+	std::string magic;
+	int version;
+	double savedAt;
+	uint32_t nodes;
+
+	in >> magic >> version >> savedAt >> nodes;
+	if (!in || magic != kMagic || version != kVersion)
+	{
+		std::cerr << "CsCheckpoint: " << filename << " is not a checkpoint" << std::endl;
+		return false;
+	}
+
+	uint64_t loaded = 0, skipped = 0;
+	std::string line;
+
+	for (uint32_t n = 0; n < nodes; ++n)
+	{
+		std::string tag;
+		uint32_t id;
+		uint64_t count;
+
+		in >> tag >> id >> count;
+		std::getline (in, line);
+		if (!in || tag != "node")
+		{
+			std::cerr << "CsCheckpoint: " << filename << " is truncated" << std::endl;
+			return false;
+		}
+
+		Ptr<ContentStore> cs = (id < NodeList::GetNNodes ()) ? NodeList::GetNode (id)->GetObject<ContentStore> () : 0;
+		std::map<uint32_t, Ptr<Tracker> >::const_iterator tracker = trackers.find (id);
+
+		for (uint64_t i = 0; i < count && std::getline (in, line); ++i)
+		{
+			if (cs == 0)
+			{
+				skipped++;
+				continue;
+			}
+
+			std::istringstream fields (line);
+			std::string uri;
+			uint32_t payload, signature;
+			int64_t freshness;
+
+			std::getline (fields, uri, '\t');
+			fields >> payload >> freshness >> signature;
+
+			Ptr<Data> data = Create<Data> (Create<Packet> (payload));
+			data->SetName (Create<Name> (uri));
+			data->SetFreshness (NanoSeconds (freshness));
+			data->SetSignature (signature);
+
+			cs->Add (data);
+			if (tracker != trackers.end ())
+			{
+				tracker->second->Touch (data->GetName ());
+			}
+			loaded++;
+		}
+	}
+
+	std::cout << "Loaded " << loaded << " cached Data saved at " << savedAt << "s from " << filename;
+	if (skipped > 0)
+	{
+		std::cout << ", skipped " << skipped << " of nodes without a content store";
+	}
+	std::cout << std::endl;
+
+	return true;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,79 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * cs-checkpoint.h
+ *
+ *  Saves the contents of every node's content store to a file at a given
+ *  time, so later runs can preload them before Simulator::Run () and start
+ *  with warm caches.
+ *
+ *  ndnSIM does not expose the replacement order of its stores, so it is
+ *  rebuilt from what the policies look at: each Data is stamped when it
+ *  reaches the node and when it is served from the cache. Entries are saved
+ *  least recently used first and loaded in that order, which restores the
+ *  order of Lru stores exactly. Only the name, payload size, freshness and
+ *  signature of each Data are kept, payloads are zeros as the producers'.
+ */
+
+#ifndef CS_CHECKPOINT_H_
+#define CS_CHECKPOINT_H_
+
+#include <list>
+#include <string>
+
+#include <ns3-dev/ns3/node.h>
+#include <ns3-dev/ns3/node-container.h>
+#include <ns3-dev/ns3/nstime.h>
+#include <ns3-dev/ns3/ndnSIM-module.h>
+
+namespace ns3 {
+namespace ndn {
+
+class CsCheckpoint
+{
+public:
+	CsCheckpoint ();
+	~CsCheckpoint ();
+
+	// Follows the use of cached Data, needed to save the replacement order.
+	// Nodes need the NDN stack
+	void Install (Ptr<Node> node);
+	void Install (const NodeContainer &nodes);
+	void InstallAll (void);
+
+	// Writes the content stores of the installed nodes, or of every node if
+	// none was installed
+	bool Save (const std::string &filename) const;
+
+	// Saves at simulated time at
+	void SaveAt (Time at, const std::string &filename);
+
+	// Adds the saved Data to the content stores of the same nodes, in the
+	// order saved. Call after installing to keep that order in a later
+	// save. Returns false if the file could not be read
+	bool Load (const std::string &filename);
+
+private:
+	class Tracker;
+
+	void DoSave (std::string filename);
+
+	std::list<Ptr<Tracker> > m_trackers;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif /* CS_CHECKPOINT_H_ */
@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * gdsf-content-store.cc
+ *
+ *  GDSF priorities kept in an ordered multimap.
+ */
+
+#include "gdsf-content-store.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+#include <ns3-dev/ns3/enum.h>
+#include <ns3-dev/ns3/log.h>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.cs.Gdsf");
+
+namespace ns3 {
+namespace ndn {
+namespace cs {
+
+struct Gdsf::Queue
+{
+	typedef std::multimap<double, Entry *> Order;
+
+	struct State
+	{
+		uint32_t hits;
+		uint32_t size;
+		Order::iterator position;
+	};
+
+	Order order;
+	std::unordered_map<Entry *, State> states;
+};
+
+NS_OBJECT_ENSURE_REGISTERED (Gdsf);
+
+TypeId
+Gdsf::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::ndn::cs::Gdsf")
+		.SetGroupName ("Ndn")
+		.SetParent<ByteStore> ()
+		.AddConstructor<Gdsf> ()
+		.AddAttribute ("Cost",
+				"Worth of keeping an object: Hits (object hit ratio) or Bytes (byte hit ratio)",
+				EnumValue (Gdsf::HITS),
+				MakeEnumAccessor (&Gdsf::m_cost),
+				MakeEnumChecker (Gdsf::HITS, "Hits",
+						Gdsf::BYTES, "Bytes"))
+		;
+	return tid;
+}
+
+Gdsf::Gdsf ()
+	: m_queue (new Queue)
+	, m_cost (HITS)
+	, m_age (0.0)
+{
+}
+
+Gdsf::~Gdsf ()
+{
+	delete m_queue;
+}
+
+void
+Gdsf::Enqueue (Entry *entry)
+{
+	Queue::State &state = m_queue->states[entry];
+
+	// With the cost in bytes, cost / size is 1
+	double priority = (m_cost == BYTES) ? m_age + state.hits
+			: m_age + (double)state.hits / std::max<uint32_t> (state.size, 1);
+
+	// After the equal ones, so ties go least recently used first
+	state.position = m_queue->order.insert (m_queue->order.upper_bound (priority),
+			std::make_pair (priority, entry));
+}
+
+void
+Gdsf::DoInsert (Entry *entry, uint32_t cost)
+{
+	Queue::State &state = m_queue->states[entry];
+	state.hits = 1;
+	state.size = cost;
+	Enqueue (entry);
+}
+
+void
+Gdsf::DoHit (Entry *entry)
+{
+	Queue::State &state = m_queue->states[entry];
+	m_queue->order.erase (state.position);
+	state.hits++;
+	Enqueue (entry);
+}
+
+Entry *
+Gdsf::DoVictim (void)
+{
+	NS_ASSERT (!m_queue->order.empty ());
+
+	Queue::Order::iterator victim = m_queue->order.begin ();
+	m_age = victim->first;
+
+	NS_LOG_DEBUG ("Evicting " << victim->second->GetName () << ", L = " << m_age);
+	return victim->second;
+}
+
+void
+Gdsf::DoRemove (Entry *entry)
+{
+	std::unordered_map<Entry *, Queue::State>::iterator i = m_queue->states.find (entry);
+	NS_ASSERT (i != m_queue->states.end ());
+
+	m_queue->order.erase (i->second.position);
+	m_queue->states.erase (i);
+}
+
+} // namespace cs
+} // namespace ndn
+} // namespace ns3
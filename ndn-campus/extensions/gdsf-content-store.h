@@ -0,0 +1,76 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * gdsf-content-store.h
+ *
+ *  Greedy Dual Size Frequency replacement over a ByteStore. Each entry has
+ *  the priority
+ *
+ *    L + hits * cost / size
+ *
+ *  and the lowest one is evicted, L becoming its priority so that entries
+ *  not hit for long age out. With Cost=Hits every object is worth the same
+ *  and small popular ones are kept, which favours the object hit ratio;
+ *  with Cost=Bytes the size cancels out and it is LFU with dynamic aging,
+ *  which favours the byte hit ratio. Equal priorities go least recently
+ *  used first.
+ *
+ *    ndnHelper.SetContentStore ("ns3::ndn::cs::Gdsf", "MaxBytes", "3145728");
+ */
+
+#ifndef GDSF_CONTENT_STORE_H_
+#define GDSF_CONTENT_STORE_H_
+
+#include "byte-content-store.h"
+
+namespace ns3 {
+namespace ndn {
+namespace cs {
+
+class Gdsf : public ByteStore
+{
+public:
+	enum Cost
+	{
+		HITS,
+		BYTES
+	};
+
+	static TypeId GetTypeId (void);
+
+	Gdsf ();
+	virtual ~Gdsf ();
+
+protected:
+	virtual void DoInsert (Entry *entry, uint32_t cost);
+	virtual void DoHit (Entry *entry);
+	virtual Entry *DoVictim (void);
+	virtual void DoRemove (Entry *entry);
+
+private:
+	struct Queue;
+
+	void Enqueue (Entry *entry);
+
+	Queue *m_queue;
+	Cost m_cost;
+	double m_age;
+};
+
+} // namespace cs
+} // namespace ndn
+} // namespace ns3
+
+#endif /* GDSF_CONTENT_STORE_H_ */
@@ -0,0 +1,369 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * grid-wifi-channel.cc
+ *
+ *  YansWifiChannel delivering only to the PHYs of the cells around the
+ *  sender.
+ *
+ *  YansWifiChannel::Send () is not virtual and walks every PHY added to the
+ *  channel, so the grid does not override it: each PHY is moved onto a
+ *  YansWifiChannel of its own that lists its neighbours. A node entering a
+ *  neighbourhood is added to the channels around it and they to its own.
+ *  YansWifiChannel cannot remove a PHY, and pending receptions refer to
+ *  PHYs by position, so one that leaves stays on the channel: frames from
+ *  beyond MaxRange reach it below the reception threshold and are dropped,
+ *  as on a plain YansWifiChannel. Every channel is created once, and the
+ *  ChannelList keeps them all.
+ */
+
+#include "grid-wifi-channel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+
+#include <boost/lexical_cast.hpp>
+
+#include <ns3-dev/ns3/abort.h>
+#include <ns3-dev/ns3/constant-position-mobility-model.h>
+#include <ns3-dev/ns3/double.h>
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/node.h>
+#include <ns3-dev/ns3/pointer.h>
+#include <ns3-dev/ns3/simulator.h>
+#include <ns3-dev/ns3/wifi-net-device.h>
+
+NS_LOG_COMPONENT_DEFINE ("GridWifiChannel");
+
+namespace ns3 {
+
+namespace {
+
+uint64_t
+MakeCell (int32_t x, int32_t y)
+{
+	return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
+
+} // anonymous namespace
+
+NS_OBJECT_ENSURE_REGISTERED (GridWifiChannel);
+
+TypeId
+GridWifiChannel::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::GridWifiChannel")
+		.SetParent<YansWifiChannel> ()
+		.AddConstructor<GridWifiChannel> ()
+		.AddAttribute ("MaxRange",
+				"Meters beyond which no PHY receives",
+				DoubleValue (250.0),
+				MakeDoubleAccessor (&GridWifiChannel::m_maxRange),
+				MakeDoubleChecker<double> (0.0))
+		.AddAttribute ("Margin",
+				"Meters added to the cell size, more than twice what a node travels in UpdateInterval",
+				DoubleValue (20.0),
+				MakeDoubleAccessor (&GridWifiChannel::m_margin),
+				MakeDoubleChecker<double> (0.0))
+		.AddAttribute ("UpdateInterval",
+				"Time between cell checks of moving nodes",
+				TimeValue (Seconds (0.5)),
+				MakeTimeAccessor (&GridWifiChannel::m_updateInterval),
+				MakeTimeChecker ())
+		;
+	return tid;
+}
+
+GridWifiChannel::GridWifiChannel ()
+	: m_receivers (0)
+{
+}
+
+GridWifiChannel::~GridWifiChannel ()
+{
+}
+
+Ptr<GridWifiChannel>
+GridWifiChannel::Create (const YansWifiChannelHelper &helper)
+{
+	Ptr<YansWifiChannel> plain = helper.Create ();
+
+	PointerValue loss;
+	PointerValue delay;
+	plain->GetAttribute ("PropagationLossModel", loss);
+	plain->GetAttribute ("PropagationDelayModel", delay);
+
+	Ptr<GridWifiChannel> grid = CreateObject<GridWifiChannel> ();
+	grid->SetPropagationLossModel (loss.Get<PropagationLossModel> ());
+	grid->SetPropagationDelayModel (delay.Get<PropagationDelayModel> ());
+	return grid;
+}
+
+double
+GridWifiChannel::GetRange (Ptr<PropagationLossModel> loss, double txPowerDbm, double thresholdDbm)
+{
+	Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+	Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+	a->SetPosition (Vector (0.0, 0.0, 0.0));
+
+	// Double until out of range, then bisect
+	double high = 1.0;
+	for (; high < 1e7; high *= 2)
+	{
+		b->SetPosition (Vector (high, 0.0, 0.0));
+		if (loss->CalcRxPower (txPowerDbm, a, b) < thresholdDbm)
+		{
+			break;
+		}
+	}
+
+	double low = high / 2;
+	while (high - low > 0.01)
+	{
+		double middle = (low + high) / 2;
+		b->SetPosition (Vector (middle, 0.0, 0.0));
+		if (loss->CalcRxPower (txPowerDbm, a, b) < thresholdDbm)
+		{
+			high = middle;
+		}
+		else
+		{
+			low = middle;
+		}
+	}
+
+	return high;
+}
+
+void
+GridWifiChannel::Add (const NetDeviceContainer &devices)
+{
+	NS_ABORT_MSG_UNLESS (m_maxRange > 0, "GridWifiChannel needs a MaxRange");
+
+	// Set through YansWifiChannel, whichever way the channel was built
+	if (m_loss == 0)
+	{
+		PointerValue loss;
+		PointerValue delay;
+		GetAttribute ("PropagationLossModel", loss);
+		GetAttribute ("PropagationDelayModel", delay);
+		m_loss = loss.Get<PropagationLossModel> ();
+		m_delay = delay.Get<PropagationDelayModel> ();
+	}
+
+	for (NetDeviceContainer::Iterator d = devices.Begin (); d != devices.End (); ++d)
+	{
+		Ptr<WifiNetDevice> wifi = DynamicCast<WifiNetDevice> (*d);
+		NS_ABORT_MSG_UNLESS (wifi != 0, "Node " << (*d)->GetNode ()->GetId () << ": not a WifiNetDevice");
+
+		Member member;
+		member.phy = DynamicCast<YansWifiPhy> (wifi->GetPhy ());
+		member.mobility = wifi->GetNode ()->GetObject<MobilityModel> ();
+		NS_ABORT_MSG_UNLESS (member.phy != 0, "Node " << wifi->GetNode ()->GetId () << ": not a YansWifiPhy");
+		NS_ABORT_MSG_UNLESS (member.mobility != 0, "Node " << wifi->GetNode ()->GetId () << ": no MobilityModel");
+		member.cell = GetCell (member.mobility);
+
+		// Its own channel, the only one it sends on. Setting it adds the PHY,
+		// which Send () skips as the sender
+		member.channel = CreateObject<YansWifiChannel> ();
+		member.channel->SetPropagationLossModel (m_loss);
+		member.channel->SetPropagationDelayModel (m_delay);
+		member.phy->SetChannel (member.channel);
+
+		uint32_t index = m_members.size ();
+		m_members.push_back (member);
+		m_cells[member.cell].push_back (index);
+
+		// The new PHY hears its neighbours and they hear it
+		std::vector<uint32_t> neighbours = GetNeighbours (member.cell);
+		for (size_t n = 0; n < neighbours.size (); n++)
+		{
+			Connect (index, neighbours[n]);
+		}
+
+		member.mobility->TraceConnect ("CourseChange", boost::lexical_cast<std::string> (index),
+				MakeCallback (&GridWifiChannel::CourseChanged, this));
+
+		Vector velocity = member.mobility->GetVelocity ();
+		if (velocity.x != 0 || velocity.y != 0)
+		{
+			m_moving.insert (index);
+		}
+	}
+
+	if (!m_moving.empty () && !m_update.IsRunning ())
+	{
+		m_update = Simulator::Schedule (m_updateInterval, &GridWifiChannel::Update, this);
+	}
+
+	NS_LOG_INFO (m_members.size () << " PHYs in " << m_cells.size () << " cells of "
+			<< m_maxRange + m_margin << " m");
+}
+
+uint32_t
+GridWifiChannel::GetNPhys (void) const
+{
+	return m_members.size ();
+}
+
+uint64_t
+GridWifiChannel::GetReceivers (void) const
+{
+	return m_receivers;
+}
+
+void
+GridWifiChannel::DoDispose (void)
+{
+	m_members.clear ();
+	m_cells.clear ();
+	m_moving.clear ();
+	m_loss = 0;
+	m_delay = 0;
+	YansWifiChannel::DoDispose ();
+}
+
+uint64_t
+GridWifiChannel::GetCell (Ptr<MobilityModel> mobility) const
+{
+	// Only x and y, distances in the plane are never above the real ones
+	Vector position = mobility->GetPosition ();
+	double size = m_maxRange + m_margin;
+	return MakeCell ((int32_t)std::floor (position.x / size), (int32_t)std::floor (position.y / size));
+}
+
+std::vector<uint32_t>
+GridWifiChannel::GetNeighbours (uint64_t cell) const
+{
+	int32_t x = (int32_t)(uint32_t)(cell >> 32);
+	int32_t y = (int32_t)(uint32_t)cell;
+
+	std::vector<uint32_t> neighbours;
+	for (int32_t dx = -1; dx <= 1; dx++)
+	{
+		for (int32_t dy = -1; dy <= 1; dy++)
+		{
+			std::map<uint64_t, std::vector<uint32_t> >::const_iterator c = m_cells.find (MakeCell (x + dx, y + dy));
+			if (c != m_cells.end ())
+			{
+				neighbours.insert (neighbours.end (), c->second.begin (), c->second.end ());
+			}
+		}
+	}
+
+	std::sort (neighbours.begin (), neighbours.end ());
+	return neighbours;
+}
+
+void
+GridWifiChannel::Connect (uint32_t a, uint32_t b)
+{
+	if (a == b)
+	{
+		return;
+	}
+
+	// Once per pair, a PHY listed twice would receive every frame twice
+	if (m_members[a].receivers.insert (b).second)
+	{
+		m_members[a].channel->Add (m_members[b].phy);
+		m_receivers++;
+	}
+	if (m_members[b].receivers.insert (a).second)
+	{
+		m_members[b].channel->Add (m_members[a].phy);
+		m_receivers++;
+	}
+}
+
+void
+GridWifiChannel::Move (uint32_t index)
+{
+	// Reading the position may fire CourseChange and move the PHY first
+	uint64_t to = GetCell (m_members[index].mobility);
+	uint64_t from = m_members[index].cell;
+	if (from == to)
+	{
+		return;
+	}
+
+	std::vector<uint32_t> &old = m_cells[from];
+	old.erase (std::find (old.begin (), old.end (), index));
+	if (old.empty ())
+	{
+		m_cells.erase (from);
+	}
+	m_cells[to].push_back (index);
+	m_members[index].cell = to;
+
+	std::vector<uint32_t> before = GetNeighbours (from);
+	std::vector<uint32_t> after = GetNeighbours (to);
+
+	// Channels only grow, the neighbours left behind keep the PHY
+	std::vector<uint32_t> joined;
+	std::set_difference (after.begin (), after.end (), before.begin (), before.end (), std::back_inserter (joined));
+	for (size_t n = 0; n < joined.size (); n++)
+	{
+		Connect (index, joined[n]);
+	}
+
+	NS_LOG_DEBUG ("PHY " << index << " changed cell, " << joined.size () << " neighbours joined");
+}
+
+void
+GridWifiChannel::CourseChanged (std::string member, Ptr<const MobilityModel> mobility)
+{
+	uint32_t index = std::atoi (member.c_str ());
+	if (index >= m_members.size ())
+	{
+		return;
+	}
+
+	Vector velocity = mobility->GetVelocity ();
+	if (velocity.x != 0 || velocity.y != 0)
+	{
+		m_moving.insert (index);
+		if (!m_update.IsRunning ())
+		{
+			m_update = Simulator::Schedule (m_updateInterval, &GridWifiChannel::Update, this);
+		}
+	}
+	else
+	{
+		m_moving.erase (index);
+	}
+
+	Move (index);
+}
+
+void
+GridWifiChannel::Update (void)
+{
+	// Copied, course changes fired by Move () update m_moving
+	std::set<uint32_t> moving = m_moving;
+	for (std::set<uint32_t>::const_iterator i = moving.begin (); i != moving.end (); ++i)
+	{
+		Move (*i);
+	}
+
+	if (!m_moving.empty ())
+	{
+		m_update = Simulator::Schedule (m_updateInterval, &GridWifiChannel::Update, this);
+	}
+}
+
+} // namespace ns3
@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * grid-wifi-channel.h
+ *
+ *  YansWifiChannel that only delivers to PHYs near the sender. PHYs are
+ *  kept in a grid of square cells of MaxRange + Margin meters, and each
+ *  one sends on its own YansWifiChannel holding the PHYs of the 3x3 cells
+ *  around it. Transmissions cost in proportion to the nodes around the
+ *  sender rather than to every node on the channel.
+ *
+ *  Everything within MaxRange is delivered with the same loss and delay
+ *  models as YansWifiChannel, so results match as long as no receiver
+ *  beyond MaxRange would have been above its reception threshold. Give a
+ *  MaxRange with some fading margin, see GetRange ().
+ *
+ *  Moving nodes change cell on course changes and are checked every
+ *  UpdateInterval. Margin must be more than twice the distance a node
+ *  travels in UpdateInterval. A channel keeps the PHYs that moved away, so
+ *  memory is bounded by the pairs of nodes that ever met, not by the run
+ *  length.
+ *
+ *  Use as the channel of YansWifiPhyHelper, then pass the installed
+ *  devices to Add (). Devices not added send through the plain
+ *  YansWifiChannel.
+ */
+
+#ifndef GRID_WIFI_CHANNEL_H_
+#define GRID_WIFI_CHANNEL_H_
+
+#include <map>
+#include <set>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <ns3-dev/ns3/event-id.h>
+#include <ns3-dev/ns3/mobility-model.h>
+#include <ns3-dev/ns3/net-device-container.h>
+#include <ns3-dev/ns3/nstime.h>
+#include <ns3-dev/ns3/propagation-delay-model.h>
+#include <ns3-dev/ns3/propagation-loss-model.h>
+#include <ns3-dev/ns3/yans-wifi-channel.h>
+#include <ns3-dev/ns3/yans-wifi-helper.h>
+#include <ns3-dev/ns3/yans-wifi-phy.h>
+
+namespace ns3 {
+
+class GridWifiChannel : public YansWifiChannel
+{
+public:
+	static TypeId GetTypeId (void);
+
+	GridWifiChannel ();
+	virtual ~GridWifiChannel ();
+
+	// Channel with the loss and delay models helper would give a
+	// YansWifiChannel
+	static Ptr<GridWifiChannel> Create (const YansWifiChannelHelper &helper);
+
+	// Moves the PHYs of the WifiNetDevices onto the grid. Their nodes need
+	// a MobilityModel
+	void Add (const NetDeviceContainer &devices);
+
+	// Distance at which loss brings txPowerDbm below thresholdDbm
+	static double GetRange (Ptr<PropagationLossModel> loss, double txPowerDbm, double thresholdDbm);
+
+	// PHYs on the grid, and the receivers listed on all their channels
+	uint32_t GetNPhys (void) const;
+	uint64_t GetReceivers (void) const;
+
+protected:
+	virtual void DoDispose (void);
+
+private:
+	struct Member
+	{
+		Ptr<YansWifiPhy> phy;
+		Ptr<MobilityModel> mobility;
+		uint64_t cell;
+		Ptr<YansWifiChannel> channel;
+		// Members on channel
+		std::set<uint32_t> receivers;
+	};
+
+	uint64_t GetCell (Ptr<MobilityModel> mobility) const;
+	std::vector<uint32_t> GetNeighbours (uint64_t cell) const;
+	void Connect (uint32_t a, uint32_t b);
+	void Move (uint32_t member);
+	void CourseChanged (std::string member, Ptr<const MobilityModel> mobility);
+	void Update (void);
+
+	double m_maxRange;
+	double m_margin;
+	Time m_updateInterval;
+
+	Ptr<PropagationLossModel> m_loss;
+	Ptr<PropagationDelayModel> m_delay;
+
+	std::vector<Member> m_members;
+	std::map<uint64_t, std::vector<uint32_t> > m_cells;
+	// Members with a non zero speed
+	std::set<uint32_t> m_moving;
+	EventId m_update;
+	uint64_t m_receivers;
+};
+
+} // namespace ns3
+
+#endif /* GRID_WIFI_CHANNEL_H_ */
@@ -0,0 +1,353 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * handoff-controller.cc
+ *
+ *  Scheduled AP handoffs through direct StaWifiMac or WifiPhy pointers.
+ */
+
+#include "handoff-controller.h"
+
+#include <algorithm>
+
+#include <boost/lexical_cast.hpp>
+
+#include <ns3-dev/ns3/abort.h>
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/node.h>
+#include <ns3-dev/ns3/simulator.h>
+#include <ns3-dev/ns3/wifi-net-device.h>
+
+NS_LOG_COMPONENT_DEFINE ("HandoffController");
+
+namespace ns3 {
+
+namespace {
+
+// Ideal mode channel numbers: AP i is on kFirstChannel + i, terminal t
+// sits alone on kOutageChannel - t while in an outage, so terminals in an
+// outage cannot hear each other either
+const uint16_t kFirstChannel = 1;
+const uint16_t kOutageChannel = 0xffff;
+const uint32_t kNoAp = 0xffffffff;
+
+Ptr<WifiNetDevice>
+GetWifi (Ptr<NetDevice> device)
+{
+	Ptr<WifiNetDevice> wifi = DynamicCast<WifiNetDevice> (device);
+	NS_ABORT_MSG_UNLESS (wifi != 0, "Device " << device->GetIfIndex () << " of node "
+			<< device->GetNode ()->GetId () << " is not a WifiNetDevice");
+	return wifi;
+}
+
+} // anonymous namespace
+
+bool
+HandoffController::Handoff::operator< (const Handoff &other) const
+{
+	return at < other.at;
+}
+
+HandoffController::HandoffController ()
+	: m_ideal (false)
+	, m_next (0)
+{
+}
+
+void
+HandoffController::SetIdeal (Time outage)
+{
+	NS_ABORT_MSG_UNLESS (m_terminals.empty () && m_aps.empty (), "SetIdeal () goes before adding terminals and APs");
+	m_ideal = true;
+	m_outage = outage;
+}
+
+uint32_t
+HandoffController::AddTerminal (Ptr<NetDevice> device)
+{
+	Ptr<WifiNetDevice> wifi = GetWifi (device);
+
+	Terminal terminal;
+	terminal.ap = kNoAp;
+
+	if (m_ideal)
+	{
+		// Unreachable until the first handoff, as a station before it
+		// associates
+		NS_ABORT_MSG_UNLESS (kFirstChannel + m_aps.size () + m_terminals.size () <= kOutageChannel,
+				"Out of channel numbers");
+		terminal.phy = wifi->GetPhy ();
+		terminal.mobility = device->GetNode ()->GetObject<MobilityModel> ();
+		terminal.phy->SetChannelNumber (kOutageChannel - m_terminals.size ());
+	}
+	else
+	{
+		terminal.mac = DynamicCast<StaWifiMac> (wifi->GetMac ());
+		NS_ABORT_MSG_UNLESS (terminal.mac != 0, "Node " << device->GetNode ()->GetId () << " has no StaWifiMac");
+
+		// The terminal index as context, to tell whose association it is
+		terminal.mac->TraceConnect ("Assoc", boost::lexical_cast<std::string> (m_terminals.size ()),
+				MakeCallback (&HandoffController::Associated, this));
+	}
+
+	m_terminals.push_back (terminal);
+	return m_terminals.size () - 1;
+}
+
+uint32_t
+HandoffController::AddTerminals (const NetDeviceContainer &devices)
+{
+	uint32_t first = m_terminals.size ();
+	for (NetDeviceContainer::Iterator i = devices.Begin (); i != devices.End (); ++i)
+	{
+		AddTerminal (*i);
+	}
+	return first;
+}
+
+uint32_t
+HandoffController::AddAp (const Ssid &ssid)
+{
+	NS_ABORT_MSG_IF (m_ideal, "Ideal mode APs are added by device");
+
+	Ap ap;
+	ap.ssid = ssid;
+	m_aps.push_back (ap);
+	return m_aps.size () - 1;
+}
+
+uint32_t
+HandoffController::AddAps (const std::vector<Ssid> &ssids)
+{
+	uint32_t first = m_aps.size ();
+	for (size_t i = 0; i < ssids.size (); i++)
+	{
+		AddAp (ssids[i]);
+	}
+	return first;
+}
+
+uint32_t
+HandoffController::AddAp (Ptr<NetDevice> device)
+{
+	NS_ABORT_MSG_UNLESS (m_ideal, "APs are added by device in ideal mode only");
+	NS_ABORT_MSG_UNLESS (kFirstChannel + m_aps.size () + m_terminals.size () <= kOutageChannel,
+			"Out of channel numbers");
+
+	uint32_t index = m_aps.size ();
+	GetWifi (device)->GetPhy ()->SetChannelNumber (kFirstChannel + index);
+
+	Ap ap;
+	ap.mobility = device->GetNode ()->GetObject<MobilityModel> ();
+	m_aps.push_back (ap);
+	return index;
+}
+
+uint32_t
+HandoffController::AddAps (const NetDeviceContainer &devices)
+{
+	uint32_t first = m_aps.size ();
+	for (NetDeviceContainer::Iterator i = devices.Begin (); i != devices.End (); ++i)
+	{
+		AddAp (*i);
+	}
+	return first;
+}
+
+void
+HandoffController::Add (Time at, uint32_t terminal, uint32_t ap)
+{
+	NS_ASSERT_MSG (terminal < m_terminals.size (), "Unknown terminal " << terminal);
+	NS_ASSERT_MSG (ap < m_aps.size (), "Unknown AP " << ap);
+
+	Handoff handoff;
+	handoff.at = at;
+	handoff.terminal = terminal;
+	handoff.ap = ap;
+	m_schedule.push_back (handoff);
+}
+
+void
+HandoffController::Install (void)
+{
+	// Stable, so handoffs at the same time run in the order they were added
+	std::stable_sort (m_schedule.begin () + m_next, m_schedule.end ());
+
+	m_event.Cancel ();
+	if (m_next < m_schedule.size ())
+	{
+		Time delay = std::max (m_schedule[m_next].at - Simulator::Now (), Time (0));
+		m_event = Simulator::Schedule (delay, &HandoffController::DoHandoffs, this);
+	}
+
+	NS_LOG_INFO ("Scheduled " << m_schedule.size () - m_next << " handoffs of "
+			<< m_terminals.size () << " terminals between " << m_aps.size () << " APs");
+}
+
+void
+HandoffController::FollowNearest (Time interval)
+{
+	NS_ABORT_MSG_UNLESS (m_ideal, "FollowNearest () needs ideal mode");
+	for (uint32_t t = 0; t < m_terminals.size (); t++)
+	{
+		NS_ABORT_MSG_UNLESS (m_terminals[t].mobility != 0, "Terminal " << t << " has no MobilityModel");
+	}
+	for (uint32_t a = 0; a < m_aps.size (); a++)
+	{
+		NS_ABORT_MSG_UNLESS (m_aps[a].mobility != 0, "AP " << a << " has no MobilityModel");
+	}
+
+	m_nearest.Cancel ();
+	m_nearest = Simulator::ScheduleNow (&HandoffController::Nearest, this, interval);
+}
+
+void
+HandoffController::TraceAssociations (Callback<void, uint32_t, uint32_t> callback)
+{
+	m_associations.ConnectWithoutContext (callback);
+}
+
+uint32_t
+HandoffController::GetTerminals (void) const
+{
+	return m_terminals.size ();
+}
+
+uint32_t
+HandoffController::GetHandoffs (void) const
+{
+	return m_schedule.size ();
+}
+
+void
+HandoffController::DoHandoffs (void)
+{
+	Time now = Simulator::Now ();
+
+	// Everything due now, then one event for the next time
+	while (m_next < m_schedule.size () && m_schedule[m_next].at <= now)
+	{
+		const Handoff &handoff = m_schedule[m_next++];
+		DoHandoff (handoff.terminal, handoff.ap);
+	}
+
+	if (m_next < m_schedule.size ())
+	{
+		m_event = Simulator::Schedule (m_schedule[m_next].at - now, &HandoffController::DoHandoffs, this);
+	}
+}
+
+void
+HandoffController::DoHandoff (uint32_t index, uint32_t ap)
+{
+	Terminal &terminal = m_terminals[index];
+
+	NS_LOG_INFO ("Terminal " << index << " to AP " << ap);
+
+	if (!m_ideal)
+	{
+		terminal.mac->SetSsid (m_aps[ap].ssid);
+		return;
+	}
+
+	// A handoff within the outage of the previous one restarts it
+	terminal.ap = ap;
+	terminal.associate.Cancel ();
+
+	if (m_outage.IsStrictlyPositive ())
+	{
+		SetChannel (index, kOutageChannel - index);
+		terminal.associate = Simulator::Schedule (m_outage, &HandoffController::Associate, this, index);
+	}
+	else
+	{
+		Associate (index);
+	}
+}
+
+void
+HandoffController::Associate (uint32_t index)
+{
+	Terminal &terminal = m_terminals[index];
+	SetChannel (index, kFirstChannel + terminal.ap);
+	m_associations (index, terminal.ap);
+}
+
+void
+HandoffController::SetChannel (uint32_t index, uint16_t channel)
+{
+	Terminal &terminal = m_terminals[index];
+
+	// The PHY cannot switch again before the last switch is over, nor in the
+	// middle of a frame. Only the latest channel asked for matters
+	terminal.switching.Cancel ();
+	if (terminal.phy->IsStateSwitching () || terminal.phy->IsStateTx ())
+	{
+		terminal.switching = Simulator::Schedule (terminal.phy->GetDelayUntilIdle (),
+				&HandoffController::SetChannel, this, index, channel);
+		return;
+	}
+
+	terminal.phy->SetChannelNumber (channel);
+}
+
+void
+HandoffController::Associated (std::string context, Mac48Address bssid)
+{
+	uint32_t index = boost::lexical_cast<uint32_t> (context);
+	Ssid ssid = m_terminals[index].mac->GetSsid ();
+
+	// The AP is the one whose SSID the terminal was given
+	for (uint32_t ap = 0; ap < m_aps.size (); ap++)
+	{
+		if (m_aps[ap].ssid.IsEqual (ssid))
+		{
+			NS_LOG_INFO ("Terminal " << index << " associated with AP " << ap << " (" << bssid << ")");
+			m_terminals[index].ap = ap;
+			m_associations (index, ap);
+			return;
+		}
+	}
+}
+
+void
+HandoffController::Nearest (Time interval)
+{
+	for (uint32_t t = 0; t < m_terminals.size (); t++)
+	{
+		Vector position = m_terminals[t].mobility->GetPosition ();
+
+		uint32_t nearest = kNoAp;
+		double best = 0;
+		for (uint32_t a = 0; a < m_aps.size (); a++)
+		{
+			double distance = CalculateDistance (position, m_aps[a].mobility->GetPosition ());
+			if (nearest == kNoAp || distance < best)
+			{
+				nearest = a;
+				best = distance;
+			}
+		}
+
+		if (nearest != kNoAp && nearest != m_terminals[t].ap)
+		{
+			DoHandoff (t, nearest);
+		}
+	}
+
+	m_nearest = Simulator::Schedule (interval, &HandoffController::Nearest, this, interval);
+}
+
+} // namespace ns3
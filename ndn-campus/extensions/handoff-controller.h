@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * handoff-controller.h
+ *
+ *  Forces mobile terminals onto given APs at given times by changing the
+ *  SSID of their StaWifiMac, like Config::Set on
+ *  /NodeList/N/DeviceList/0/$ns3::WifiNetDevice/Mac/Ssid does, but through
+ *  pointers kept when the terminals are added. The schedule is sorted once
+ *  and walked by a single pending event, so each handoff costs the same
+ *  whatever the number of nodes, terminals and handoffs.
+ *
+ *  In ideal mode (SetIdeal ()) no beacon, probe or association frame is
+ *  simulated: APs and terminals use AdhocWifiMac, every AP gets a channel
+ *  number of its own and a handoff switches the PHY of the terminal to the
+ *  channel of its new AP, after a fixed outage. Before their first handoff
+ *  and during outages terminals sit on a channel of their own. A switch
+ *  asked for while the PHY is still switching or sending waits for it to
+ *  be idle. Terminals follow the schedule or, with FollowNearest (), the
+ *  closest AP.
+ */
+
+#ifndef HANDOFF_CONTROLLER_H_
+#define HANDOFF_CONTROLLER_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <ns3-dev/ns3/callback.h>
+#include <ns3-dev/ns3/event-id.h>
+#include <ns3-dev/ns3/mac48-address.h>
+#include <ns3-dev/ns3/mobility-model.h>
+#include <ns3-dev/ns3/net-device-container.h>
+#include <ns3-dev/ns3/nstime.h>
+#include <ns3-dev/ns3/ssid.h>
+#include <ns3-dev/ns3/sta-wifi-mac.h>
+#include <ns3-dev/ns3/traced-callback.h>
+#include <ns3-dev/ns3/wifi-phy.h>
+
+namespace ns3 {
+
+class HandoffController
+{
+public:
+	HandoffController ();
+
+	// Ideal association, terminals being unreachable for outage on every
+	// handoff. Call before adding terminals and APs
+	void SetIdeal (Time outage);
+
+	// Adds the StaWifiMac (ideal mode: the PHY) of a WifiNetDevice, returns
+	// its terminal index. The devices of a container get consecutive
+	// indexes, the first one is returned
+	uint32_t AddTerminal (Ptr<NetDevice> device);
+	uint32_t AddTerminals (const NetDeviceContainer &devices);
+
+	// Adds an AP by SSID, returns its AP index. Same for a list of SSIDs
+	uint32_t AddAp (const Ssid &ssid);
+	uint32_t AddAps (const std::vector<Ssid> &ssids);
+
+	// Ideal mode: adds an AP by its WifiNetDevice, whose PHY is moved to a
+	// channel number of its own
+	uint32_t AddAp (Ptr<NetDevice> device);
+	uint32_t AddAps (const NetDeviceContainer &devices);
+
+	// Moves terminal to ap at time at
+	void Add (Time at, uint32_t terminal, uint32_t ap);
+
+	// Schedules the handoffs added so far. The controller must live until
+	// Simulator::Run () returns
+	void Install (void);
+
+	// Ideal mode: every interval, hands each terminal off to the closest AP
+	// if it is not the current one
+	void FollowNearest (Time interval);
+
+	// Calls callback with the terminal and AP indexes whenever a terminal
+	// gets onto an AP: on the Assoc trace of its StaWifiMac or, in ideal
+	// mode, at the end of the outage
+	void TraceAssociations (Callback<void, uint32_t, uint32_t> callback);
+
+	uint32_t GetTerminals (void) const;
+	uint32_t GetHandoffs (void) const;
+
+private:
+	struct Handoff
+	{
+		Time at;
+		uint32_t terminal;
+		uint32_t ap;
+
+		bool operator< (const Handoff &other) const;
+	};
+
+	struct Terminal
+	{
+		Ptr<StaWifiMac> mac;
+		Ptr<WifiPhy> phy;
+		Ptr<MobilityModel> mobility;
+		uint32_t ap;
+		EventId associate;
+		EventId switching;
+	};
+
+	struct Ap
+	{
+		Ssid ssid;
+		Ptr<MobilityModel> mobility;
+	};
+
+	void DoHandoffs (void);
+	void DoHandoff (uint32_t terminal, uint32_t ap);
+	void Associate (uint32_t terminal);
+	void SetChannel (uint32_t terminal, uint16_t channel);
+	void Associated (std::string terminal, Mac48Address bssid);
+	void Nearest (Time interval);
+
+	bool m_ideal;
+	Time m_outage;
+	std::vector<Terminal> m_terminals;
+	std::vector<Ap> m_aps;
+	std::vector<Handoff> m_schedule;
+	size_t m_next;
+	EventId m_event;
+	EventId m_nearest;
+	TracedCallback<uint32_t, uint32_t> m_associations;
+};
+
+} // namespace ns3
+
+#endif /* HANDOFF_CONTROLLER_H_ */
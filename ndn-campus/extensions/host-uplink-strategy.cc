@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * host-uplink-strategy.cc
+ *
+ *  Stateless forwarding between host applications and their uplink.
+ */
+
+#include "host-uplink-strategy.h"
+
+#include <algorithm>
+
+#include <boost/foreach.hpp>
+
+#include <ns3-dev/ns3/log.h>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.fw.HostUplink");
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+NS_OBJECT_ENSURE_REGISTERED (HostUplink);
+
+TypeId
+HostUplink::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::ndn::fw::HostUplink")
+		.SetGroupName ("Ndn")
+		.SetParent<ForwardingStrategy> ()
+		.AddConstructor<HostUplink> ()
+		;
+	return tid;
+}
+
+std::string
+HostUplink::GetLogName (void)
+{
+	return "ndn.fw.HostUplink";
+}
+
+HostUplink::HostUplink ()
+{
+}
+
+void
+HostUplink::AddFace (Ptr<Face> face)
+{
+	if (face->GetFlags () & Face::APPLICATION)
+	{
+		m_apps.push_back (face);
+	}
+	else
+	{
+		m_uplinks.push_back (face);
+	}
+	ForwardingStrategy::AddFace (face);
+}
+
+void
+HostUplink::RemoveFace (Ptr<Face> face)
+{
+	m_apps.erase (std::remove (m_apps.begin (), m_apps.end (), face), m_apps.end ());
+	m_uplinks.erase (std::remove (m_uplinks.begin (), m_uplinks.end (), face), m_uplinks.end ());
+	ForwardingStrategy::RemoveFace (face);
+}
+
+void
+HostUplink::OnInterest (Ptr<Face> inFace, Ptr<Interest> interest)
+{
+	m_inInterests (interest, inFace);
+
+	if (inFace->GetFlags () & Face::APPLICATION)
+	{
+		for (size_t i = 0; i < m_uplinks.size (); i++)
+		{
+			if (m_uplinks[i]->SendInterest (interest))
+			{
+				m_outInterests (interest, m_uplinks[i]);
+			}
+		}
+		return;
+	}
+
+	// From the network, only for the applications that registered a prefix.
+	// Anything no application takes is dropped, even if a route to the
+	// uplink matched
+	bool sent = false;
+	Ptr<fib::Entry> entry = m_fib->LongestPrefixMatch (*interest);
+	if (entry != 0)
+	{
+		BOOST_FOREACH (const fib::FaceMetric &metricFace, entry->m_faces.get<fib::i_metric> ())
+		{
+			Ptr<Face> outFace = metricFace.GetFace ();
+			if (outFace != inFace && (outFace->GetFlags () & Face::APPLICATION) && outFace->SendInterest (interest))
+			{
+				m_outInterests (interest, outFace);
+				sent = true;
+			}
+		}
+	}
+
+	if (!sent)
+	{
+		m_dropInterests (interest, inFace);
+	}
+}
+
+void
+HostUplink::OnData (Ptr<Face> inFace, Ptr<Data> data)
+{
+	m_inData (data, inFace);
+
+	// Answers of the producer applications go up, the rest to every
+	// application, which drop what they did not ask for
+	const std::vector<Ptr<Face> > &outFaces = (inFace->GetFlags () & Face::APPLICATION) ? m_uplinks : m_apps;
+
+	for (size_t i = 0; i < outFaces.size (); i++)
+	{
+		if (outFaces[i] != inFace && outFaces[i]->SendData (data))
+		{
+			m_outData (data, false, outFaces[i]);
+		}
+	}
+}
+
+bool
+HostUplink::DoPropagateInterest (Ptr<Face> inFace, Ptr<const Interest> interest, Ptr<pit::Entry> pitEntry)
+{
+	// Never reached, OnInterest () does not create PIT entries
+	return false;
+}
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * host-uplink-strategy.h
+ *
+ *  Forwarding for hosts that run applications behind one uplink, such as
+ *  the LAN clients of the scenarios. Interests and Data of the
+ *  applications go straight out of the uplink faces, and Data coming in
+ *  goes straight to the applications: no PIT entry, no FIB lookup and no
+ *  ContentStore. Applications keep track of their outstanding Interests
+ *  themselves, as the ndnSIM consumers do, and drop Data they did not ask
+ *  for.
+ *
+ *  Interests coming in from the uplink only look up the FIB, to find the
+ *  producer applications. Install without default routes, so the FIB only
+ *  holds their prefixes:
+ *
+ *    ndn::StackHelper hosts;
+ *    hosts.SetForwardingStrategy ("ns3::ndn::fw::HostUplink");
+ *    hosts.SetContentStore ("ns3::ndn::cs::Nocache");
+ *    hosts.SetDefaultRoutes (false);
+ */
+
+#ifndef HOST_UPLINK_STRATEGY_H_
+#define HOST_UPLINK_STRATEGY_H_
+
+#include <string>
+#include <vector>
+
+#include <ns3-dev/ns3/ndnSIM-module.h>
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+class HostUplink : public ForwardingStrategy
+{
+public:
+	static TypeId GetTypeId (void);
+	static std::string GetLogName (void);
+
+	HostUplink ();
+
+	virtual void OnInterest (Ptr<Face> face, Ptr<Interest> interest);
+	virtual void OnData (Ptr<Face> face, Ptr<Data> data);
+
+	virtual void AddFace (Ptr<Face> face);
+	virtual void RemoveFace (Ptr<Face> face);
+
+protected:
+	virtual bool DoPropagateInterest (Ptr<Face> inFace, Ptr<const Interest> interest, Ptr<pit::Entry> pitEntry);
+
+private:
+	std::vector<Ptr<Face> > m_apps;
+	std::vector<Ptr<Face> > m_uplinks;
+};
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
+
+#endif /* HOST_UPLINK_STRATEGY_H_ */
@@ -0,0 +1,352 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * memory-accounting.cc
+ *
+ *  Per-subsystem memory estimates grouped by node tier.
+ */
+
+#include "memory-accounting.h"
+
+#include <iostream>
+
+#include <ns3-dev/ns3/application.h>
+#include <ns3-dev/ns3/csma-net-device.h>
+#include <ns3-dev/ns3/ipv4-l3-protocol.h>
+#include <ns3-dev/ns3/ipv4-interface.h>
+#include <ns3-dev/ns3/ipv4-list-routing.h>
+#include <ns3-dev/ns3/ipv4-routing-table-entry.h>
+#include <ns3-dev/ns3/ipv4-static-routing.h>
+#include <ns3-dev/ns3/arp-cache.h>
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/node-list.h>
+#include <ns3-dev/ns3/point-to-point-net-device.h>
+#include <ns3-dev/ns3/point-to-point-channel.h>
+#include <ns3-dev/ns3/queue.h>
+#include <ns3-dev/ns3/simulator.h>
+#include <ns3-dev/ns3/ndnSIM-module.h>
+
+NS_LOG_COMPONENT_DEFINE ("MemoryAccounting");
+
+namespace ns3 {
+
+namespace {
+
+// Rough per item costs for what sizeof can't see: heap blocks behind
+// Ptr<>, trie nodes, multi_index hooks and the like
+const uint64_t kAggregate = 64;
+const uint64_t kTrieNode = 96;
+const uint64_t kFaceRecord = 48;
+const uint64_t kFaceMetric = 96;
+const uint64_t kCsEntry = 160;
+const uint64_t kPacket = 128;
+const uint64_t kApplication = 256;
+const uint64_t kNdnFace = 192;
+
+uint64_t
+NameBytes (const ndn::Name &name)
+{
+	uint64_t bytes = sizeof (ndn::Name);
+
+	for (ndn::Name::const_iterator i = name.begin (); i != name.end (); ++i)
+	{
+		bytes += sizeof (ndn::name::Component) + i->size ();
+	}
+
+	return bytes;
+}
+
+uint64_t
+QueueBytes (Ptr<Queue> queue)
+{
+	if (queue == 0)
+	{
+		return 0;
+	}
+
+	return kAggregate + queue->GetNBytes () + queue->GetNPackets () * kPacket;
+}
+
+uint64_t
+RoutingBytes (Ptr<Ipv4RoutingProtocol> routing)
+{
+	if (routing == 0)
+	{
+		return 0;
+	}
+
+	uint64_t bytes = kAggregate;
+
+	Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting> (routing);
+	if (list != 0)
+	{
+		int16_t priority;
+		for (uint32_t i = 0; i < list->GetNRoutingProtocols (); i++)
+		{
+			bytes += RoutingBytes (list->GetRoutingProtocol (i, priority));
+		}
+		return bytes;
+	}
+
+	Ptr<Ipv4StaticRouting> staticRouting = DynamicCast<Ipv4StaticRouting> (routing);
+	if (staticRouting != 0)
+	{
+		bytes += staticRouting->GetNRoutes () * (sizeof (Ipv4RoutingTableEntry) + kAggregate);
+	}
+
+	return bytes;
+}
+
+} // anonymous namespace
+
+MemoryAccounting::Usage::Usage ()
+: nodes (0)
+, node (0)
+, devices (0)
+, queues (0)
+, ipv4 (0)
+, contentStore (0)
+, pit (0)
+, fib (0)
+, apps (0)
+{
+}
+
+MemoryAccounting::Usage &
+MemoryAccounting::Usage::operator += (const Usage &other)
+{
+	nodes += other.nodes;
+	node += other.node;
+	devices += other.devices;
+	queues += other.queues;
+	ipv4 += other.ipv4;
+	contentStore += other.contentStore;
+	pit += other.pit;
+	fib += other.fib;
+	apps += other.apps;
+	return *this;
+}
+
+uint64_t
+MemoryAccounting::Usage::Total (void) const
+{
+	return node + devices + queues + ipv4 + contentStore + pit + fib + apps;
+}
+
+MemoryAccounting::MemoryAccounting ()
+: m_filename ("")
+, m_header (false)
+{
+}
+
+MemoryAccounting::~MemoryAccounting ()
+{
+	if (m_file.is_open ())
+	{
+		m_file.close ();
+	}
+}
+
+void
+MemoryAccounting::SetTier (Ptr<Node> node, const std::string &tier)
+{
+	m_tiers[node->GetId ()] = tier;
+}
+
+void
+MemoryAccounting::SetTier (const NodeContainer &nodes, const std::string &tier)
+{
+	for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+	{
+		SetTier (*i, tier);
+	}
+}
+
+void
+MemoryAccounting::SetOutput (const std::string &filename)
+{
+	if (m_file.is_open ())
+	{
+		m_file.close ();
+	}
+
+	m_filename = filename;
+	m_header = false;
+	m_file.open (filename.c_str (), std::ios::out | std::ios::trunc);
+
+	if (!m_file)
+	{
+		std::cerr << "MemoryAccounting: could not open " << filename
+				<< ", writing to stdout" << std::endl;
+	}
+}
+
+MemoryAccounting::Usage
+MemoryAccounting::Measure (Ptr<Node> node)
+{
+	Usage usage;
+	usage.nodes = 1;
+
+	// The node itself plus whatever is aggregated to it
+	usage.node = sizeof (Node);
+	Object::AggregateIterator aggregates = node->GetAggregateIterator ();
+	while (aggregates.HasNext ())
+	{
+		aggregates.Next ();
+		usage.node += kAggregate;
+	}
+
+	for (uint32_t i = 0; i < node->GetNDevices (); i++)
+	{
+		Ptr<NetDevice> device = node->GetDevice (i);
+
+		Ptr<PointToPointNetDevice> p2p = DynamicCast<PointToPointNetDevice> (device);
+		if (p2p != 0)
+		{
+			// Each channel is shared by two devices, charge half to each
+			usage.devices += sizeof (PointToPointNetDevice) + sizeof (PointToPointChannel) / 2;
+			usage.queues += QueueBytes (p2p->GetQueue ());
+			continue;
+		}
+
+		Ptr<CsmaNetDevice> csma = DynamicCast<CsmaNetDevice> (device);
+		if (csma != 0)
+		{
+			usage.devices += sizeof (CsmaNetDevice);
+			usage.queues += QueueBytes (csma->GetQueue ());
+			continue;
+		}
+
+		usage.devices += kAggregate * 8;
+	}
+
+	Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol> ();
+	if (ipv4 != 0)
+	{
+		usage.ipv4 = sizeof (Ipv4L3Protocol);
+		usage.ipv4 += ipv4->GetNInterfaces () * (sizeof (Ipv4Interface) + sizeof (ArpCache));
+		usage.ipv4 += RoutingBytes (ipv4->GetRoutingProtocol ());
+	}
+
+	Ptr<ndn::L3Protocol> ndn = node->GetObject<ndn::L3Protocol> ();
+	if (ndn != 0)
+	{
+		usage.node += ndn->GetNFaces () * kNdnFace;
+	}
+
+	Ptr<ndn::ContentStore> cs = node->GetObject<ndn::ContentStore> ();
+	if (cs != 0)
+	{
+		usage.contentStore = kAggregate;
+		for (Ptr<ndn::cs::Entry> entry = cs->Begin (); entry != cs->End (); entry = cs->Next (entry))
+		{
+			usage.contentStore += kCsEntry + kTrieNode + NameBytes (entry->GetName ());
+			usage.contentStore += entry->GetData ()->GetPayload ()->GetSize ();
+		}
+	}
+
+	Ptr<ndn::Pit> pit = node->GetObject<ndn::Pit> ();
+	if (pit != 0)
+	{
+		usage.pit = kAggregate;
+		for (Ptr<ndn::pit::Entry> entry = pit->Begin (); entry != pit->End (); entry = pit->Next (entry))
+		{
+			usage.pit += sizeof (ndn::pit::Entry) + kTrieNode + NameBytes (entry->GetPrefix ());
+			usage.pit += (entry->GetIncoming ().size () + entry->GetOutgoing ().size ()) * kFaceRecord;
+		}
+	}
+
+	Ptr<ndn::Fib> fib = node->GetObject<ndn::Fib> ();
+	if (fib != 0)
+	{
+		usage.fib = kAggregate;
+		for (Ptr<ndn::fib::Entry> entry = fib->Begin (); entry != fib->End (); entry = fib->Next (entry))
+		{
+			usage.fib += sizeof (ndn::fib::Entry) + kTrieNode + NameBytes (entry->GetPrefix ());
+			usage.fib += entry->m_faces.size () * kFaceMetric;
+		}
+	}
+
+	usage.apps = node->GetNApplications () * kApplication;
+
+	return usage;
+}
+
+void
+MemoryAccounting::Snapshot (void)
+{
+	std::map<std::string, Usage> usage;
+
+	for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+	{
+		std::map<uint32_t, std::string>::const_iterator tier = m_tiers.find ((*i)->GetId ());
+		usage[tier == m_tiers.end () ? "other" : tier->second] += Measure (*i);
+	}
+
+	if (m_file.is_open ())
+	{
+		Write (m_file, usage);
+	}
+	else
+	{
+		Write (std::cout, usage);
+	}
+}
+
+void
+MemoryAccounting::Write (std::ostream &os, const std::map<std::string, Usage> &usage)
+{
+	if (!m_header)
+	{
+		os << "Time\tTier\tNodes\tNode\tDevices\tQueues\tIpv4\tContentStore\tPit\tFib\tApps\tTotal\tPerNode" << std::endl;
+		m_header = true;
+	}
+
+	double now = Simulator::Now ().ToDouble (Time::S);
+	Usage all;
+
+	for (std::map<std::string, Usage>::const_iterator i = usage.begin (); i != usage.end (); ++i)
+	{
+		const Usage &u = i->second;
+		all += u;
+
+		os << now << "\t" << i->first << "\t" << u.nodes << "\t"
+				<< u.node << "\t" << u.devices << "\t" << u.queues << "\t"
+				<< u.ipv4 << "\t" << u.contentStore << "\t" << u.pit << "\t"
+				<< u.fib << "\t" << u.apps << "\t" << u.Total () << "\t"
+				<< (u.nodes ? u.Total () / u.nodes : 0) << std::endl;
+	}
+
+	os << now << "\tall\t" << all.nodes << "\t"
+			<< all.node << "\t" << all.devices << "\t" << all.queues << "\t"
+			<< all.ipv4 << "\t" << all.contentStore << "\t" << all.pit << "\t"
+			<< all.fib << "\t" << all.apps << "\t" << all.Total () << "\t"
+			<< (all.nodes ? all.Total () / all.nodes : 0) << std::endl;
+}
+
+void
+MemoryAccounting::ScheduleSnapshots (Time start, Time interval)
+{
+	Simulator::Schedule (start, &MemoryAccounting::Periodic, this, interval);
+}
+
+void
+MemoryAccounting::Periodic (Time interval)
+{
+	Snapshot ();
+	Simulator::Schedule (interval, &MemoryAccounting::Periodic, this, interval);
+}
+
+} // namespace ns3
@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * memory-accounting.h
+ *
+ *  Walks the NodeList and estimates how many bytes each subsystem holds,
+ *  grouped by node tier. The numbers are estimates built from object sizes
+ *  and container entry counts, meant to tell which part of a scenario is
+ *  worth shrinking, not to replace a heap profiler.
+ */
+
+#ifndef MEMORY_ACCOUNTING_H_
+#define MEMORY_ACCOUNTING_H_
+
+#include <fstream>
+#include <map>
+#include <string>
+
+#include <ns3-dev/ns3/node.h>
+#include <ns3-dev/ns3/node-container.h>
+#include <ns3-dev/ns3/nstime.h>
+
+namespace ns3 {
+
+class MemoryAccounting
+{
+public:
+	// Byte estimates for one group of nodes
+	struct Usage
+	{
+		Usage ();
+		Usage & operator += (const Usage &other);
+		uint64_t Total (void) const;
+
+		uint32_t nodes;
+		uint64_t node;			// Node objects and their aggregates
+		uint64_t devices;		// NetDevices and channels
+		uint64_t queues;		// Device queues, including queued packets
+		uint64_t ipv4;			// IPv4 stack, interfaces and routing
+		uint64_t contentStore;	// Content store entries and payloads
+		uint64_t pit;			// PIT entries with their face records
+		uint64_t fib;			// FIB entries with their face metrics
+		uint64_t apps;			// Applications
+	};
+
+	MemoryAccounting ();
+	~MemoryAccounting ();
+
+	// Nodes without a tier are reported under "other"
+	void SetTier (Ptr<Node> node, const std::string &tier);
+	void SetTier (const NodeContainer &nodes, const std::string &tier);
+
+	// Output file for the breakdown table. One block of rows per snapshot
+	void SetOutput (const std::string &filename);
+
+	// Takes a snapshot right now
+	void Snapshot (void);
+
+	// Takes a snapshot every interval, starting at start
+	void ScheduleSnapshots (Time start, Time interval);
+
+	// Estimate for a single node
+	static Usage Measure (Ptr<Node> node);
+
+private:
+	void Periodic (Time interval);
+	void Write (std::ostream &os, const std::map<std::string, Usage> &usage);
+
+	std::map<uint32_t, std::string> m_tiers;
+	std::string m_filename;
+	std::ofstream m_file;
+	bool m_header;
+};
+
+} // namespace ns3
+
+#endif /* MEMORY_ACCOUNTING_H_ */
@@ -0,0 +1,228 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * mobility-trace.cc
+ *
+ *  Loads mobility traces and feeds them to WaypointMobilityModels.
+ */
+
+#include "mobility-trace.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include <ns3-dev/ns3/abort.h>
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/node.h>
+#include <ns3-dev/ns3/simulator.h>
+
+NS_LOG_COMPONENT_DEFINE ("MobilityTrace");
+
+namespace ns3 {
+
+namespace {
+
+// Waypoint k is handed over when the terminal reaches waypoint
+// k - kLookahead, so the model always knows the one after its next, even
+// when two share a time
+const uint32_t kLookahead = 2;
+
+} // anonymous namespace
+
+bool
+MobilityTrace::Record::operator< (const Record &other) const
+{
+	return feed < other.feed;
+}
+
+bool
+MobilityTrace::Record::ByTerminal (const Record &a, const Record &b)
+{
+	return a.terminal < b.terminal || (a.terminal == b.terminal && a.at < b.at);
+}
+
+MobilityTrace::MobilityTrace ()
+	: m_next (0)
+{
+}
+
+void
+MobilityTrace::Load (const std::string &filename)
+{
+	std::ifstream file (filename.c_str ());
+	NS_ABORT_MSG_UNLESS (file.is_open (), "Could not open mobility trace " << filename);
+
+	size_t waypoints = m_waypoints.size ();
+	size_t handoffs = m_handoffs.size ();
+
+	std::string line;
+	for (uint32_t number = 1; std::getline (file, line); number++)
+	{
+		std::istringstream in (line);
+		std::string type;
+		if (!(in >> type) || type[0] == '#')
+		{
+			continue;
+		}
+
+		uint32_t terminal;
+		double at;
+		bool ok = false;
+
+		if (type == "w")
+		{
+			Vector position;
+			ok = (bool)(in >> terminal >> at >> position.x >> position.y);
+			if (ok && !(in >> position.z))
+			{
+				position.z = 0.0;
+			}
+			if (ok)
+			{
+				AddWaypoint (terminal, Seconds (at), position);
+			}
+		}
+		else if (type == "h")
+		{
+			uint32_t ap;
+			ok = (bool)(in >> terminal >> at >> ap);
+			if (ok)
+			{
+				AddHandoff (terminal, Seconds (at), ap);
+			}
+		}
+
+		NS_ABORT_MSG_UNLESS (ok, filename << ":" << number << ": expected \"w <terminal> <time> <x> <y> [<z>]\""
+				<< " or \"h <terminal> <time> <ap>\"");
+	}
+
+	NS_LOG_INFO ("Loaded " << m_waypoints.size () - waypoints << " waypoints and "
+			<< m_handoffs.size () - handoffs << " handoffs from " << filename);
+}
+
+void
+MobilityTrace::AddWaypoint (uint32_t terminal, Time at, const Vector &position)
+{
+	NS_ABORT_MSG_UNLESS (m_models.empty (), "Waypoints go before Install ()");
+
+	Record waypoint;
+	waypoint.at = at;
+	waypoint.terminal = terminal;
+	waypoint.position = position;
+	m_waypoints.push_back (waypoint);
+}
+
+void
+MobilityTrace::AddHandoff (uint32_t terminal, Time at, uint32_t ap)
+{
+	Handoff handoff;
+	handoff.at = at;
+	handoff.terminal = terminal;
+	handoff.ap = ap;
+	m_handoffs.push_back (handoff);
+}
+
+void
+MobilityTrace::Install (const NodeContainer &terminals)
+{
+	NS_ABORT_MSG_UNLESS (m_models.empty (), "MobilityTrace installed twice");
+	NS_ABORT_MSG_IF (GetTerminals () > terminals.GetN (), "Mobility trace has " << GetTerminals ()
+			<< " terminals, the scenario " << terminals.GetN ());
+
+	for (uint32_t i = 0; i < terminals.GetN (); i++)
+	{
+		Ptr<WaypointMobilityModel> model = terminals.Get (i)->GetObject<WaypointMobilityModel> ();
+		NS_ABORT_MSG_UNLESS (model != 0, "Terminal " << i << " (node " << terminals.Get (i)->GetId ()
+				<< ") has no WaypointMobilityModel");
+		m_models.push_back (model);
+	}
+
+	// Number the waypoints of each terminal, they are fed as the terminal
+	// reaches the one kLookahead before
+	std::stable_sort (m_waypoints.begin (), m_waypoints.end (), &Record::ByTerminal);
+	for (size_t i = 0, k = 0; i < m_waypoints.size (); i++, k++)
+	{
+		if (i > 0 && m_waypoints[i].terminal != m_waypoints[i - 1].terminal)
+		{
+			k = 0;
+		}
+		m_waypoints[i].feed = (k <= kLookahead) ? Time (0) : m_waypoints[i - kLookahead].at;
+	}
+	std::stable_sort (m_waypoints.begin (), m_waypoints.end ());
+
+	m_next = 0;
+	Feed ();
+
+	NS_LOG_INFO ("Installed " << m_waypoints.size () << " waypoints on " << terminals.GetN () << " terminals");
+}
+
+void
+MobilityTrace::AddHandoffs (HandoffController &controller, uint32_t first) const
+{
+	for (size_t i = 0; i < m_handoffs.size (); i++)
+	{
+		controller.Add (m_handoffs[i].at, first + m_handoffs[i].terminal, m_handoffs[i].ap);
+	}
+}
+
+uint32_t
+MobilityTrace::GetTerminals (void) const
+{
+	uint32_t terminals = 0;
+	for (size_t i = 0; i < m_waypoints.size (); i++)
+	{
+		terminals = std::max (terminals, m_waypoints[i].terminal + 1);
+	}
+	for (size_t i = 0; i < m_handoffs.size (); i++)
+	{
+		terminals = std::max (terminals, m_handoffs[i].terminal + 1);
+	}
+	return terminals;
+}
+
+Time
+MobilityTrace::GetEnd (void) const
+{
+	Time end (0);
+	for (size_t i = 0; i < m_waypoints.size (); i++)
+	{
+		end = std::max (end, m_waypoints[i].at);
+	}
+	for (size_t i = 0; i < m_handoffs.size (); i++)
+	{
+		end = std::max (end, m_handoffs[i].at);
+	}
+	return end;
+}
+
+void
+MobilityTrace::Feed (void)
+{
+	Time now = Simulator::Now ();
+
+	while (m_next < m_waypoints.size () && m_waypoints[m_next].feed <= now)
+	{
+		const Record &waypoint = m_waypoints[m_next++];
+		m_models[waypoint.terminal]->AddWaypoint (Waypoint (waypoint.at, waypoint.position));
+	}
+
+	if (m_next < m_waypoints.size ())
+	{
+		m_event = Simulator::Schedule (m_waypoints[m_next].feed - now, &MobilityTrace::Feed, this);
+	}
+}
+
+} // namespace ns3
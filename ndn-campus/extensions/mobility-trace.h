@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * mobility-trace.h
+ *
+ *  Waypoints and AP handoffs of a fleet of mobile terminals, read from a
+ *  trace file or added by the scenario. The trace is a text file with one
+ *  record per line, times in seconds and positions in meters:
+ *
+ *    # terminal 0 waits under AP 0, then moves to AP 1
+ *    w 0 0.0 0.0 -20.0
+ *    w 0 1.0 0.0 -20.0
+ *    w 0 4.0 30.0 -20.0 0.0
+ *    h 0 0.0 0
+ *    h 0 4.0 1
+ *
+ *  "w <terminal> <time> <x> <y> [<z>]" is a waypoint and
+ *  "h <terminal> <time> <ap>" a handoff, for HandoffController. Terminals
+ *  and APs are indexes into the containers the scenario installs on.
+ *
+ *  The records are kept in one array. Install () only gives each
+ *  WaypointMobilityModel its first few waypoints, the others are handed
+ *  over by a single pending event shortly before they are needed, so the
+ *  models never hold the whole trace.
+ */
+
+#ifndef MOBILITY_TRACE_H_
+#define MOBILITY_TRACE_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <ns3-dev/ns3/event-id.h>
+#include <ns3-dev/ns3/node-container.h>
+#include <ns3-dev/ns3/nstime.h>
+#include <ns3-dev/ns3/vector.h>
+#include <ns3-dev/ns3/waypoint-mobility-model.h>
+
+#include "handoff-controller.h"
+
+namespace ns3 {
+
+class MobilityTrace
+{
+public:
+	MobilityTrace ();
+
+	// Adds the records of a trace file, aborts on a malformed line
+	void Load (const std::string &filename);
+
+	void AddWaypoint (uint32_t terminal, Time at, const Vector &position);
+	void AddHandoff (uint32_t terminal, Time at, uint32_t ap);
+
+	// Feeds the waypoints to the WaypointMobilityModels of terminals. The
+	// trace must live until Simulator::Run () returns
+	void Install (const NodeContainer &terminals);
+
+	// Adds the handoffs to controller, terminal 0 being its terminal first
+	void AddHandoffs (HandoffController &controller, uint32_t first) const;
+
+	// Terminals referenced, time of the last record
+	uint32_t GetTerminals (void) const;
+	Time GetEnd (void) const;
+
+private:
+	struct Record
+	{
+		// When the waypoint is handed to the mobility model
+		Time feed;
+		Time at;
+		uint32_t terminal;
+		Vector position;
+
+		// Feed order
+		bool operator< (const Record &other) const;
+		// Trace order of each terminal
+		static bool ByTerminal (const Record &a, const Record &b);
+	};
+
+	struct Handoff
+	{
+		Time at;
+		uint32_t terminal;
+		uint32_t ap;
+	};
+
+	void Feed (void);
+
+	std::vector<Record> m_waypoints;
+	std::vector<Handoff> m_handoffs;
+	std::vector<Ptr<WaypointMobilityModel> > m_models;
+	size_t m_next;
+	EventId m_event;
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_TRACE_H_ */
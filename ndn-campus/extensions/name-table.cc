@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * name-table.cc
+ *
+ *  Interned NDN names.
+ */
+
+#include "name-table.h"
+
+#include <unordered_map>
+
+#include <ns3-dev/ns3/log.h>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.NameTable");
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+struct Entry
+{
+	Ptr<const Name> name;
+	std::string uri;
+	std::vector<uint8_t> wire;
+	// hashes[n] covers the first n components
+	std::vector<uint32_t> hashes;
+};
+
+// Function statics, so interning works from other static initialisers too
+std::vector<Entry> &
+Entries (void)
+{
+	static std::vector<Entry> entries;
+	return entries;
+}
+
+// Keyed by wire encoding, which is unique per name
+std::unordered_map<std::string, uint32_t> &
+ByWire (void)
+{
+	static std::unordered_map<std::string, uint32_t> byWire;
+	return byWire;
+}
+
+// URIs already seen, so interning the same string does not parse it again
+std::unordered_map<std::string, uint32_t> &
+ByUri (void)
+{
+	static std::unordered_map<std::string, uint32_t> byUri;
+	return byUri;
+}
+
+void
+PutU16 (std::vector<uint8_t> &wire, size_t n)
+{
+	wire.push_back ((uint8_t)n);
+	wire.push_back ((uint8_t)(n >> 8));
+}
+
+// ndnSIM 1.0 name encoding: total length, then length and bytes of each
+// component, all lengths 16 bit little endian as Buffer::Iterator::WriteU16
+// puts them on the wire
+std::vector<uint8_t>
+Encode (const Name &name)
+{
+	size_t length = 0;
+	for (size_t i = 0; i < name.size (); i++)
+	{
+		length += 2 + name.get (i).size ();
+	}
+
+	std::vector<uint8_t> wire;
+	wire.reserve (2 + length);
+	PutU16 (wire, length);
+
+	for (size_t i = 0; i < name.size (); i++)
+	{
+		const name::Component &component = name.get (i);
+		PutU16 (wire, component.size ());
+		wire.insert (wire.end (), component.begin (), component.end ());
+	}
+
+	return wire;
+}
+
+std::vector<uint32_t>
+PrefixHashes (const Name &name)
+{
+	std::vector<uint32_t> hashes (1, 2166136261u);
+
+	for (size_t i = 0; i < name.size (); i++)
+	{
+		uint32_t hash = hashes.back ();
+		const name::Component &component = name.get (i);
+		for (name::Component::const_iterator c = component.begin (); c != component.end (); ++c)
+		{
+			hash = (hash ^ (uint8_t)*c) * 16777619u;
+		}
+
+		hashes.push_back ((hash ^ '/') * 16777619u);
+	}
+
+	return hashes;
+}
+
+const Entry &
+At (uint32_t id)
+{
+	NS_ASSERT_MSG (id < Entries ().size (), "Name id " << id << " was never interned");
+	return Entries ()[id];
+}
+
+} // anonymous namespace
+
+uint32_t
+NameTable::Intern (const std::string &uri)
+{
+	std::unordered_map<std::string, uint32_t>::const_iterator i = ByUri ().find (uri);
+	if (i != ByUri ().end ())
+	{
+		return i->second;
+	}
+
+	uint32_t id = Intern (Name (uri));
+	ByUri ()[uri] = id;
+	return id;
+}
+
+uint32_t
+NameTable::Intern (const Name &name)
+{
+	std::vector<uint8_t> wire = Encode (name);
+	std::string key (wire.begin (), wire.end ());
+
+	std::unordered_map<std::string, uint32_t>::const_iterator i = ByWire ().find (key);
+	if (i != ByWire ().end ())
+	{
+		return i->second;
+	}
+
+	Entry entry;
+	entry.name = Create<Name> (name);
+	entry.uri = name.toUri ();
+	entry.wire.swap (wire);
+	entry.hashes = PrefixHashes (name);
+
+	uint32_t id = Entries ().size ();
+	Entries ().push_back (entry);
+	ByWire ()[key] = id;
+
+	NS_LOG_DEBUG ("Interned " << entry.uri << " as " << id);
+	return id;
+}
+
+uint32_t
+NameTable::Find (const Name &name)
+{
+	std::vector<uint8_t> wire = Encode (name);
+
+	std::unordered_map<std::string, uint32_t>::const_iterator i =
+			ByWire ().find (std::string (wire.begin (), wire.end ()));
+	return (i != ByWire ().end ()) ? i->second : kNone;
+}
+
+Ptr<const Name>
+NameTable::Get (uint32_t id)
+{
+	return At (id).name;
+}
+
+const std::string &
+NameTable::GetUri (uint32_t id)
+{
+	return At (id).uri;
+}
+
+const std::vector<uint8_t> &
+NameTable::GetWire (uint32_t id)
+{
+	return At (id).wire;
+}
+
+uint32_t
+NameTable::GetHash (uint32_t id, size_t components)
+{
+	const Entry &entry = At (id);
+	NS_ASSERT (components < entry.hashes.size ());
+	return entry.hashes[components];
+}
+
+uint32_t
+NameTable::GetSize (void)
+{
+	return Entries ().size ();
+}
+
+void
+NameTable::SetPrefix (AppHelper &helper, uint32_t id)
+{
+	helper.SetAttribute ("Prefix", NameValue (*At (id).name));
+}
+
+} // namespace ndn
+} // namespace ns3
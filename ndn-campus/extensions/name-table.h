@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * name-table.h
+ *
+ *  Interned NDN names. Each distinct name is parsed once and kept once,
+ *  with its ndnSIM wire encoding and the hash of each of its prefixes,
+ *  and is referred to by a small id afterwards. Ids are given out in
+ *  interning order, so the same scenario gets the same ids on every run
+ *  and on every rank.
+ *
+ *  Prefix hashes are the ones NdnCapture::Hash () computes.
+ */
+
+#ifndef NAME_TABLE_H_
+#define NAME_TABLE_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <ns3-dev/ns3/ndnSIM-module.h>
+
+namespace ns3 {
+namespace ndn {
+
+class NameTable
+{
+public:
+	// Returned by Find () for names never interned
+	static const uint32_t kNone = 0xffffffff;
+
+	// Id of the name, interning it if new
+	static uint32_t Intern (const std::string &uri);
+	static uint32_t Intern (const Name &name);
+
+	static uint32_t Find (const Name &name);
+
+	// Parsed name, shared by everyone using the id
+	static Ptr<const Name> Get (uint32_t id);
+	static const std::string &GetUri (uint32_t id);
+
+	// ndnSIM wire encoding of the name
+	static const std::vector<uint8_t> &GetWire (uint32_t id);
+
+	// Hash of the first components components of the name
+	static uint32_t GetHash (uint32_t id, size_t components);
+
+	// Names interned so far
+	static uint32_t GetSize (void);
+
+	// Sets the Prefix attribute of helper to the parsed name, instead of
+	// having every Install () parse the URI again. Interning a server's
+	// prefix once and setting it on each of its consumers and producers
+	// gives all of them the same Name
+	static void SetPrefix (AppHelper &helper, uint32_t id);
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif /* NAME_TABLE_H_ */
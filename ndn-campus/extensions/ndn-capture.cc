@@ -0,0 +1,410 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * ndn-capture.cc
+ *
+ *  Compact NDN packet capture into a ring buffer.
+ */
+
+#include "ndn-capture.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/node-list.h>
+#include <ns3-dev/ns3/simulator.h>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.NdnCapture");
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+const char kMagic[8] = { 'N', 'D', 'N', 'C', 'A', 'P', 0, 1 };
+const uint32_t kVersion = 1;
+const uint32_t kNoFace = 0xffffffff;
+
+// File header, followed by count records
+struct Header
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t recordSize;
+	uint64_t count;
+	uint64_t captured;
+};
+
+} // anonymous namespace
+
+// Connects one node's forwarding strategy to the capture
+class NdnCapture::Probe : public SimpleRefCount<NdnCapture::Probe>
+{
+public:
+	Probe (NdnCapture *capture, uint32_t node)
+	: m_capture (capture)
+	, m_node (node)
+	{
+	}
+
+	void InInterests (Ptr<const Interest> interest, Ptr<const Face> face)
+	{
+		Interests (IN_INTEREST, interest, face);
+	}
+
+	void OutInterests (Ptr<const Interest> interest, Ptr<const Face> face)
+	{
+		Interests (OUT_INTEREST, interest, face);
+	}
+
+	void DropInterests (Ptr<const Interest> interest, Ptr<const Face> face)
+	{
+		Interests (DROP_INTEREST, interest, face);
+	}
+
+	void InData (Ptr<const Data> data, Ptr<const Face> face)
+	{
+		Datas (IN_DATA, data, face, 0);
+	}
+
+	void OutData (Ptr<const Data> data, bool fromCache, Ptr<const Face> face)
+	{
+		Datas (OUT_DATA, data, face, fromCache ? FROM_CACHE : 0);
+	}
+
+	void DropData (Ptr<const Data> data, Ptr<const Face> face)
+	{
+		Datas (DROP_DATA, data, face, 0);
+	}
+
+	void TimedOutInterests (Ptr<const pit::Entry> entry)
+	{
+		m_capture->Timeout (m_node, entry);
+	}
+
+private:
+	void Interests (uint8_t type, Ptr<const Interest> interest, Ptr<const Face> face)
+	{
+		uint32_t faceId = (face != 0) ? face->GetId () : kNoFace;
+		if (!m_capture->Accept (m_node, faceId, interest->GetName ()))
+		{
+			return;
+		}
+
+		m_capture->Capture (m_node, faceId, type, interest->GetName (),
+				interest->GetNonce (), interest->GetPayload (), 0);
+	}
+
+	void Datas (uint8_t type, Ptr<const Data> data, Ptr<const Face> face, uint16_t flags)
+	{
+		uint32_t faceId = (face != 0) ? face->GetId () : kNoFace;
+		if (!m_capture->Accept (m_node, faceId, data->GetName ()))
+		{
+			return;
+		}
+
+		m_capture->Capture (m_node, faceId, type, data->GetName (),
+				0, data->GetPayload (), flags);
+	}
+
+	NdnCapture *m_capture;
+	uint32_t m_node;
+};
+
+NdnCapture::NdnCapture (uint32_t capacity)
+: m_ring (capacity > 0 ? capacity : 1)
+, m_next (0)
+, m_captured (0)
+, m_face (kNoFace)
+, m_threshold (0)
+, m_window (Seconds (1.0))
+, m_lastTrigger (Seconds (0))
+{
+}
+
+NdnCapture::~NdnCapture ()
+{
+}
+
+void
+NdnCapture::AddNode (uint32_t node)
+{
+	m_nodes.insert (node);
+}
+
+void
+NdnCapture::SetFace (uint32_t face)
+{
+	m_face = face;
+}
+
+void
+NdnCapture::SetPrefix (const std::string &prefix)
+{
+	m_prefix = Name (prefix);
+}
+
+void
+NdnCapture::Install (Ptr<Node> node)
+{
+	Ptr<ForwardingStrategy> fw = node->GetObject<ForwardingStrategy> ();
+	if (fw == 0)
+	{
+		NS_LOG_WARN ("Node " << node->GetId () << " has no NDN stack, not capturing");
+		return;
+	}
+
+	Ptr<Probe> probe = Create<Probe> (this, node->GetId ());
+
+	// Nodes the filter rejects only count their timeouts for the trigger,
+	// so the per packet cost stays with the nodes captured
+	fw->TraceConnectWithoutContext ("TimedOutInterests", MakeCallback (&Probe::TimedOutInterests, probe));
+	m_probes.push_back (probe);
+	if (!m_nodes.empty () && m_nodes.find (node->GetId ()) == m_nodes.end ())
+	{
+		return;
+	}
+
+	fw->TraceConnectWithoutContext ("InInterests", MakeCallback (&Probe::InInterests, probe));
+	fw->TraceConnectWithoutContext ("OutInterests", MakeCallback (&Probe::OutInterests, probe));
+	fw->TraceConnectWithoutContext ("DropInterests", MakeCallback (&Probe::DropInterests, probe));
+	fw->TraceConnectWithoutContext ("InData", MakeCallback (&Probe::InData, probe));
+	fw->TraceConnectWithoutContext ("OutData", MakeCallback (&Probe::OutData, probe));
+	fw->TraceConnectWithoutContext ("DropData", MakeCallback (&Probe::DropData, probe));
+}
+
+void
+NdnCapture::Install (const NodeContainer &nodes)
+{
+	for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+	{
+		Install (*i);
+	}
+}
+
+void
+NdnCapture::InstallAll (void)
+{
+	for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+	{
+		Install (*i);
+	}
+}
+
+bool
+NdnCapture::Accept (uint32_t node, uint32_t face, const Name &name) const
+{
+	// Cheapest tests first, this runs for every packet on every node
+	if (!m_nodes.empty () && m_nodes.find (node) == m_nodes.end ())
+	{
+		return false;
+	}
+
+	if (m_face != kNoFace && face != m_face)
+	{
+		return false;
+	}
+
+	if (m_prefix.size () > name.size ())
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < m_prefix.size (); i++)
+	{
+		if (!(m_prefix.get (i) == name.get (i)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void
+NdnCapture::Capture (uint32_t node, uint32_t face, uint8_t type, const Name &name,
+		uint32_t nonce, Ptr<const Packet> payload, uint16_t flags)
+{
+	Record &record = m_ring[m_next];
+
+	record.time = Simulator::Now ().GetNanoSeconds ();
+	record.node = node;
+	record.face = face;
+	record.nonce = nonce;
+	record.type = type;
+	record.hops = 0;
+	record.flags = flags;
+	record.sequence = 0;
+
+	size_t components = name.size ();
+
+	// Consumers put the sequence number as the last component, with a zero marker
+	if (components > 0)
+	{
+		const name::Component &last = name.get (-1);
+		if (last.size () > 1 && last.size () <= 9 && *last.begin () == 0)
+		{
+			try
+			{
+				record.sequence = last.toSeqNum ();
+				record.flags |= HAS_SEQUENCE;
+				components--;
+			}
+			catch (...)
+			{
+			}
+		}
+	}
+
+	record.nameHash = Hash (name, components);
+
+	FwHopCountTag hopCount;
+	if (payload != 0 && payload->PeekPacketTag (hopCount))
+	{
+		record.hops = (hopCount.Get () > 255) ? 255 : hopCount.Get ();
+	}
+
+	m_next = (m_next + 1) % m_ring.size ();
+	m_captured++;
+}
+
+void
+NdnCapture::Timeout (uint32_t node, Ptr<const pit::Entry> entry)
+{
+	// The trigger looks at every node, whatever the filters
+	if (m_threshold > 0)
+	{
+		Time now = Simulator::Now ();
+
+		m_timeouts.push_back (now);
+		while (m_timeouts.front () < now - m_window)
+		{
+			m_timeouts.pop_front ();
+		}
+
+		if (m_timeouts.size () >= m_threshold
+				&& (m_lastTrigger.IsZero () || now - m_lastTrigger >= m_window))
+		{
+			char filename[250];
+			sprintf (filename, "%s-%.3f.ndncap", m_triggerPrefix.c_str (), now.GetSeconds ());
+
+			NS_LOG_INFO (m_timeouts.size () << " timeouts within " << m_window.GetSeconds ()
+					<< "s, dumping to " << filename);
+
+			Dump (filename);
+			m_lastTrigger = now;
+		}
+	}
+
+	if (!Accept (node, kNoFace, entry->GetPrefix ()))
+	{
+		return;
+	}
+
+	Capture (node, kNoFace, TIMEOUT, entry->GetPrefix (), 0, 0, 0);
+}
+
+bool
+NdnCapture::Dump (const std::string &filename) const
+{
+	std::ofstream out (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+
+	if (!out)
+	{
+		std::cerr << "NdnCapture: could not open " << filename << std::endl;
+		return false;
+	}
+
+	Header header;
+	std::copy (kMagic, kMagic + sizeof (kMagic), header.magic);
+	header.version = kVersion;
+	header.recordSize = sizeof (Record);
+	header.count = GetSize ();
+	header.captured = m_captured;
+
+	out.write ((const char *)&header, sizeof (header));
+
+	// Once the ring has wrapped the oldest record is the next to be overwritten
+	if (m_captured > m_ring.size ())
+	{
+		out.write ((const char *)&m_ring[m_next], (m_ring.size () - m_next) * sizeof (Record));
+	}
+	out.write ((const char *)&m_ring[0], ((m_captured > m_ring.size ()) ? m_next : header.count) * sizeof (Record));
+
+	return true;
+}
+
+void
+NdnCapture::SetTimeoutTrigger (uint32_t threshold, Time window, const std::string &prefix)
+{
+	m_threshold = threshold;
+	m_window = window;
+	m_triggerPrefix = prefix;
+}
+
+void
+NdnCapture::DumpAtEnd (const std::string &filename)
+{
+	if (m_endFile.empty ())
+	{
+		Simulator::ScheduleDestroy (&NdnCapture::Finish, this);
+	}
+
+	m_endFile = filename;
+}
+
+void
+NdnCapture::Finish (void)
+{
+	NS_LOG_INFO ("Captured " << m_captured << " packets, dumping " << GetSize () << " to " << m_endFile);
+	Dump (m_endFile);
+}
+
+uint64_t
+NdnCapture::GetCaptured (void) const
+{
+	return m_captured;
+}
+
+uint32_t
+NdnCapture::GetSize (void) const
+{
+	return (m_captured < m_ring.size ()) ? m_captured : m_ring.size ();
+}
+
+uint32_t
+NdnCapture::Hash (const Name &name, size_t components)
+{
+	uint32_t hash = 2166136261u;
+
+	for (size_t i = 0; i < components; i++)
+	{
+		const name::Component &component = name.get (i);
+		for (name::Component::const_iterator c = component.begin (); c != component.end (); ++c)
+		{
+			hash = (hash ^ (uint8_t)*c) * 16777619u;
+		}
+
+		// Component boundary, so /ab/c and /a/bc differ
+		hash = (hash ^ '/') * 16777619u;
+	}
+
+	return hash;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * ndn-capture.h
+ *
+ *  Compact NDN packet capture. Instead of whole packets, only the NDN
+ *  header fields are kept (type, name hash, nonce, sequence number, hop
+ *  count), as fixed size records in a ring buffer that holds the most
+ *  recent traffic. The buffer is written out on demand, when Interest
+ *  timeouts spike, or at the end of the run. ndncap.py prints dump files.
+ */
+
+#ifndef NDN_CAPTURE_H_
+#define NDN_CAPTURE_H_
+
+#include <list>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <ns3-dev/ns3/node.h>
+#include <ns3-dev/ns3/node-container.h>
+#include <ns3-dev/ns3/nstime.h>
+#include <ns3-dev/ns3/ndnSIM-module.h>
+
+namespace ns3 {
+namespace ndn {
+
+class NdnCapture
+{
+public:
+	enum Type
+	{
+		IN_INTEREST = 1,
+		OUT_INTEREST,
+		DROP_INTEREST,
+		IN_DATA,
+		OUT_DATA,
+		DROP_DATA,
+		TIMEOUT
+	};
+
+	enum Flags
+	{
+		FROM_CACHE = 1,		// Data answered from the content store
+		HAS_SEQUENCE = 2	// Last name component was a sequence number
+	};
+
+	// One captured packet, 32 bytes on disk
+	struct Record
+	{
+		int64_t time;		// Nanoseconds
+		uint32_t node;
+		uint32_t face;		// Face id, 0xffffffff if none
+		uint32_t nameHash;	// FNV-1a of the name without the sequence number
+		uint32_t nonce;		// Interests only
+		uint32_t sequence;
+		uint8_t type;
+		uint8_t hops;
+		uint16_t flags;
+	};
+
+	// capacity is the number of records kept
+	NdnCapture (uint32_t capacity = 1 << 20);
+	~NdnCapture ();
+
+	// Filters, all pass by default. Several nodes may be given, before
+	// installing: other nodes are then only followed for their timeouts
+	void AddNode (uint32_t node);
+	void SetFace (uint32_t face);
+	void SetPrefix (const std::string &prefix);
+
+	// Attaches to the forwarding strategies. Nodes need the NDN stack
+	void Install (Ptr<Node> node);
+	void Install (const NodeContainer &nodes);
+	void InstallAll (void);
+
+	// Writes the buffer, oldest record first. The buffer is kept
+	bool Dump (const std::string &filename) const;
+
+	// Dumps to prefix-<sim time>.ndncap whenever threshold Interests time
+	// out within window. At most one dump per window
+	void SetTimeoutTrigger (uint32_t threshold, Time window, const std::string &prefix);
+
+	// Dumps to filename when the simulator is destroyed
+	void DumpAtEnd (const std::string &filename);
+
+	uint64_t GetCaptured (void) const;
+	uint32_t GetSize (void) const;
+
+	// FNV-1a over the name components, as stored in nameHash
+	static uint32_t Hash (const Name &name, size_t components);
+
+private:
+	class Probe;
+	friend class Probe;
+
+	bool Accept (uint32_t node, uint32_t face, const Name &name) const;
+	void Capture (uint32_t node, uint32_t face, uint8_t type, const Name &name,
+			uint32_t nonce, Ptr<const Packet> payload, uint16_t flags);
+	void Timeout (uint32_t node, Ptr<const pit::Entry> entry);
+	void Finish (void);
+
+	std::vector<Record> m_ring;
+	uint32_t m_next;
+	uint64_t m_captured;
+
+	std::set<uint32_t> m_nodes;
+	uint32_t m_face;
+	Name m_prefix;
+
+	uint32_t m_threshold;
+	Time m_window;
+	std::string m_triggerPrefix;
+	std::list<Time> m_timeouts;
+	Time m_lastTrigger;
+
+	std::string m_endFile;
+	std::list<Ptr<Probe> > m_probes;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif /* NDN_CAPTURE_H_ */
@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * phase-timer.cc
+ *
+ *  Wall clock timing of scenario phases.
+ */
+
+#include "phase-timer.h"
+
+#include <fstream>
+#include <sstream>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <ns3-dev/ns3/global-value.h>
+#include <ns3-dev/ns3/uinteger.h>
+
+namespace ns3 {
+
+PhaseTimer::PhaseTimer (const std::string &scenario)
+: m_scenario (scenario)
+, m_created (Now ())
+, m_started (0)
+, m_current ("")
+{
+}
+
+void
+PhaseTimer::SetParameter (const std::string &name, const std::string &value)
+{
+	m_parameters.push_back (std::make_pair (name, Quote (value)));
+}
+
+void
+PhaseTimer::SetParameter (const std::string &name, double value)
+{
+	std::ostringstream os;
+	os.precision (15);
+	os << value;
+	m_parameters.push_back (std::make_pair (name, os.str ()));
+}
+
+void
+PhaseTimer::Begin (const std::string &phase)
+{
+	End ();
+	m_current = phase;
+	m_started = Now ();
+}
+
+void
+PhaseTimer::End (void)
+{
+	if (m_current.empty ())
+	{
+		return;
+	}
+
+	m_phases.push_back (std::make_pair (m_current, Now () - m_started));
+	m_current = "";
+}
+
+double
+PhaseTimer::GetElapsed (const std::string &phase) const
+{
+	double elapsed = 0;
+
+	// A phase may be entered more than once
+	for (size_t i = 0; i < m_phases.size (); i++)
+	{
+		if (m_phases[i].first == phase)
+		{
+			elapsed += m_phases[i].second;
+		}
+	}
+
+	return elapsed;
+}
+
+double
+PhaseTimer::GetTotal (void) const
+{
+	return Now () - m_created;
+}
+
+void
+PhaseTimer::Print (std::ostream &os) const
+{
+	os << "-----" << std::endl << "Runtime Stats:" << std::endl;
+
+	for (size_t i = 0; i < m_phases.size (); i++)
+	{
+		os << "  " << m_phases[i].first << ": " << m_phases[i].second << " s" << std::endl;
+	}
+
+	os << "Total elapsed time: " << GetTotal () << " s" << std::endl;
+}
+
+bool
+PhaseTimer::Write (const std::string &filename) const
+{
+	std::ofstream out (filename.c_str (), std::ios::out | std::ios::app);
+
+	if (!out)
+	{
+		std::cerr << "PhaseTimer: could not open " << filename << std::endl;
+		return false;
+	}
+
+	UintegerValue run;
+	GlobalValue::GetValueByName ("RngRun", run);
+
+	std::ostringstream os;
+	os.precision (9);
+
+	os << "{\"scenario\": " << Quote (m_scenario)
+			<< ", \"start\": " << std::fixed << m_created
+			<< ", \"pid\": " << getpid ()
+			<< ", \"rngrun\": " << run.Get ();
+
+	os << ", \"parameters\": {";
+	for (size_t i = 0; i < m_parameters.size (); i++)
+	{
+		os << (i ? ", " : "") << Quote (m_parameters[i].first) << ": " << m_parameters[i].second;
+	}
+
+	os << "}, \"phases\": {";
+	for (size_t i = 0; i < m_phases.size (); i++)
+	{
+		os << (i ? ", " : "") << Quote (m_phases[i].first) << ": " << m_phases[i].second;
+	}
+
+	os << "}, \"total\": " << GetTotal () << "}";
+
+	out << os.str () << std::endl;
+	return true;
+}
+
+double
+PhaseTimer::Now (void)
+{
+	struct timeval t;
+	gettimeofday (&t, NULL);
+	return (double)t.tv_sec + t.tv_usec * 1e-6;
+}
+
+std::string
+PhaseTimer::Quote (const std::string &str)
+{
+	std::string quoted = "\"";
+
+	for (size_t i = 0; i < str.size (); i++)
+	{
+		if (str[i] == '"' || str[i] == '\\')
+		{
+			quoted += '\\';
+		}
+		quoted += str[i];
+	}
+
+	return quoted + "\"";
+}
+
+} // namespace ns3
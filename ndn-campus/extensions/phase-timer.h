@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * phase-timer.h
+ *
+ *  Wall clock timing of the phases of a scenario run (topology build, stack
+ *  install, route computation, app install, run, teardown). Each run is
+ *  appended as one JSON record, together with the run parameters, so whole
+ *  sweeps can be analysed for setup versus run cost.
+ */
+
+#ifndef PHASE_TIMER_H_
+#define PHASE_TIMER_H_
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+class PhaseTimer
+{
+public:
+	PhaseTimer (const std::string &scenario);
+
+	// Run parameters recorded along with the timings
+	void SetParameter (const std::string &name, const std::string &value);
+	void SetParameter (const std::string &name, double value);
+
+	// Ends the running phase, if any, and starts a new one
+	void Begin (const std::string &phase);
+
+	// Ends the running phase
+	void End (void);
+
+	// Seconds spent in phase, 0 if it never ran
+	double GetElapsed (const std::string &phase) const;
+
+	// Seconds since the timer was created
+	double GetTotal (void) const;
+
+	// Human readable summary
+	void Print (std::ostream &os) const;
+
+	// Appends the run as a single line JSON record to filename
+	bool Write (const std::string &filename) const;
+
+private:
+	static double Now (void);
+	static std::string Quote (const std::string &str);
+
+	std::string m_scenario;
+	double m_created;
+	double m_started;
+	std::string m_current;
+
+	// Kept in insertion order for the record
+	std::vector<std::pair<std::string, std::string> > m_parameters;
+	std::vector<std::pair<std::string, double> > m_phases;
+};
+
+} // namespace ns3
+
+#endif /* PHASE_TIMER_H_ */
@@ -0,0 +1,413 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * placement-content-store.cc
+ *
+ *  Cache placement decisions on the Data path.
+ */
+
+#include "placement-content-store.h"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include <ns3-dev/ns3/channel.h>
+#include <ns3-dev/ns3/double.h>
+#include <ns3-dev/ns3/enum.h>
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/node.h>
+#include <ns3-dev/ns3/string.h>
+
+#include "ndn-capture.h"
+#include "placement-tag.h"
+
+NS_LOG_COMPONENT_DEFINE ("ndn.cs.Placement");
+
+namespace ns3 {
+namespace ndn {
+namespace cs {
+
+namespace {
+
+// Interests whose Data never came back are forgotten past this many
+const size_t kMaxPending = 65536;
+
+struct Hop
+{
+	uint16_t hops;
+	double centrality;
+};
+
+} // anonymous namespace
+
+// Hops of the Interests waiting for their Data, by name hash
+struct Placement::Pending
+{
+	std::unordered_map<uint32_t, Hop> hops;
+};
+
+NS_OBJECT_ENSURE_REGISTERED (Placement);
+
+TypeId
+Placement::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::ndn::cs::Placement")
+		.SetGroupName ("Ndn")
+		.SetParent<ContentStore> ()
+		.AddConstructor<Placement> ()
+		.AddAttribute ("Store",
+				"Content store keeping the Data placed here, with its attributes",
+				StringValue ("ns3::ndn::cs::Lru"),
+				MakeObjectFactoryAccessor (&Placement::m_storeFactory),
+				MakeObjectFactoryChecker ())
+		.AddAttribute ("Decision",
+				"Nodes of the Data path that keep a copy: Always, Lcd, ProbCache or Betweenness",
+				EnumValue (Placement::ALWAYS),
+				MakeEnumAccessor (&Placement::m_decision),
+				MakeEnumChecker (Placement::ALWAYS, "Always",
+						Placement::LCD, "Lcd",
+						Placement::PROB_CACHE, "ProbCache",
+						Placement::BETWEENNESS, "Betweenness"))
+		.AddAttribute ("TargetWindow",
+				"ProbCache target time window, in caches a Data should fill on its path",
+				DoubleValue (10.0),
+				MakeDoubleAccessor (&Placement::m_targetWindow),
+				MakeDoubleChecker<double> (1.0))
+		.AddAttribute ("Centrality",
+				"Betweenness centrality of the node, see ComputeCentralities ()",
+				DoubleValue (0.0),
+				MakeDoubleAccessor (&Placement::m_centrality),
+				MakeDoubleChecker<double> (0.0))
+		;
+	return tid;
+}
+
+Placement::Placement ()
+	: m_decision (ALWAYS)
+	, m_targetWindow (10.0)
+	, m_centrality (0.0)
+	, m_random (CreateObject<UniformRandomVariable> ())
+	, m_pending (new Pending)
+{
+}
+
+Placement::~Placement ()
+{
+	delete m_pending;
+}
+
+void
+Placement::NotifyConstructionCompleted (void)
+{
+	m_store = m_storeFactory.Create<ContentStore> ();
+	ContentStore::NotifyConstructionCompleted ();
+}
+
+void
+Placement::DoDispose (void)
+{
+	if (m_store != 0)
+	{
+		m_store->Dispose ();
+		m_store = 0;
+	}
+	m_pending->hops.clear ();
+	ContentStore::DoDispose ();
+}
+
+Ptr<Data>
+Placement::Lookup (Ptr<const Interest> interest)
+{
+	// One more hop from the requester, and the most central node so far
+	Ptr<Packet> payload = ConstCast<Packet> (interest->GetPayload ());
+	PlacementTag tag;
+	payload->RemovePacketTag (tag);
+	tag.SetHops (tag.GetHops () + 1);
+	tag.SetCentrality (std::max (tag.GetCentrality (), m_centrality));
+	payload->AddPacketTag (tag);
+	// The faces forward the wire the Interest was received as, drop it so
+	// the new tag goes out with the payload
+	interest->SetWire (0);
+
+	Ptr<Data> data = m_store->Lookup (interest);
+	if (data == 0)
+	{
+		if (m_pending->hops.size () >= kMaxPending)
+		{
+			m_pending->hops.clear ();
+		}
+
+		Hop &hop = m_pending->hops[NdnCapture::Hash (interest->GetName (), interest->GetName ().size ())];
+		hop.hops = tag.GetHops ();
+		hop.centrality = tag.GetCentrality ();
+
+		m_cacheMissesTrace (interest);
+		return 0;
+	}
+
+	// This node is the source of the Data from here on. The payload is
+	// shared with the stored Data, the tag goes on a copy, and setting it
+	// drops the stored wire
+	Ptr<Packet> copy = data->GetPayload ()->Copy ();
+	PlacementTag stale;
+	copy->RemovePacketTag (stale);
+	copy->AddPacketTag (PlacementTag ());
+	data->SetPayload (copy);
+
+	m_cacheHitsTrace (interest, data);
+	return data;
+}
+
+bool
+Placement::Add (Ptr<const Data> data)
+{
+	Ptr<Packet> payload = ConstCast<Packet> (data->GetPayload ());
+	PlacementTag tag;
+	bool tagged = payload->RemovePacketTag (tag);
+
+	Hop hop;
+	std::unordered_map<uint32_t, Hop>::iterator i = m_pending->hops.find (NdnCapture::Hash (data->GetName (),
+			data->GetName ().size ()));
+	bool pending = i != m_pending->hops.end ();
+	if (pending)
+	{
+		hop = i->second;
+		m_pending->hops.erase (i);
+	}
+	else
+	{
+		hop.hops = 1;
+		hop.centrality = m_centrality;
+	}
+
+	// Not travelling down a path
+	if (!tagged && !pending)
+	{
+		return m_store->Add (data);
+	}
+
+	// Hops from the source, x, and from the requester, y. Untagged Data
+	// comes from a producer on this node, which is the source
+	uint16_t x = tagged ? tag.GetHops () + 1 : 0;
+	uint16_t y = hop.hops;
+
+	bool keep = true;
+	switch (m_decision)
+	{
+	case LCD:
+		keep = (x == 1);
+		break;
+	case PROB_CACHE:
+		// The path is c = x + y - 1 hops long, since the requester's node
+		// is at y = 1 and the source at x = 0. A path of one node has no
+		// hops, and its CacheWeight x / c is taken as x
+		keep = m_random->GetValue () < (y / m_targetWindow) * ((double)x / std::max (x + y - 1, 1));
+		break;
+	case BETWEENNESS:
+		keep = !tag.IsPlaced () && m_centrality >= std::max (hop.centrality, tag.GetCentrality ());
+		break;
+	default:
+		break;
+	}
+
+	NS_LOG_DEBUG (data->GetName () << " x=" << x << " y=" << y << (keep ? " kept" : " passed"));
+
+	tag.SetHops (x);
+	tag.SetCentrality (std::max (tag.GetCentrality (), m_centrality));
+	tag.SetPlaced (tag.IsPlaced () || (keep && m_decision == BETWEENNESS));
+	payload->AddPacketTag (tag);
+	data->SetWire (0);
+
+	return keep && m_store->Add (data);
+}
+
+void
+Placement::Print (std::ostream &os) const
+{
+	m_store->Print (os);
+}
+
+uint32_t
+Placement::GetSize () const
+{
+	return m_store->GetSize ();
+}
+
+Ptr<Entry>
+Placement::Begin ()
+{
+	return m_store->Begin ();
+}
+
+Ptr<Entry>
+Placement::End ()
+{
+	return m_store->End ();
+}
+
+Ptr<Entry>
+Placement::Next (Ptr<Entry> entry)
+{
+	return m_store->Next (entry);
+}
+
+Ptr<ContentStore>
+Placement::GetStore (void) const
+{
+	return m_store;
+}
+
+void
+Placement::SetCentrality (double centrality)
+{
+	m_centrality = centrality;
+}
+
+double
+Placement::GetCentrality (void) const
+{
+	return m_centrality;
+}
+
+void
+Placement::ComputeCentralities (const NodeContainer &nodes)
+{
+	std::map<uint32_t, uint32_t> index;
+	std::vector<Ptr<Node> > list;
+	for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+	{
+		if ((*i)->GetObject<L3Protocol> () != 0)
+		{
+			index[(*i)->GetId ()] = list.size ();
+			list.push_back (*i);
+		}
+	}
+
+	// Neighbours over every channel an NDN face sits on
+	uint32_t n = list.size ();
+	std::vector<std::vector<uint32_t> > neighbours (n);
+	for (uint32_t v = 0; v < n; v++)
+	{
+		Ptr<L3Protocol> l3 = list[v]->GetObject<L3Protocol> ();
+		for (uint32_t f = 0; f < l3->GetNFaces (); f++)
+		{
+			Ptr<NetDeviceFace> face = DynamicCast<NetDeviceFace> (l3->GetFace (f));
+			if (face == 0 || face->GetNetDevice ()->GetChannel () == 0)
+			{
+				continue;
+			}
+
+			Ptr<Channel> channel = face->GetNetDevice ()->GetChannel ();
+			for (uint32_t d = 0; d < channel->GetNDevices (); d++)
+			{
+				std::map<uint32_t, uint32_t>::iterator w = index.find (channel->GetDevice (d)->GetNode ()->GetId ());
+				if (w != index.end () && w->second != v)
+				{
+					neighbours[v].push_back (w->second);
+				}
+			}
+		}
+
+		std::sort (neighbours[v].begin (), neighbours[v].end ());
+		neighbours[v].erase (std::unique (neighbours[v].begin (), neighbours[v].end ()), neighbours[v].end ());
+	}
+
+	// Brandes, one breadth first search per source
+	std::vector<double> centrality (n, 0.0);
+	std::vector<std::vector<uint32_t> > parents (n);
+	std::vector<double> paths (n, 0.0);
+	std::vector<double> dependency (n, 0.0);
+	std::vector<int> distance (n, -1);
+	std::vector<uint32_t> order;
+	std::deque<uint32_t> queue;
+
+	for (uint32_t s = 0; s < n; s++)
+	{
+		for (size_t k = 0; k < order.size (); k++)
+		{
+			parents[order[k]].clear ();
+			paths[order[k]] = 0.0;
+			dependency[order[k]] = 0.0;
+			distance[order[k]] = -1;
+		}
+		order.clear ();
+
+		paths[s] = 1.0;
+		distance[s] = 0;
+		queue.push_back (s);
+
+		while (!queue.empty ())
+		{
+			uint32_t v = queue.front ();
+			queue.pop_front ();
+			order.push_back (v);
+
+			for (size_t k = 0; k < neighbours[v].size (); k++)
+			{
+				uint32_t w = neighbours[v][k];
+				if (distance[w] < 0)
+				{
+					distance[w] = distance[v] + 1;
+					queue.push_back (w);
+				}
+				if (distance[w] == distance[v] + 1)
+				{
+					paths[w] += paths[v];
+					parents[w].push_back (v);
+				}
+			}
+		}
+
+		for (size_t k = order.size (); k-- > 0;)
+		{
+			uint32_t w = order[k];
+			for (size_t p = 0; p < parents[w].size (); p++)
+			{
+				uint32_t v = parents[w][p];
+				dependency[v] += paths[v] / paths[w] * (1.0 + dependency[w]);
+			}
+			if (w != s)
+			{
+				centrality[w] += dependency[w];
+			}
+		}
+	}
+
+	double highest = 0.0;
+	for (uint32_t v = 0; v < n; v++)
+	{
+		highest = std::max (highest, centrality[v]);
+	}
+
+	uint32_t stores = 0;
+	for (uint32_t v = 0; v < n; v++)
+	{
+		Ptr<Placement> store = DynamicCast<Placement> (list[v]->GetObject<ContentStore> ());
+		if (store != 0)
+		{
+			store->SetCentrality (highest > 0.0 ? centrality[v] / highest : 0.0);
+			stores++;
+		}
+	}
+
+	NS_LOG_INFO ("Betweenness of " << n << " nodes, " << stores << " Placement stores");
+}
+
+} // namespace cs
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * placement-content-store.h
+ *
+ *  Content store deciding which nodes on the Data path keep a copy, in
+ *  front of any other store doing the replacement:
+ *
+ *   - Always, every node, as a plain store does.
+ *   - Lcd, leave copy down: only the node right below the producer or the
+ *     cache that answered, so popular Data moves one hop closer to the
+ *     requesters on each hit.
+ *   - ProbCache: a node x hops below the source and y above the requester
+ *     keeps it with probability y / TargetWindow * x / c, with c = x + y - 1
+ *     the hops of the path, ProbCache with the same capacity on every node.
+ *   - Betweenness: only the node with the highest betweenness centrality on
+ *     the path, the first one down if several share it. Set the
+ *     centralities with ComputeCentralities () once the stack is installed.
+ *
+ *  The hops come from a PlacementTag on the packets: Lookup () counts the
+ *  hops of each Interest and remembers them until its Data comes back,
+ *  Add () counts the hops of the Data and decides. Both drop the wire the
+ *  packet was received as, so the faces encode it again with the new tag.
+ *  Data of a producer on the node is at hop 0, the next node down at hop 1.
+ *  Data added with neither tag nor pending Interest, as a CsCheckpoint
+ *  loads it, is always kept.
+ *
+ *    ndnHelper.SetContentStore ("ns3::ndn::cs::Placement",
+ *        "Store", "ns3::ndn::cs::Lru[MaxSize=1000]", "Decision", "Lcd");
+ */
+
+#ifndef PLACEMENT_CONTENT_STORE_H_
+#define PLACEMENT_CONTENT_STORE_H_
+
+#include <ostream>
+#include <stdint.h>
+
+#include <ns3-dev/ns3/node-container.h>
+#include <ns3-dev/ns3/object-factory.h>
+#include <ns3-dev/ns3/random-variable-stream.h>
+#include <ns3-dev/ns3/ndnSIM-module.h>
+
+namespace ns3 {
+namespace ndn {
+namespace cs {
+
+class Placement : public ContentStore
+{
+public:
+	enum Decision
+	{
+		ALWAYS,
+		LCD,
+		PROB_CACHE,
+		BETWEENNESS
+	};
+
+	static TypeId GetTypeId (void);
+
+	Placement ();
+	virtual ~Placement ();
+
+	virtual Ptr<Data> Lookup (Ptr<const Interest> interest);
+	virtual bool Add (Ptr<const Data> data);
+	virtual void Print (std::ostream &os) const;
+	virtual uint32_t GetSize () const;
+
+	virtual Ptr<Entry> Begin ();
+	virtual Ptr<Entry> End ();
+	virtual Ptr<Entry> Next (Ptr<Entry> entry);
+
+	// Store holding the Data kept
+	Ptr<ContentStore> GetStore (void) const;
+
+	// Betweenness centrality of the node, in [0, 1]
+	void SetCentrality (double centrality);
+	double GetCentrality (void) const;
+
+	// Sets the betweenness centrality of the Placement stores among nodes,
+	// over the links between nodes with the NDN stack, the most central
+	// one getting 1
+	static void ComputeCentralities (const NodeContainer &nodes);
+
+protected:
+	virtual void NotifyConstructionCompleted (void);
+	virtual void DoDispose (void);
+
+private:
+	struct Pending;
+
+	ObjectFactory m_storeFactory;
+	Ptr<ContentStore> m_store;
+	Decision m_decision;
+	double m_targetWindow;
+	double m_centrality;
+	Ptr<UniformRandomVariable> m_random;
+	Pending *m_pending;
+};
+
+} // namespace cs
+} // namespace ndn
+} // namespace ns3
+
+#endif /* PLACEMENT_CONTENT_STORE_H_ */
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * placement-tag.cc
+ *
+ *  Hop and centrality tag of the Placement content stores.
+ */
+
+#include "placement-tag.h"
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED (PlacementTag);
+
+TypeId
+PlacementTag::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::ndn::PlacementTag")
+		.SetParent<Tag> ()
+		.AddConstructor<PlacementTag> ()
+		;
+	return tid;
+}
+
+TypeId
+PlacementTag::GetInstanceTypeId (void) const
+{
+	return GetTypeId ();
+}
+
+PlacementTag::PlacementTag ()
+	: m_hops (0)
+	, m_centrality (0.0)
+	, m_placed (false)
+{
+}
+
+uint16_t
+PlacementTag::GetHops (void) const
+{
+	return m_hops;
+}
+
+void
+PlacementTag::SetHops (uint16_t hops)
+{
+	m_hops = hops;
+}
+
+double
+PlacementTag::GetCentrality (void) const
+{
+	return m_centrality;
+}
+
+void
+PlacementTag::SetCentrality (double centrality)
+{
+	m_centrality = centrality;
+}
+
+bool
+PlacementTag::IsPlaced (void) const
+{
+	return m_placed;
+}
+
+void
+PlacementTag::SetPlaced (bool placed)
+{
+	m_placed = placed;
+}
+
+uint32_t
+PlacementTag::GetSerializedSize (void) const
+{
+	return sizeof (uint16_t) + sizeof (double) + sizeof (uint8_t);
+}
+
+void
+PlacementTag::Serialize (TagBuffer i) const
+{
+	i.WriteU16 (m_hops);
+	i.WriteDouble (m_centrality);
+	i.WriteU8 (m_placed);
+}
+
+void
+PlacementTag::Deserialize (TagBuffer i)
+{
+	m_hops = i.ReadU16 ();
+	m_centrality = i.ReadDouble ();
+	m_placed = i.ReadU8 () != 0;
+}
+
+void
+PlacementTag::Print (std::ostream &os) const
+{
+	os << "hops=" << m_hops << " centrality=" << m_centrality << (m_placed ? " placed" : "");
+}
+
+} // namespace ndn
+} // namespace ns3
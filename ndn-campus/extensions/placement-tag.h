@@ -0,0 +1,67 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * placement-tag.h
+ *
+ *  Packet tag the Placement content stores keep on the payload of the
+ *  Interests and Data they see. On an Interest it counts the hops from the
+ *  requester, on a Data the hops from the producer or from the cache that
+ *  answered, each with the highest centrality among the nodes counted.
+ */
+
+#ifndef PLACEMENT_TAG_H_
+#define PLACEMENT_TAG_H_
+
+#include <ostream>
+#include <stdint.h>
+
+#include <ns3-dev/ns3/tag.h>
+
+namespace ns3 {
+namespace ndn {
+
+class PlacementTag : public Tag
+{
+public:
+	static TypeId GetTypeId (void);
+	virtual TypeId GetInstanceTypeId (void) const;
+
+	PlacementTag ();
+
+	uint16_t GetHops (void) const;
+	void SetHops (uint16_t hops);
+
+	double GetCentrality (void) const;
+	void SetCentrality (double centrality);
+
+	// On Data, a node up the path already cached it for its centrality
+	bool IsPlaced (void) const;
+	void SetPlaced (bool placed);
+
+	virtual uint32_t GetSerializedSize (void) const;
+	virtual void Serialize (TagBuffer i) const;
+	virtual void Deserialize (TagBuffer i);
+	virtual void Print (std::ostream &os) const;
+
+private:
+	uint16_t m_hops;
+	double m_centrality;
+	bool m_placed;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif /* PLACEMENT_TAG_H_ */
@@ -0,0 +1,335 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * producer-mobility.cc
+ *
+ *  FIB entries following mobile producers from AP to AP.
+ */
+
+#include "producer-mobility.h"
+
+#include <algorithm>
+#include <deque>
+#include <set>
+
+#include <ns3-dev/ns3/abort.h>
+#include <ns3-dev/ns3/channel.h>
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/node.h>
+#include <ns3-dev/ns3/simulator.h>
+#include <ns3-dev/ns3/wifi-net-device.h>
+
+#include "name-table.h"
+#include "unit-disk-net-device.h"
+
+NS_LOG_COMPONENT_DEFINE ("ndn.ProducerMobility");
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+bool
+IsWireless (Ptr<NetDevice> device)
+{
+	return DynamicCast<WifiNetDevice> (device) != 0 || DynamicCast<UnitDiskNetDevice> (device) != 0;
+}
+
+} // anonymous namespace
+
+ProducerMobility::ProducerMobility (const std::string &prefix)
+	: m_prefix (NameTable::Get (NameTable::Intern (prefix)))
+	, m_handoffs (0)
+	, m_updates (0)
+{
+}
+
+void
+ProducerMobility::AddRouters (const NodeContainer &routers)
+{
+	m_routers.Add (routers);
+}
+
+void
+ProducerMobility::AddAnchors (const NodeContainer &anchors)
+{
+	m_anchors.Add (anchors);
+}
+
+uint32_t
+ProducerMobility::AddAp (Ptr<NetDevice> device)
+{
+	m_aps.push_back (device);
+	return m_aps.size () - 1;
+}
+
+uint32_t
+ProducerMobility::AddAps (const NetDeviceContainer &devices)
+{
+	uint32_t first = m_aps.size ();
+	for (NetDeviceContainer::Iterator i = devices.Begin (); i != devices.End (); ++i)
+	{
+		AddAp (*i);
+	}
+	return first;
+}
+
+void
+ProducerMobility::AddProducer (uint32_t terminal)
+{
+	Producer producer;
+	producer.ap = kNoAp;
+	producer.generation = 0;
+	m_producers[terminal] = producer;
+}
+
+void
+ProducerMobility::SetExpiry (Time expiry)
+{
+	m_expiry = expiry;
+}
+
+void
+ProducerMobility::Install (HandoffController &controller)
+{
+	m_paths.clear ();
+	for (uint32_t ap = 0; ap < m_aps.size (); ap++)
+	{
+		ComputePaths (ap);
+	}
+
+	controller.TraceAssociations (MakeCallback (&ProducerMobility::Associated, this));
+
+	NS_LOG_INFO ("Following " << m_producers.size () << " producers of " << *m_prefix
+			<< " over " << m_aps.size () << " APs and " << m_anchors.GetN () << " anchors");
+}
+
+uint32_t
+ProducerMobility::GetHandoffs (void) const
+{
+	return m_handoffs;
+}
+
+uint32_t
+ProducerMobility::GetUpdates (void) const
+{
+	return m_updates;
+}
+
+void
+ProducerMobility::ComputePaths (uint32_t ap)
+{
+	Ptr<Node> apNode = m_aps[ap]->GetNode ();
+	Ptr<L3Protocol> apL3 = apNode->GetObject<L3Protocol> ();
+	NS_ABORT_MSG_UNLESS (apL3 != 0, "AP " << ap << " has no NDN stack");
+
+	std::set<uint32_t> routers;
+	for (NodeContainer::Iterator i = m_routers.Begin (); i != m_routers.End (); ++i)
+	{
+		routers.insert ((*i)->GetId ());
+	}
+	for (NodeContainer::Iterator i = m_anchors.Begin (); i != m_anchors.End (); ++i)
+	{
+		routers.insert ((*i)->GetId ());
+	}
+
+	// Breadth first over the wired links, each node remembering the face
+	// it was reached through and its parent towards the AP
+	std::map<uint32_t, Hop> towards;
+	std::map<uint32_t, Ptr<Node> > parents;
+	std::deque<Ptr<Node> > queue;
+
+	towards[apNode->GetId ()].node = apNode;
+	queue.push_back (apNode);
+
+	while (!queue.empty ())
+	{
+		Ptr<Node> node = queue.front ();
+		queue.pop_front ();
+
+		Ptr<L3Protocol> l3 = node->GetObject<L3Protocol> ();
+		for (uint32_t f = 0; f < l3->GetNFaces (); f++)
+		{
+			Ptr<NetDeviceFace> face = DynamicCast<NetDeviceFace> (l3->GetFace (f));
+			if (face == 0 || IsWireless (face->GetNetDevice ()) || face->GetNetDevice ()->GetChannel () == 0)
+			{
+				continue;
+			}
+
+			Ptr<NetDevice> device = face->GetNetDevice ();
+			Ptr<Channel> channel = device->GetChannel ();
+			for (uint32_t d = 0; d < channel->GetNDevices (); d++)
+			{
+				Ptr<NetDevice> other = channel->GetDevice (d);
+				Ptr<Node> neighbour = other->GetNode ();
+				if (other == device || towards.find (neighbour->GetId ()) != towards.end ()
+						|| (!routers.empty () && routers.find (neighbour->GetId ()) == routers.end ()))
+				{
+					continue;
+				}
+
+				Ptr<L3Protocol> neighbourL3 = neighbour->GetObject<L3Protocol> ();
+				Ptr<Face> back;
+				if (neighbourL3 == 0 || (back = neighbourL3->GetFaceByNetDevice (other)) == 0)
+				{
+					continue;
+				}
+
+				Hop &hop = towards[neighbour->GetId ()];
+				hop.node = neighbour;
+				hop.face = back;
+				parents[neighbour->GetId ()] = node;
+				queue.push_back (neighbour);
+			}
+		}
+	}
+
+	// The AP hands the Interests to its wireless device, the others down
+	// the tree, each router once however many anchors it serves
+	std::vector<Hop> path;
+	Hop first;
+	first.node = apNode;
+	first.face = apL3->GetFaceByNetDevice (m_aps[ap]);
+	NS_ABORT_MSG_UNLESS (first.face != 0, "Wireless device of AP " << ap << " has no NDN face");
+	path.push_back (first);
+
+	std::set<uint32_t> onPath;
+	onPath.insert (apNode->GetId ());
+
+	for (NodeContainer::Iterator i = m_anchors.Begin (); i != m_anchors.End (); ++i)
+	{
+		if (towards.find ((*i)->GetId ()) == towards.end ())
+		{
+			NS_LOG_WARN ("Anchor " << (*i)->GetId () << " has no wired path to AP " << ap);
+			continue;
+		}
+
+		for (Ptr<Node> node = *i; onPath.insert (node->GetId ()).second; node = parents[node->GetId ()])
+		{
+			path.push_back (towards[node->GetId ()]);
+		}
+	}
+
+	NS_LOG_DEBUG ("AP " << ap << " (node " << apNode->GetId () << ") is " << path.size () << " routes deep");
+	m_paths.push_back (path);
+}
+
+void
+ProducerMobility::Associated (uint32_t terminal, uint32_t ap)
+{
+	std::map<uint32_t, Producer>::iterator p = m_producers.find (terminal);
+	if (p == m_producers.end () || p->second.ap == ap || ap >= m_paths.size ())
+	{
+		return;
+	}
+
+	Producer &producer = p->second;
+	NS_LOG_INFO ("Producer " << terminal << " moved to AP " << ap);
+
+	// Everything this producer pointed at is rewritten
+	std::vector<Hop> old = producer.stale;
+	old.insert (old.end (), producer.path.begin (), producer.path.end ());
+
+	producer.stale.clear ();
+	if (!m_expiry.IsZero ())
+	{
+		producer.stale = producer.path;
+	}
+	producer.path = m_paths[ap];
+	producer.ap = ap;
+	producer.generation++;
+	m_handoffs++;
+
+	old.insert (old.end (), producer.path.begin (), producer.path.end ());
+	Refresh (old);
+
+	if (!producer.stale.empty ())
+	{
+		Simulator::Schedule (m_expiry, &ProducerMobility::Expire, this, terminal, producer.generation);
+	}
+}
+
+void
+ProducerMobility::Expire (uint32_t terminal, uint32_t generation)
+{
+	Producer &producer = m_producers[terminal];
+	if (producer.generation != generation)
+	{
+		return;
+	}
+
+	std::vector<Hop> stale;
+	stale.swap (producer.stale);
+	Refresh (stale);
+}
+
+void
+ProducerMobility::Refresh (const std::vector<Hop> &hops)
+{
+	std::set<uint32_t> done;
+	for (size_t i = 0; i < hops.size (); i++)
+	{
+		if (done.insert (hops[i].node->GetId ()).second)
+		{
+			Refresh (hops[i].node);
+		}
+	}
+}
+
+void
+ProducerMobility::Refresh (Ptr<Node> node)
+{
+	// Faces of every producer whose current path crosses node, or whose
+	// expiring one does if the current one does not
+	std::vector<Ptr<Face> > faces;
+	for (std::map<uint32_t, Producer>::const_iterator p = m_producers.begin (); p != m_producers.end (); ++p)
+	{
+		const std::vector<Hop> *lists[2] = { &p->second.path, &p->second.stale };
+		for (int l = 0; l < 2; l++)
+		{
+			bool found = false;
+			for (size_t h = 0; h < lists[l]->size (); h++)
+			{
+				const Hop &hop = (*lists[l])[h];
+				if (hop.node != node)
+				{
+					continue;
+				}
+				found = true;
+				if (std::find (faces.begin (), faces.end (), hop.face) == faces.end ())
+				{
+					faces.push_back (hop.face);
+				}
+			}
+			if (found)
+			{
+				break;
+			}
+		}
+	}
+
+	Ptr<Fib> fib = node->GetObject<Fib> ();
+	fib->Remove (m_prefix);
+	for (size_t f = 0; f < faces.size (); f++)
+	{
+		fib->Add (m_prefix, faces[f], 0);
+	}
+	m_updates++;
+
+	NS_LOG_DEBUG ("Node " << node->GetId () << " routes " << *m_prefix << " to " << faces.size () << " faces");
+}
+
+} // namespace ndn
+} // namespace ns3
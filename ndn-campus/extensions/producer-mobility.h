@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * producer-mobility.h
+ *
+ *  Breadcrumb routes towards mobile producers. Whenever a producing
+ *  terminal associates with an AP, the routers on the shortest wired paths
+ *  from the anchors (e.g. the LAN routers) down to that AP get a FIB entry
+ *  for the prefix pointing down the path, and the AP one pointing at its
+ *  wireless device. Routers that were only on the path to the previous AP
+ *  lose theirs after Expiry. With several producers, a router points at
+ *  every one it is on the path of.
+ *
+ *  The entry for the exact prefix is longer than the default routes, so
+ *  BestRoute and even Flooding send the Interests down the path instead of
+ *  out of every face. The entries belong to ProducerMobility, routes for
+ *  the exact prefix added by other means are replaced.
+ *
+ *  Associations come from a HandoffController, so terminal and AP indexes
+ *  are those of the controller.
+ */
+
+#ifndef PRODUCER_MOBILITY_H_
+#define PRODUCER_MOBILITY_H_
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <ns3-dev/ns3/net-device.h>
+#include <ns3-dev/ns3/node-container.h>
+#include <ns3-dev/ns3/nstime.h>
+#include <ns3-dev/ns3/ndnSIM-module.h>
+
+#include "handoff-controller.h"
+
+namespace ns3 {
+namespace ndn {
+
+class ProducerMobility
+{
+public:
+	ProducerMobility (const std::string &prefix);
+
+	// Nodes the wired paths may cross, and those they start from
+	void AddRouters (const NodeContainer &routers);
+	void AddAnchors (const NodeContainer &anchors);
+
+	// Adds the wireless device of the next AP index, returns the index
+	uint32_t AddAp (Ptr<NetDevice> device);
+	uint32_t AddAps (const NetDeviceContainer &devices);
+
+	// Terminal index of a producer of the prefix
+	void AddProducer (uint32_t terminal);
+
+	// How long a router off the new path keeps pointing to the old one
+	void SetExpiry (Time expiry);
+
+	// Computes the paths and follows the associations of controller. Both
+	// must live until Simulator::Run () returns
+	void Install (HandoffController &controller);
+
+	// Handoffs that moved routes, FIB entries rewritten
+	uint32_t GetHandoffs (void) const;
+	uint32_t GetUpdates (void) const;
+
+private:
+	struct Hop
+	{
+		Ptr<Node> node;
+		Ptr<Face> face;
+	};
+
+	struct Producer
+	{
+		uint32_t ap;
+		std::vector<Hop> path;
+		std::vector<Hop> stale;
+		uint32_t generation;
+	};
+
+	static const uint32_t kNoAp = 0xffffffff;
+
+	void ComputePaths (uint32_t ap);
+	void Associated (uint32_t terminal, uint32_t ap);
+	void Expire (uint32_t terminal, uint32_t generation);
+	void Refresh (const std::vector<Hop> &hops);
+	void Refresh (Ptr<Node> node);
+
+	Ptr<const Name> m_prefix;
+	Time m_expiry;
+	NodeContainer m_routers;
+	NodeContainer m_anchors;
+	std::vector<Ptr<NetDevice> > m_aps;
+	// Routers on the paths from the anchors to each AP, with the face
+	// towards it
+	std::vector<std::vector<Hop> > m_paths;
+	std::map<uint32_t, Producer> m_producers;
+	uint32_t m_handoffs;
+	uint32_t m_updates;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif /* PRODUCER_MOBILITY_H_ */
@@ -0,0 +1,365 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * progress-meter.cc
+ *
+ *  Live progress reporter for long running scenarios.
+ */
+
+#include "progress-meter.h"
+
+#include <cstdio>
+#include <iostream>
+#include <unistd.h>
+
+#include <ns3-dev/ns3/event-impl.h>
+#include <ns3-dev/ns3/global-value.h>
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/simulator.h>
+#include <ns3-dev/ns3/string.h>
+
+NS_LOG_COMPONENT_DEFINE ("ProgressMeter");
+
+namespace ns3 {
+
+namespace {
+
+// Forwards to the real event and counts it once it runs
+class MeteredEvent : public EventImpl
+{
+public:
+	MeteredEvent (EventImpl *event, MeteredSimulatorImpl *impl)
+	: m_event (event, false)
+	, m_impl (impl)
+	{
+	}
+
+protected:
+	virtual void Notify (void)
+	{
+		m_event->Invoke ();
+		m_impl->Executed ();
+	}
+
+private:
+	Ptr<EventImpl> m_event;
+	MeteredSimulatorImpl *m_impl;
+};
+
+// Simulated time between two looks at the wall clock when the events
+// can't be counted
+const double kFallbackCheck = 0.1;
+
+} // anonymous namespace
+
+NS_OBJECT_ENSURE_REGISTERED (MeteredSimulatorImpl);
+
+TypeId
+MeteredSimulatorImpl::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::MeteredSimulatorImpl")
+		.SetParent<DefaultSimulatorImpl> ()
+		.AddConstructor<MeteredSimulatorImpl> ()
+		;
+	return tid;
+}
+
+MeteredSimulatorImpl::MeteredSimulatorImpl ()
+: m_every (0)
+, m_scheduled (0)
+, m_executed (0)
+, m_cancelled (0)
+, m_removed (0)
+{
+}
+
+MeteredSimulatorImpl::~MeteredSimulatorImpl ()
+{
+}
+
+EventImpl *
+MeteredSimulatorImpl::Wrap (EventImpl *event)
+{
+	++m_scheduled;
+	return new MeteredEvent (event, this);
+}
+
+EventId
+MeteredSimulatorImpl::Schedule (Time const &time, EventImpl *event)
+{
+	return DefaultSimulatorImpl::Schedule (time, Wrap (event));
+}
+
+void
+MeteredSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event)
+{
+	DefaultSimulatorImpl::ScheduleWithContext (context, time, Wrap (event));
+}
+
+EventId
+MeteredSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+	return DefaultSimulatorImpl::ScheduleNow (Wrap (event));
+}
+
+void
+MeteredSimulatorImpl::Remove (const EventId &id)
+{
+	// Cancelled events have already been discounted
+	if (!IsExpired (id))
+	{
+		++m_removed;
+	}
+	DefaultSimulatorImpl::Remove (id);
+}
+
+void
+MeteredSimulatorImpl::Cancel (const EventId &id)
+{
+	if (!IsExpired (id))
+	{
+		++m_cancelled;
+	}
+	DefaultSimulatorImpl::Cancel (id);
+}
+
+uint64_t
+MeteredSimulatorImpl::GetExecutedEvents (void) const
+{
+	return m_executed;
+}
+
+uint64_t
+MeteredSimulatorImpl::GetPendingEvents (void) const
+{
+	return m_scheduled - m_executed - m_cancelled - m_removed;
+}
+
+void
+MeteredSimulatorImpl::SetCheck (uint64_t events, Callback<void> check)
+{
+	m_every = check.IsNull () ? 0 : events;
+	m_check = check;
+}
+
+void
+MeteredSimulatorImpl::Executed (void)
+{
+	++m_executed;
+
+	if (m_every > 0 && m_executed % m_every == 0)
+	{
+		m_check ();
+	}
+}
+
+void
+ProgressMeter::EnableEventCounting (void)
+{
+	StringValue impl;
+	GlobalValue::GetValueByName ("SimulatorImplementationType", impl);
+
+	if (impl.Get () != "ns3::DefaultSimulatorImpl")
+	{
+		NS_LOG_INFO ("Keeping " << impl.Get () << ", events will not be counted");
+		return;
+	}
+
+	GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::MeteredSimulatorImpl"));
+}
+
+ProgressMeter::ProgressMeter (double interval, const std::string &filename)
+: m_interval (interval)
+, m_filename (filename)
+, m_json (!filename.empty ())
+, m_running (false)
+, m_checkEvents (10000)
+, m_wallStart (0)
+, m_wallLast (0)
+, m_simLast (0)
+, m_eventsLast (0)
+{
+}
+
+ProgressMeter::~ProgressMeter ()
+{
+	if (m_running)
+	{
+		Ptr<MeteredSimulatorImpl> impl = DynamicCast<MeteredSimulatorImpl> (Simulator::GetImplementation ());
+		if (impl != 0)
+		{
+			impl->SetCheck (0, MakeNullCallback<void> ());
+		}
+	}
+
+	if (m_file.is_open ())
+	{
+		m_file.close ();
+	}
+}
+
+void
+ProgressMeter::SetCheckEvents (uint64_t events)
+{
+	m_checkEvents = (events > 0) ? events : 1;
+}
+
+void
+ProgressMeter::Start (void)
+{
+	if (m_interval <= 0 || m_running)
+	{
+		return;
+	}
+
+	if (m_json)
+	{
+		m_file.open (m_filename.c_str (), std::ios::out | std::ios::trunc);
+		if (!m_file)
+		{
+			std::cerr << "ProgressMeter: could not open " << m_filename
+					<< ", reporting to stdout" << std::endl;
+			m_json = false;
+		}
+	}
+
+	m_running = true;
+	m_wallStart = m_wallLast = WallNow ();
+	m_simLast = Simulator::Now ().GetSeconds ();
+
+	// The wall clock is looked at from the executed events, so a stretch of
+	// simulated time with many events can't hold back the reports. Only
+	// without the metered simulator is it looked at in simulated time
+	Ptr<MeteredSimulatorImpl> impl = DynamicCast<MeteredSimulatorImpl> (Simulator::GetImplementation ());
+	if (impl != 0)
+	{
+		m_eventsLast = impl->GetExecutedEvents ();
+		impl->SetCheck (m_checkEvents, MakeCallback (&ProgressMeter::Check, this));
+	}
+	else
+	{
+		m_eventsLast = 0;
+		m_event = Simulator::Schedule (Seconds (kFallbackCheck), &ProgressMeter::Poll, this);
+	}
+
+	Simulator::ScheduleDestroy (&ProgressMeter::Finish, this);
+}
+
+void
+ProgressMeter::Check (void)
+{
+	if (WallNow () - m_wallLast >= m_interval)
+	{
+		Report ();
+	}
+}
+
+void
+ProgressMeter::Poll (void)
+{
+	Check ();
+	m_event = Simulator::Schedule (Seconds (kFallbackCheck), &ProgressMeter::Poll, this);
+}
+
+void
+ProgressMeter::Finish (void)
+{
+	if (!m_running)
+	{
+		return;
+	}
+
+	Ptr<MeteredSimulatorImpl> impl = DynamicCast<MeteredSimulatorImpl> (Simulator::GetImplementation ());
+	if (impl != 0)
+	{
+		impl->SetCheck (0, MakeNullCallback<void> ());
+	}
+
+	Report ();
+	m_running = false;
+}
+
+void
+ProgressMeter::Report (void)
+{
+	double wall = WallNow ();
+	double sim = Simulator::Now ().GetSeconds ();
+	double dWall = wall - m_wallLast;
+	double speed = (dWall > 0) ? (sim - m_simLast) / dWall : 0;
+
+	Ptr<MeteredSimulatorImpl> impl = DynamicCast<MeteredSimulatorImpl> (Simulator::GetImplementation ());
+
+	// -1 marks the columns we can't know without the metered simulator
+	double rate = -1;
+	int64_t pending = -1;
+
+	if (impl != 0)
+	{
+		uint64_t executed = impl->GetExecutedEvents ();
+		rate = (dWall > 0) ? (executed - m_eventsLast) / dWall : 0;
+		pending = impl->GetPendingEvents ();
+		m_eventsLast = executed;
+	}
+
+	uint64_t rss = ResidentBytes ();
+	char buffer[250];
+
+	if (m_json)
+	{
+		sprintf (buffer, "{\"wall\": %.3f, \"sim\": %.6f, \"speed\": %.4f, \"events_per_sec\": %.1f, \"queue\": %lld, \"rss\": %llu}",
+				wall - m_wallStart, sim, speed, rate, (long long)pending, (unsigned long long)rss);
+		m_file << buffer << std::endl;
+	}
+	else
+	{
+		sprintf (buffer, "Progress: sim %.3fs, wall %.1fs, %.3fx real time, %.0f events/s, %lld queued, RSS %.1f MB",
+				sim, wall - m_wallStart, speed, rate, (long long)pending, rss / 1048576.0);
+		std::cout << buffer << std::endl;
+	}
+
+	m_wallLast = wall;
+	m_simLast = sim;
+}
+
+double
+ProgressMeter::WallNow (void)
+{
+	struct timeval t;
+	gettimeofday (&t, NULL);
+	return (double)t.tv_sec + t.tv_usec * 1e-6;
+}
+
+uint64_t
+ProgressMeter::ResidentBytes (void)
+{
+	// Second field of statm is the resident set in pages
+	unsigned long size = 0, resident = 0;
+	FILE *statm = fopen ("/proc/self/statm", "r");
+
+	if (statm == 0)
+	{
+		return 0;
+	}
+
+	if (fscanf (statm, "%lu %lu", &size, &resident) != 2)
+	{
+		resident = 0;
+	}
+	fclose (statm);
+
+	return (uint64_t)resident * sysconf (_SC_PAGESIZE);
+}
+
+} // namespace ns3
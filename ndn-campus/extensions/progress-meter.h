@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * progress-meter.h
+ *
+ *  Live progress reporter for long running scenarios. Every report carries
+ *  the simulated time, how fast simulated time advances compared to wall
+ *  clock time, the number of events executed per wall clock second, the
+ *  number of events waiting in the queue and the resident set size of the
+ *  process.
+ */
+
+#ifndef PROGRESS_METER_H_
+#define PROGRESS_METER_H_
+
+#include <fstream>
+#include <string>
+#include <sys/time.h>
+
+#include <ns3-dev/ns3/callback.h>
+#include <ns3-dev/ns3/default-simulator-impl.h>
+#include <ns3-dev/ns3/event-id.h>
+#include <ns3-dev/ns3/nstime.h>
+
+namespace ns3 {
+
+/*
+ * Behaves exactly like DefaultSimulatorImpl, but keeps count of the events
+ * that go through the queue so the ProgressMeter can report event rates and
+ * queue sizes. It can also call back every given number of executed events,
+ * which lets the ProgressMeter look at the wall clock however slowly or
+ * quickly simulated time advances.
+ */
+class MeteredSimulatorImpl : public DefaultSimulatorImpl
+{
+public:
+	static TypeId GetTypeId (void);
+
+	MeteredSimulatorImpl ();
+	virtual ~MeteredSimulatorImpl ();
+
+	virtual EventId Schedule (Time const &time, EventImpl *event);
+	virtual void ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event);
+	virtual EventId ScheduleNow (EventImpl *event);
+	virtual void Remove (const EventId &id);
+	virtual void Cancel (const EventId &id);
+
+	// Number of events which have been executed
+	uint64_t GetExecutedEvents (void) const;
+
+	// Number of live events still waiting in the queue
+	uint64_t GetPendingEvents (void) const;
+
+	// Calls check after every events executed events. An events of 0 or a
+	// null callback stops the calls
+	void SetCheck (uint64_t events, Callback<void> check);
+
+	// Counts an event which has just been executed
+	void Executed (void);
+
+private:
+	EventImpl * Wrap (EventImpl *event);
+
+	uint64_t m_every;
+	Callback<void> m_check;
+	uint64_t m_scheduled;
+	uint64_t m_executed;
+	uint64_t m_cancelled;
+	uint64_t m_removed;
+};
+
+class ProgressMeter
+{
+public:
+	// Makes the simulator count events. Must be called before the first
+	// Node is created, otherwise the simulator has already been built and
+	// the reports will lack the event columns. Does nothing if another
+	// simulator implementation was asked for on the command line.
+	static void EnableEventCounting (void);
+
+	// interval is the wall clock time, in seconds, between two reports. An
+	// interval of 0 disables the meter. With an empty filename the reports
+	// go to std::cout as text, otherwise they are written to filename as one
+	// JSON object per line.
+	ProgressMeter (double interval = 10.0, const std::string &filename = "");
+	~ProgressMeter ();
+
+	// How many executed events go by between two looks at the wall clock.
+	// Defaults to 10000. Without the metered simulator the wall clock is
+	// looked at every 0.1 simulated seconds instead
+	void SetCheckEvents (uint64_t events);
+
+	// Begins reporting. Call right before Simulator::Run ()
+	void Start (void);
+
+	// Prints a report immediately
+	void Report (void);
+
+private:
+	void Check (void);
+	void Poll (void);
+	void Finish (void);
+	static double WallNow (void);
+	static uint64_t ResidentBytes (void);
+
+	double m_interval;
+	std::string m_filename;
+	std::ofstream m_file;
+	bool m_json;
+	bool m_running;
+	uint64_t m_checkEvents;
+	EventId m_event;
+
+	double m_wallStart;
+	double m_wallLast;
+	double m_simLast;
+	uint64_t m_eventsLast;
+};
+
+} // namespace ns3
+
+#endif /* PROGRESS_METER_H_ */
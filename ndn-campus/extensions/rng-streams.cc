@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * rng-streams.cc
+ *
+ *  Named random number streams.
+ */
+
+#include "rng-streams.h"
+
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/rng-seed-manager.h>
+
+NS_LOG_COMPONENT_DEFINE ("RngStreams");
+
+namespace ns3 {
+
+namespace {
+
+// Automatic streams take the first 2^63 RngStreams, and SetStream (n)
+// uses RngStream 2^63 + n, so named streams never meet automatic ones.
+// Helpers' AssignStreams () hand out n counting up from small numbers,
+// named ones are kept in [2^40, 2^41) well above them
+const int64_t kFirstStream = (int64_t)1 << 40;
+const int64_t kStreams = (int64_t)1 << 40;
+
+} // anonymous namespace
+
+std::map<std::string, Ptr<UniformRandomVariable> > RngStreams::s_streams;
+
+int64_t
+RngStreams::GetStream (const std::string &name)
+{
+	// FNV-1a, stable across builds unlike std::hash
+	uint64_t hash = 14695981039346656037ULL;
+	for (std::string::const_iterator c = name.begin (); c != name.end (); ++c)
+	{
+		hash = (hash ^ (uint8_t)*c) * 1099511628211ULL;
+	}
+
+	return kFirstStream + (int64_t)(hash % kStreams);
+}
+
+Ptr<UniformRandomVariable>
+RngStreams::Get (const std::string &name)
+{
+	std::map<std::string, Ptr<UniformRandomVariable> >::iterator i = s_streams.find (name);
+	if (i != s_streams.end ())
+	{
+		return i->second;
+	}
+
+	Ptr<UniformRandomVariable> variable = CreateObject<UniformRandomVariable> ();
+	variable->SetStream (GetStream (name));
+
+	NS_LOG_INFO ("Stream " << name << " is " << GetStream (name) << " of seed "
+			<< RngSeedManager::GetSeed () << " run " << RngSeedManager::GetRun ());
+
+	s_streams[name] = variable;
+	return variable;
+}
+
+uint32_t
+RngStreams::GetInteger (const std::string &name, uint32_t min, uint32_t max)
+{
+	return Get (name)->GetInteger (min, max);
+}
+
+} // namespace ns3
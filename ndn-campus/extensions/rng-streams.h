@@ -0,0 +1,55 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * rng-streams.h
+ *
+ *  Named random number streams for the scenario setup code. Each name
+ *  (placement, prefix, arrivals, mobility, ...) maps to a fixed ns-3 RNG
+ *  stream, so its numbers only depend on the seed and run number given
+ *  with --RngSeed and --RngRun, never on the clock or on what other parts
+ *  of the scenario draw. Two runs with the same run number see the same
+ *  client placement whatever the forwarding strategy.
+ */
+
+#ifndef RNG_STREAMS_H_
+#define RNG_STREAMS_H_
+
+#include <map>
+#include <string>
+
+#include <ns3-dev/ns3/random-variable-stream.h>
+
+namespace ns3 {
+
+class RngStreams
+{
+public:
+	// Uniform [0, 1) variable on the stream of name, the same object on
+	// every call
+	static Ptr<UniformRandomVariable> Get (const std::string &name);
+
+	// Integer in [min, max] from the stream of name
+	static uint32_t GetInteger (const std::string &name, uint32_t min, uint32_t max);
+
+	// Stream number used for name
+	static int64_t GetStream (const std::string &name);
+
+private:
+	static std::map<std::string, Ptr<UniformRandomVariable> > s_streams;
+};
+
+} // namespace ns3
+
+#endif /* RNG_STREAMS_H_ */
@@ -0,0 +1,643 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * scan-resistant-content-store.cc
+ *
+ *  ARC, 2Q and W-TinyLFU over byte sized LRU lists.
+ */
+
+#include "scan-resistant-content-store.h"
+
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ns3-dev/ns3/double.h>
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/uinteger.h>
+
+#include "ndn-capture.h"
+
+NS_LOG_COMPONENT_DEFINE ("ndn.cs.ScanResistant");
+
+namespace ns3 {
+namespace ndn {
+namespace cs {
+
+namespace {
+
+uint32_t
+HashOf (const Name &name)
+{
+	return NdnCapture::Hash (name, name.size ());
+}
+
+// Stored entries in LRU lists, most recent first, with the bytes of each
+class Queues
+{
+public:
+	Queues (size_t queues)
+		: m_lists (queues)
+		, m_bytes (queues, 0)
+	{
+	}
+
+	void Push (Entry *entry, uint32_t cost, uint32_t hash, size_t queue)
+	{
+		m_lists[queue].push_front (entry);
+
+		Slot &slot = m_slots[entry];
+		slot.position = m_lists[queue].begin ();
+		slot.cost = cost;
+		slot.hash = hash;
+		slot.queue = queue;
+		m_bytes[queue] += cost;
+	}
+
+	// To the front of queue, which may be the one entry is in
+	void Move (Entry *entry, size_t queue)
+	{
+		Slot &slot = m_slots.find (entry)->second;
+		m_lists[queue].splice (m_lists[queue].begin (), m_lists[slot.queue], slot.position);
+		m_bytes[slot.queue] -= slot.cost;
+		m_bytes[queue] += slot.cost;
+		slot.queue = queue;
+	}
+
+	void Erase (Entry *entry)
+	{
+		std::unordered_map<Entry *, Slot>::iterator i = m_slots.find (entry);
+		NS_ASSERT (i != m_slots.end ());
+
+		m_lists[i->second.queue].erase (i->second.position);
+		m_bytes[i->second.queue] -= i->second.cost;
+		m_slots.erase (i);
+	}
+
+	size_t GetQueue (Entry *entry) const
+	{
+		return m_slots.find (entry)->second.queue;
+	}
+
+	uint32_t GetCost (Entry *entry) const
+	{
+		return m_slots.find (entry)->second.cost;
+	}
+
+	uint32_t GetHash (Entry *entry) const
+	{
+		return m_slots.find (entry)->second.hash;
+	}
+
+	// Least recently used of queue, 0 if empty
+	Entry *GetOldest (size_t queue) const
+	{
+		return m_lists[queue].empty () ? 0 : m_lists[queue].back ();
+	}
+
+	uint64_t GetBytes (size_t queue) const
+	{
+		return m_bytes[queue];
+	}
+
+private:
+	struct Slot
+	{
+		std::list<Entry *>::iterator position;
+		uint32_t cost;
+		uint32_t hash;
+		size_t queue;
+	};
+
+	std::vector<std::list<Entry *> > m_lists;
+	std::vector<uint64_t> m_bytes;
+	std::unordered_map<Entry *, Slot> m_slots;
+};
+
+// Hashes of recently evicted names with their bytes, most recent first
+class Ghosts
+{
+public:
+	Ghosts ()
+		: m_bytes (0)
+	{
+	}
+
+	bool Contains (uint32_t hash) const
+	{
+		return m_index.find (hash) != m_index.end ();
+	}
+
+	void Push (uint32_t hash, uint32_t cost)
+	{
+		Erase (hash);
+		m_order.push_front (std::make_pair (hash, cost));
+		m_index[hash] = m_order.begin ();
+		m_bytes += cost;
+	}
+
+	bool Erase (uint32_t hash)
+	{
+		std::unordered_map<uint32_t, Order::iterator>::iterator i = m_index.find (hash);
+		if (i == m_index.end ())
+		{
+			return false;
+		}
+
+		m_bytes -= i->second->second;
+		m_order.erase (i->second);
+		m_index.erase (i);
+		return true;
+	}
+
+	// Forgets the oldest until at most bytes are remembered
+	void Trim (uint64_t bytes)
+	{
+		while (m_bytes > bytes)
+		{
+			Erase (m_order.back ().first);
+		}
+	}
+
+	uint64_t GetBytes (void) const
+	{
+		return m_bytes;
+	}
+
+private:
+	typedef std::list<std::pair<uint32_t, uint32_t> > Order;
+
+	Order m_order;
+	std::unordered_map<uint32_t, Order::iterator> m_index;
+	uint64_t m_bytes;
+};
+
+// Count-min sketch of four rows of counts up to 15, all halved once there
+// were ten increments per counter
+class FrequencySketch
+{
+public:
+	FrequencySketch ()
+		: m_mask (0)
+		, m_additions (0)
+	{
+	}
+
+	bool IsEmpty (void) const
+	{
+		return m_table.empty ();
+	}
+
+	// Counters per row, rounded up to a power of two
+	void Resize (uint32_t width)
+	{
+		uint32_t size = 1;
+		while (size < width)
+		{
+			size <<= 1;
+		}
+
+		m_table.assign (kRows * size, 0);
+		m_mask = size - 1;
+		m_additions = 0;
+	}
+
+	void Increment (uint32_t hash)
+	{
+		for (uint32_t row = 0; row < kRows; row++)
+		{
+			uint8_t &count = m_table[Index (hash, row)];
+			if (count < kMaxCount)
+			{
+				count++;
+			}
+		}
+
+		if (++m_additions >= 10 * (m_mask + 1))
+		{
+			for (size_t i = 0; i < m_table.size (); i++)
+			{
+				m_table[i] >>= 1;
+			}
+			m_additions /= 2;
+		}
+	}
+
+	uint32_t Estimate (uint32_t hash) const
+	{
+		if (m_table.empty ())
+		{
+			return 0;
+		}
+
+		uint32_t estimate = kMaxCount;
+		for (uint32_t row = 0; row < kRows; row++)
+		{
+			estimate = std::min<uint32_t> (estimate, m_table[Index (hash, row)]);
+		}
+		return estimate;
+	}
+
+private:
+	static const uint32_t kRows = 4;
+	static const uint8_t kMaxCount = 15;
+
+	size_t Index (uint32_t hash, uint32_t row) const
+	{
+		static const uint32_t seeds[kRows] = { 0x9e3779b1u, 0x85ebca77u, 0xc2b2ae3du, 0x27d4eb2fu };
+
+		uint32_t h = hash * seeds[row];
+		h ^= h >> 15;
+		return row * (m_mask + 1) + (h & m_mask);
+	}
+
+	std::vector<uint8_t> m_table;
+	uint32_t m_mask;
+	uint32_t m_additions;
+};
+
+} // anonymous namespace
+
+// Arc
+
+struct Arc::Lists
+{
+	enum { T1, T2 };
+	enum Ghost { NONE, B1, B2 };
+
+	Lists ()
+		: queues (2)
+		, target (0.0)
+		, pending (NONE)
+	{
+	}
+
+	Queues queues;
+	Ghosts b1;
+	Ghosts b2;
+	// Bytes of T1 aimed at, p in the ARC paper
+	double target;
+	// Ghost list the Data being added was found in
+	Ghost pending;
+};
+
+NS_OBJECT_ENSURE_REGISTERED (Arc);
+
+TypeId
+Arc::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::ndn::cs::Arc")
+		.SetGroupName ("Ndn")
+		.SetParent<ByteStore> ()
+		.AddConstructor<Arc> ()
+		;
+	return tid;
+}
+
+Arc::Arc ()
+	: m_lists (new Lists)
+{
+}
+
+Arc::~Arc ()
+{
+	delete m_lists;
+}
+
+bool
+Arc::DoAdmit (Ptr<const Data> data, uint32_t cost)
+{
+	uint32_t hash = HashOf (data->GetName ());
+	double b1 = m_lists->b1.GetBytes ();
+	double b2 = m_lists->b2.GetBytes ();
+
+	// A hit in a ghost list grows the side it was evicted from
+	if (m_lists->b1.Contains (hash))
+	{
+		m_lists->target = std::min<double> (GetMaxBytes (), m_lists->target + cost * std::max (1.0, b2 / b1));
+		m_lists->pending = Lists::B1;
+	}
+	else if (m_lists->b2.Contains (hash))
+	{
+		m_lists->target = std::max (0.0, m_lists->target - cost * std::max (1.0, b1 / b2));
+		m_lists->pending = Lists::B2;
+	}
+	else
+	{
+		m_lists->pending = Lists::NONE;
+	}
+
+	return true;
+}
+
+void
+Arc::DoInsert (Entry *entry, uint32_t cost)
+{
+	uint32_t hash = HashOf (entry->GetName ());
+
+	if (m_lists->pending != Lists::NONE)
+	{
+		m_lists->b1.Erase (hash);
+		m_lists->b2.Erase (hash);
+		m_lists->queues.Push (entry, cost, hash, Lists::T2);
+	}
+	else
+	{
+		m_lists->queues.Push (entry, cost, hash, Lists::T1);
+	}
+	m_lists->pending = Lists::NONE;
+
+	// T1 and B1 within the store size, all four within twice that
+	uint64_t size = GetMaxBytes ();
+	uint64_t t1 = m_lists->queues.GetBytes (Lists::T1);
+	m_lists->b1.Trim (t1 < size ? size - t1 : 0);
+
+	uint64_t rest = t1 + m_lists->queues.GetBytes (Lists::T2) + m_lists->b1.GetBytes ();
+	m_lists->b2.Trim (rest < 2 * size ? 2 * size - rest : 0);
+}
+
+void
+Arc::DoHit (Entry *entry)
+{
+	m_lists->queues.Move (entry, Lists::T2);
+}
+
+Entry *
+Arc::DoVictim (void)
+{
+	Queues &queues = m_lists->queues;
+	uint64_t t1 = queues.GetBytes (Lists::T1);
+
+	bool fromT1 = queues.GetOldest (Lists::T1) != 0
+			&& (queues.GetOldest (Lists::T2) == 0 || t1 > m_lists->target
+					|| (m_lists->pending == Lists::B2 && t1 >= m_lists->target));
+
+	Entry *victim = queues.GetOldest (fromT1 ? Lists::T1 : Lists::T2);
+	(fromT1 ? m_lists->b1 : m_lists->b2).Push (queues.GetHash (victim), queues.GetCost (victim));
+	return victim;
+}
+
+void
+Arc::DoRemove (Entry *entry)
+{
+	m_lists->queues.Erase (entry);
+}
+
+// TwoQueue
+
+struct TwoQueue::Lists
+{
+	enum { IN, MAIN };
+
+	Lists ()
+		: queues (2)
+	{
+	}
+
+	// A1in as a FIFO, Am as an LRU
+	Queues queues;
+	// A1out
+	Ghosts out;
+};
+
+NS_OBJECT_ENSURE_REGISTERED (TwoQueue);
+
+TypeId
+TwoQueue::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::ndn::cs::TwoQueue")
+		.SetGroupName ("Ndn")
+		.SetParent<ByteStore> ()
+		.AddConstructor<TwoQueue> ()
+		.AddAttribute ("InShare",
+				"Share of MaxBytes for Data seen once (Kin)",
+				DoubleValue (0.25),
+				MakeDoubleAccessor (&TwoQueue::m_inShare),
+				MakeDoubleChecker<double> (0.0, 1.0))
+		.AddAttribute ("OutShare",
+				"Share of MaxBytes whose evicted names are remembered (Kout)",
+				DoubleValue (0.5),
+				MakeDoubleAccessor (&TwoQueue::m_outShare),
+				MakeDoubleChecker<double> (0.0))
+		;
+	return tid;
+}
+
+TwoQueue::TwoQueue ()
+	: m_lists (new Lists)
+	, m_inShare (0.25)
+	, m_outShare (0.5)
+{
+}
+
+TwoQueue::~TwoQueue ()
+{
+	delete m_lists;
+}
+
+void
+TwoQueue::DoInsert (Entry *entry, uint32_t cost)
+{
+	uint32_t hash = HashOf (entry->GetName ());
+	m_lists->queues.Push (entry, cost, hash, m_lists->out.Erase (hash) ? Lists::MAIN : Lists::IN);
+}
+
+void
+TwoQueue::DoHit (Entry *entry)
+{
+	// Hits while seen once are the correlated ones, they do not count
+	if (m_lists->queues.GetQueue (entry) == Lists::MAIN)
+	{
+		m_lists->queues.Move (entry, Lists::MAIN);
+	}
+}
+
+Entry *
+TwoQueue::DoVictim (void)
+{
+	Queues &queues = m_lists->queues;
+
+	Entry *victim = queues.GetOldest (Lists::IN);
+	if (victim != 0 && (queues.GetBytes (Lists::IN) > m_inShare * GetMaxBytes () || queues.GetOldest (Lists::MAIN) == 0))
+	{
+		m_lists->out.Push (queues.GetHash (victim), queues.GetCost (victim));
+		m_lists->out.Trim ((uint64_t)(m_outShare * GetMaxBytes ()));
+		return victim;
+	}
+
+	return queues.GetOldest (Lists::MAIN);
+}
+
+void
+TwoQueue::DoRemove (Entry *entry)
+{
+	m_lists->queues.Erase (entry);
+}
+
+// WTinyLfu
+
+struct WTinyLfu::Lists
+{
+	enum { WINDOW, PROBATION, PROTECTED };
+
+	Lists ()
+		: queues (3)
+	{
+	}
+
+	Queues queues;
+	FrequencySketch sketch;
+};
+
+NS_OBJECT_ENSURE_REGISTERED (WTinyLfu);
+
+TypeId
+WTinyLfu::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::ndn::cs::WTinyLfu")
+		.SetGroupName ("Ndn")
+		.SetParent<ByteStore> ()
+		.AddConstructor<WTinyLfu> ()
+		.AddAttribute ("WindowShare",
+				"Share of MaxBytes for the LRU window new Data goes through",
+				DoubleValue (0.01),
+				MakeDoubleAccessor (&WTinyLfu::m_windowShare),
+				MakeDoubleChecker<double> (0.0, 1.0))
+		.AddAttribute ("ProtectedShare",
+				"Share of the main segments for Data hit there",
+				DoubleValue (0.8),
+				MakeDoubleAccessor (&WTinyLfu::m_protectedShare),
+				MakeDoubleChecker<double> (0.0, 1.0))
+		.AddAttribute ("SketchWidth",
+				"Counters per row of the frequency sketch, 0 for one per KB of MaxBytes",
+				UintegerValue (0),
+				MakeUintegerAccessor (&WTinyLfu::m_sketchWidth),
+				MakeUintegerChecker<uint32_t> ())
+		;
+	return tid;
+}
+
+WTinyLfu::WTinyLfu ()
+	: m_lists (new Lists)
+	, m_windowShare (0.01)
+	, m_protectedShare (0.8)
+	, m_sketchWidth (0)
+{
+}
+
+WTinyLfu::~WTinyLfu ()
+{
+	delete m_lists;
+}
+
+void
+WTinyLfu::DoAccess (const Name &name)
+{
+	if (m_lists->sketch.IsEmpty ())
+	{
+		m_lists->sketch.Resize (m_sketchWidth ? m_sketchWidth : std::max<uint64_t> (GetMaxBytes () / 1024, 1024));
+	}
+
+	m_lists->sketch.Increment (HashOf (name));
+}
+
+void
+WTinyLfu::DoInsert (Entry *entry, uint32_t cost)
+{
+	m_lists->queues.Push (entry, cost, HashOf (entry->GetName ()), Lists::WINDOW);
+}
+
+void
+WTinyLfu::DoHit (Entry *entry)
+{
+	Queues &queues = m_lists->queues;
+
+	if (queues.GetQueue (entry) == Lists::WINDOW)
+	{
+		queues.Move (entry, Lists::WINDOW);
+		return;
+	}
+
+	queues.Move (entry, Lists::PROTECTED);
+
+	// Overflow of the protected segment goes back on probation
+	double main = (1.0 - m_windowShare) * GetMaxBytes ();
+	while (queues.GetBytes (Lists::PROTECTED) > m_protectedShare * main)
+	{
+		queues.Move (queues.GetOldest (Lists::PROTECTED), Lists::PROBATION);
+	}
+}
+
+Entry *
+WTinyLfu::DoVictim (void)
+{
+	Queues &queues = m_lists->queues;
+
+	double window = m_windowShare * GetMaxBytes ();
+	double main = GetMaxBytes () - window;
+
+	// The oldest of an overflowing window moves to probation while there
+	// is room, and then has to be asked for more often than the one it
+	// would replace
+	while (queues.GetBytes (Lists::WINDOW) > window)
+	{
+		Entry *candidate = queues.GetOldest (Lists::WINDOW);
+		if (queues.GetBytes (Lists::PROBATION) + queues.GetBytes (Lists::PROTECTED) + queues.GetCost (candidate) <= main)
+		{
+			queues.Move (candidate, Lists::PROBATION);
+			continue;
+		}
+
+		Entry *victim = queues.GetOldest (Lists::PROBATION);
+		if (victim == 0)
+		{
+			victim = queues.GetOldest (Lists::PROTECTED);
+		}
+		if (victim == 0)
+		{
+			return candidate;
+		}
+
+		if (m_lists->sketch.Estimate (queues.GetHash (candidate)) > m_lists->sketch.Estimate (queues.GetHash (victim)))
+		{
+			queues.Move (candidate, Lists::PROBATION);
+			return victim;
+		}
+		return candidate;
+	}
+
+	Entry *victim = queues.GetOldest (Lists::PROBATION);
+	if (victim == 0)
+	{
+		victim = queues.GetOldest (Lists::PROTECTED);
+	}
+	if (victim == 0)
+	{
+		victim = queues.GetOldest (Lists::WINDOW);
+	}
+	return victim;
+}
+
+void
+WTinyLfu::DoRemove (Entry *entry)
+{
+	m_lists->queues.Erase (entry);
+}
+
+} // namespace cs
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * scan-resistant-content-store.h
+ *
+ *  ByteStore policies that keep popular Data through sequential fetches,
+ *  which under Lru flush everything seen once before:
+ *
+ *   - ns3::ndn::cs::Arc, Adaptive Replacement Cache. Data seen once and
+ *     Data seen again are kept in two LRU lists, whose split adapts to
+ *     hits on the names recently evicted from each.
+ *   - ns3::ndn::cs::TwoQueue, the full 2Q. Data seen once goes through a
+ *     FIFO of InShare of the bytes, and only makes it to the main LRU if
+ *     asked for again while its name is among the OutShare of recently
+ *     evicted ones.
+ *   - ns3::ndn::cs::WTinyLfu, Window TinyLFU. New Data goes through an LRU
+ *     window of WindowShare of the bytes, then has to be asked for more
+ *     often than the main segmented LRU victim to replace it. Frequencies
+ *     come from a count-min sketch of recent lookups, halved every ten
+ *     lookups per counter.
+ *
+ *  Every operation is constant time. The lists are sized in bytes, so Data
+ *  of different sizes weighs accordingly; evicted names are remembered by
+ *  their NdnCapture::Hash (). Select them as any store:
+ *
+ *    ndnHelper.SetContentStore ("ns3::ndn::cs::Arc", "MaxBytes", "3145728");
+ */
+
+#ifndef SCAN_RESISTANT_CONTENT_STORE_H_
+#define SCAN_RESISTANT_CONTENT_STORE_H_
+
+#include "byte-content-store.h"
+
+namespace ns3 {
+namespace ndn {
+namespace cs {
+
+class Arc : public ByteStore
+{
+public:
+	static TypeId GetTypeId (void);
+
+	Arc ();
+	virtual ~Arc ();
+
+protected:
+	virtual bool DoAdmit (Ptr<const Data> data, uint32_t cost);
+	virtual void DoInsert (Entry *entry, uint32_t cost);
+	virtual void DoHit (Entry *entry);
+	virtual Entry *DoVictim (void);
+	virtual void DoRemove (Entry *entry);
+
+private:
+	struct Lists;
+
+	Lists *m_lists;
+};
+
+class TwoQueue : public ByteStore
+{
+public:
+	static TypeId GetTypeId (void);
+
+	TwoQueue ();
+	virtual ~TwoQueue ();
+
+protected:
+	virtual void DoInsert (Entry *entry, uint32_t cost);
+	virtual void DoHit (Entry *entry);
+	virtual Entry *DoVictim (void);
+	virtual void DoRemove (Entry *entry);
+
+private:
+	struct Lists;
+
+	Lists *m_lists;
+	double m_inShare;
+	double m_outShare;
+};
+
+class WTinyLfu : public ByteStore
+{
+public:
+	static TypeId GetTypeId (void);
+
+	WTinyLfu ();
+	virtual ~WTinyLfu ();
+
+protected:
+	virtual void DoAccess (const Name &name);
+	virtual void DoInsert (Entry *entry, uint32_t cost);
+	virtual void DoHit (Entry *entry);
+	virtual Entry *DoVictim (void);
+	virtual void DoRemove (Entry *entry);
+
+private:
+	struct Lists;
+
+	Lists *m_lists;
+	double m_windowShare;
+	double m_protectedShare;
+	uint32_t m_sketchWidth;
+};
+
+} // namespace cs
+} // namespace ndn
+} // namespace ns3
+
+#endif /* SCAN_RESISTANT_CONTENT_STORE_H_ */
@@ -0,0 +1,497 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * shm-interface.cc
+ *
+ *  Multi process simulation over shared memory.
+ */
+
+#include "shm-interface.h"
+
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <new>
+#include <vector>
+
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <ns3-dev/ns3/drop-tail-queue.h>
+#include <ns3-dev/ns3/global-value.h>
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/mac48-address.h>
+#include <ns3-dev/ns3/node-list.h>
+#include <ns3-dev/ns3/point-to-point-net-device.h>
+#include <ns3-dev/ns3/simulator.h>
+#include <ns3-dev/ns3/string.h>
+
+NS_LOG_COMPONENT_DEFINE ("ShmInterface");
+
+namespace ns3 {
+
+namespace {
+
+const int64_t kNever = 0x7fffffffffffffffLL;
+const size_t kAlign = 64;
+
+// Start of the segment
+struct Control
+{
+	std::atomic<uint32_t> arrived;
+	std::atomic<uint32_t> generation;
+	std::atomic<uint32_t> failed;
+};
+
+// Next event time of one process, one per process after the Control
+struct Slot
+{
+	int64_t next;
+	uint32_t finished;
+	uint32_t padding;
+};
+
+// Head of the mailbox from one process to another, followed by the messages.
+// Only written by the sender during a window and only read by the receiver
+// between the barriers, so it needs no locking
+struct Mailbox
+{
+	uint64_t used;
+	uint64_t count;
+};
+
+// Head of one packet in a mailbox, followed by the serialized packet
+struct Message
+{
+	int64_t rxTime;
+	uint32_t node;
+	uint32_t dev;
+	uint32_t size;
+	uint32_t padding;
+};
+
+bool g_enabled = false;
+uint32_t g_systemId = 0;
+uint32_t g_size = 1;
+uint64_t g_mailboxSize = 64 << 20;
+int64_t g_lookAhead = kNever;
+
+char *g_segment = 0;
+size_t g_segmentSize = 0;
+size_t g_mailboxOffset = 0;
+std::vector<pid_t> g_children;
+// Exit status of the children CheckProcesses () already waited for
+std::map<pid_t, int> g_reaped;
+
+size_t
+Align (size_t bytes)
+{
+	return (bytes + kAlign - 1) / kAlign * kAlign;
+}
+
+Control *
+GetControl (void)
+{
+	return reinterpret_cast<Control *> (g_segment);
+}
+
+Slot *
+GetSlot (uint32_t process)
+{
+	return reinterpret_cast<Slot *> (g_segment + Align (sizeof (Control))) + process;
+}
+
+Mailbox *
+GetMailbox (uint32_t from, uint32_t to)
+{
+	size_t stride = Align (sizeof (Mailbox) + g_mailboxSize);
+	return reinterpret_cast<Mailbox *> (g_segment + g_mailboxOffset + (from * g_size + to) * stride);
+}
+
+char *
+GetData (Mailbox *box)
+{
+	return reinterpret_cast<char *> (box) + Align (sizeof (Mailbox));
+}
+
+// A process that dies leaves the others waiting at the barrier forever
+void
+CheckProcesses (void)
+{
+	Control *control = GetControl ();
+
+	if (g_systemId == 0)
+	{
+		// One that finished its share cleanly is not a failure
+		int status;
+		pid_t pid = waitpid (-1, &status, WNOHANG);
+		if (pid > 0)
+		{
+			g_reaped[pid] = status;
+			if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+			{
+				control->failed = 1;
+				NS_FATAL_ERROR ("Process " << pid << " failed in the middle of the simulation");
+			}
+		}
+	}
+	else if (control->failed)
+	{
+		_exit (1);
+	}
+}
+
+} // anonymous namespace
+
+void
+ShmInterface::Enable (uint32_t processes)
+{
+	NS_ASSERT_MSG (!g_enabled, "ShmInterface is already enabled");
+
+	if (processes < 2)
+	{
+		return;
+	}
+
+	g_size = processes;
+	g_mailboxOffset = Align (sizeof (Control)) + Align (processes * sizeof (Slot));
+	g_segmentSize = g_mailboxOffset + (size_t)processes * processes * Align (sizeof (Mailbox) + g_mailboxSize);
+
+	void *segment = mmap (0, g_segmentSize, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (segment == MAP_FAILED)
+	{
+		NS_FATAL_ERROR ("Could not map " << g_segmentSize << " bytes of shared memory");
+	}
+
+	g_segment = static_cast<char *> (segment);
+	new (g_segment) Control ();
+	GetControl ()->arrived = 0;
+	GetControl ()->generation = 0;
+	GetControl ()->failed = 0;
+
+	GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::ShmSimulatorImpl"));
+
+	// Whatever is buffered would be written once by every process
+	std::cout.flush ();
+	std::cerr.flush ();
+	fflush (0);
+
+	pid_t parent = getpid ();
+	for (uint32_t i = 1; i < processes; ++i)
+	{
+		pid_t pid = fork ();
+		if (pid < 0)
+		{
+			NS_FATAL_ERROR ("Could not fork process " << i);
+		}
+
+		if (pid == 0)
+		{
+			g_systemId = i;
+			g_children.clear ();
+
+			// Do not outlive process 0
+			prctl (PR_SET_PDEATHSIG, SIGKILL);
+			if (getppid () != parent)
+			{
+				_exit (1);
+			}
+			break;
+		}
+
+		g_children.push_back (pid);
+	}
+
+	g_enabled = true;
+	NS_LOG_INFO ("Process " << g_systemId << " of " << g_size << " running as " << getpid ());
+}
+
+bool
+ShmInterface::Disable (void)
+{
+	if (!g_enabled)
+	{
+		return true;
+	}
+
+	bool ok = true;
+
+	for (size_t i = 0; i < g_children.size (); ++i)
+	{
+		int status;
+		std::map<pid_t, int>::iterator reaped = g_reaped.find (g_children[i]);
+		if (reaped != g_reaped.end ())
+		{
+			status = reaped->second;
+		}
+		else if (waitpid (g_children[i], &status, 0) != g_children[i])
+		{
+			status = -1;
+		}
+
+		if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+		{
+			std::cerr << "Process " << i + 1 << " failed" << std::endl;
+			ok = false;
+		}
+	}
+
+	munmap (g_segment, g_segmentSize);
+	g_segment = 0;
+	g_children.clear ();
+	g_reaped.clear ();
+	g_enabled = false;
+
+	return ok;
+}
+
+bool
+ShmInterface::IsEnabled (void)
+{
+	return g_enabled;
+}
+
+uint32_t
+ShmInterface::GetSystemId (void)
+{
+	return g_systemId;
+}
+
+uint32_t
+ShmInterface::GetSize (void)
+{
+	return g_size;
+}
+
+void
+ShmInterface::SetMailboxSize (uint64_t bytes)
+{
+	NS_ASSERT_MSG (!g_enabled, "The mailbox size must be set before ShmInterface::Enable");
+	g_mailboxSize = bytes;
+}
+
+void
+ShmInterface::SetLookAhead (Time lookAhead)
+{
+	if (lookAhead.GetTimeStep () < g_lookAhead)
+	{
+		g_lookAhead = lookAhead.GetTimeStep ();
+	}
+}
+
+Time
+ShmInterface::GetLookAhead (void)
+{
+	return TimeStep (g_lookAhead);
+}
+
+void
+ShmInterface::SendPacket (Ptr<Packet> p, Time rxTime, uint32_t node, uint32_t dev)
+{
+	uint32_t to = NodeList::GetNode (node)->GetSystemId ();
+	Mailbox *box = GetMailbox (g_systemId, to);
+
+	uint32_t size = p->GetSerializedSize ();
+	uint64_t needed = (sizeof (Message) + size + 7) & ~(uint64_t)7;
+
+	if (box->used + needed > g_mailboxSize)
+	{
+		NS_FATAL_ERROR ("Mailbox from process " << g_systemId << " to " << to
+				<< " is full, raise it with ShmInterface::SetMailboxSize");
+	}
+
+	Message *message = reinterpret_cast<Message *> (GetData (box) + box->used);
+	message->rxTime = rxTime.GetTimeStep ();
+	message->node = node;
+	message->dev = dev;
+	message->size = size;
+
+	if (!p->Serialize (reinterpret_cast<uint8_t *> (message + 1), size))
+	{
+		NS_FATAL_ERROR ("Could not serialize packet for node " << node);
+	}
+
+	box->used += needed;
+	box->count++;
+}
+
+void
+ShmInterface::Barrier (void)
+{
+	Control *control = GetControl ();
+	uint32_t generation = control->generation;
+
+	if (control->arrived.fetch_add (1) + 1 == g_size)
+	{
+		control->arrived = 0;
+		control->generation++;
+		return;
+	}
+
+	// Windows are short when the processes are busy, so spin a little
+	// before giving the core away
+	for (uint32_t spins = 0; control->generation == generation; ++spins)
+	{
+		if (spins < 1000)
+		{
+			continue;
+		}
+
+		sched_yield ();
+
+		if (spins % 1024 == 0)
+		{
+			CheckProcesses ();
+		}
+	}
+}
+
+void
+ShmInterface::ReceiveMessages (void)
+{
+	// Fixed order of senders, so runs are repeatable
+	for (uint32_t from = 0; from < g_size; ++from)
+	{
+		if (from == g_systemId)
+		{
+			continue;
+		}
+
+		Mailbox *box = GetMailbox (from, g_systemId);
+		char *data = GetData (box);
+		uint64_t offset = 0;
+
+		for (uint64_t i = 0; i < box->count; ++i)
+		{
+			Message *message = reinterpret_cast<Message *> (data + offset);
+			offset += (sizeof (Message) + message->size + 7) & ~(uint64_t)7;
+
+			Ptr<Packet> p = Create<Packet> (reinterpret_cast<const uint8_t *> (message + 1), message->size, true);
+			Ptr<PointToPointNetDevice> dev = DynamicCast<PointToPointNetDevice> (NodeList::GetNode (message->node)->GetDevice (message->dev));
+			NS_ASSERT (dev != 0);
+
+			Simulator::ScheduleWithContext (message->node, TimeStep (message->rxTime) - Simulator::Now (),
+					&PointToPointNetDevice::Receive, dev, p);
+		}
+
+		box->used = 0;
+		box->count = 0;
+	}
+}
+
+Time
+ShmInterface::Exchange (Time next, bool localFinished, bool &finished)
+{
+	Slot *own = GetSlot (g_systemId);
+	own->next = next.GetTimeStep ();
+	own->finished = localFinished;
+
+	// Slots are only written again after the next window's barrier, which
+	// every process reaches after reading them
+	Barrier ();
+
+	int64_t smallest = kNever;
+	finished = true;
+
+	for (uint32_t i = 0; i < g_size; ++i)
+	{
+		Slot *slot = GetSlot (i);
+		if (slot->next < smallest)
+		{
+			smallest = slot->next;
+		}
+		finished = finished && slot->finished;
+	}
+
+	return TimeStep (smallest);
+}
+
+NS_OBJECT_ENSURE_REGISTERED (ShmPointToPointChannel);
+
+TypeId
+ShmPointToPointChannel::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::ShmPointToPointChannel")
+		.SetParent<PointToPointChannel> ()
+		.AddConstructor<ShmPointToPointChannel> ()
+		;
+	return tid;
+}
+
+ShmPointToPointChannel::ShmPointToPointChannel ()
+{
+}
+
+ShmPointToPointChannel::~ShmPointToPointChannel ()
+{
+}
+
+bool
+ShmPointToPointChannel::TransmitStart (Ptr<Packet> p, Ptr<PointToPointNetDevice> src, Time txTime)
+{
+	NS_ASSERT (IsInitialized ());
+
+	uint32_t wire = (src == GetSource (0)) ? 0 : 1;
+	Ptr<PointToPointNetDevice> dst = GetDestination (wire);
+
+	if (dst->GetNode ()->GetSystemId () == ShmInterface::GetSystemId ())
+	{
+		return PointToPointChannel::TransmitStart (p, src, txTime);
+	}
+
+	ShmInterface::SendPacket (p, Simulator::Now () + txTime + GetDelay (),
+			dst->GetNode ()->GetId (), dst->GetIfIndex ());
+	return true;
+}
+
+NetDeviceContainer
+ShmPointToPointChannel::Install (Ptr<Node> a, Ptr<Node> b, DataRate rate, Time delay)
+{
+	NetDeviceContainer devices;
+	Ptr<Node> nodes[2] = { a, b };
+
+	Ptr<ShmPointToPointChannel> channel = CreateObject<ShmPointToPointChannel> ();
+	channel->SetAttribute ("Delay", TimeValue (delay));
+
+	for (int i = 0; i < 2; ++i)
+	{
+		Ptr<PointToPointNetDevice> dev = CreateObject<PointToPointNetDevice> ();
+		dev->SetAddress (Mac48Address::Allocate ());
+		dev->SetAttribute ("DataRate", DataRateValue (rate));
+		nodes[i]->AddDevice (dev);
+		dev->SetQueue (CreateObject<DropTailQueue> ());
+		devices.Add (dev);
+	}
+
+	for (int i = 0; i < 2; ++i)
+	{
+		DynamicCast<PointToPointNetDevice> (devices.Get (i))->Attach (channel);
+	}
+
+	if (a->GetSystemId () != b->GetSystemId ())
+	{
+		ShmInterface::SetLookAhead (delay);
+	}
+
+	return devices;
+}
+
+} // namespace ns3
@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * shm-interface.h
+ *
+ *  Runs one simulation as several processes of the same machine, without
+ *  MPI. Enable () forks the processes, which share an anonymous memory
+ *  segment holding a barrier, the next event time of every process and one
+ *  mailbox for every pair of processes.
+ *
+ *  As with MPI every process builds the whole topology and only runs the
+ *  events of the nodes carrying its system id. Links between nodes of two
+ *  processes must be ShmPointToPointChannels, whose smallest delay is the
+ *  length of the windows ShmSimulatorImpl runs between synchronisations.
+ */
+
+#ifndef SHM_INTERFACE_H_
+#define SHM_INTERFACE_H_
+
+#include <stdint.h>
+
+#include <ns3-dev/ns3/data-rate.h>
+#include <ns3-dev/ns3/net-device-container.h>
+#include <ns3-dev/ns3/node.h>
+#include <ns3-dev/ns3/nstime.h>
+#include <ns3-dev/ns3/packet.h>
+#include <ns3-dev/ns3/point-to-point-channel.h>
+
+namespace ns3 {
+
+class ShmInterface
+{
+public:
+	// Forks processes - 1 children and selects ns3::ShmSimulatorImpl. Returns
+	// in every process, the calling one has system id 0. Call before any
+	// Node exists
+	static void Enable (uint32_t processes);
+
+	// Process 0 waits for the others and returns false if one of them
+	// failed, the others return true straight away
+	static bool Disable (void);
+
+	static bool IsEnabled (void);
+	static uint32_t GetSystemId (void);
+	static uint32_t GetSize (void);
+
+	// Bytes one process can send another within a window, 64 MB by default.
+	// Pages are only backed by memory once used. Call before Enable ()
+	static void SetMailboxSize (uint64_t bytes);
+
+	// Smallest delay of the channels between processes
+	static void SetLookAhead (Time lookAhead);
+	static Time GetLookAhead (void);
+
+	// Queues p for device dev of node, on the process owning node, to be
+	// received at rxTime
+	static void SendPacket (Ptr<Packet> p, Time rxTime, uint32_t node, uint32_t dev);
+
+	// The steps of one synchronisation, in this order. Barrier () returns
+	// once every process finished its window, ReceiveMessages () schedules
+	// the packets sent to this process and Exchange () returns the smallest
+	// next event time of all processes, setting finished when none of them
+	// has events left
+	static void Barrier (void);
+	static void ReceiveMessages (void);
+	static Time Exchange (Time next, bool localFinished, bool &finished);
+};
+
+/*
+ * Point to point channel whose two ends may belong to different processes.
+ * Packets for a remote device go through the mailbox of its process.
+ */
+class ShmPointToPointChannel : public PointToPointChannel
+{
+public:
+	static TypeId GetTypeId (void);
+
+	ShmPointToPointChannel ();
+	virtual ~ShmPointToPointChannel ();
+
+	virtual bool TransmitStart (Ptr<Packet> p, Ptr<PointToPointNetDevice> src, Time txTime);
+
+	// Same as PointToPointHelper::Install (a, b) with a DropTailQueue, but
+	// with this channel between the devices
+	static NetDeviceContainer Install (Ptr<Node> a, Ptr<Node> b, DataRate rate, Time delay);
+};
+
+} // namespace ns3
+
+#endif /* SHM_INTERFACE_H_ */
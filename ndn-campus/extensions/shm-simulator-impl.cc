@@ -0,0 +1,367 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * shm-simulator-impl.cc
+ *
+ *  Conservative parallel simulator for the processes of ShmInterface.
+ */
+
+#include "shm-simulator-impl.h"
+#include "shm-interface.h"
+
+#include <ns3-dev/ns3/assert.h>
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/simulator.h>
+
+NS_LOG_COMPONENT_DEFINE ("ShmSimulatorImpl");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (ShmSimulatorImpl);
+
+TypeId
+ShmSimulatorImpl::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::ShmSimulatorImpl")
+		.SetParent<SimulatorImpl> ()
+		.AddConstructor<ShmSimulatorImpl> ()
+		;
+	return tid;
+}
+
+ShmSimulatorImpl::ShmSimulatorImpl ()
+: m_stop (false)
+, m_globalFinished (false)
+// uids are allocated from 4: 0 is invalid, 1 now, 2 destroy
+, m_uid (4)
+, m_currentUid (0)
+, m_currentTs (0)
+, m_currentContext (0xffffffff)
+, m_unscheduledEvents (0)
+, m_grantedTime (Seconds (0))
+, m_windows (0)
+{
+	NS_ASSERT_MSG (ShmInterface::IsEnabled (), "ShmSimulatorImpl needs ShmInterface::Enable");
+}
+
+ShmSimulatorImpl::~ShmSimulatorImpl ()
+{
+}
+
+void
+ShmSimulatorImpl::DoDispose (void)
+{
+	while (!m_events->IsEmpty ())
+	{
+		Scheduler::Event next = m_events->RemoveNext ();
+		next.impl->Unref ();
+	}
+	m_events = 0;
+	SimulatorImpl::DoDispose ();
+}
+
+void
+ShmSimulatorImpl::Destroy ()
+{
+	while (!m_destroyEvents.empty ())
+	{
+		Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+		m_destroyEvents.pop_front ();
+		NS_LOG_LOGIC ("handle destroy " << ev);
+		if (!ev->IsCancelled ())
+		{
+			ev->Invoke ();
+		}
+	}
+}
+
+void
+ShmSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+	Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+
+	if (m_events != 0)
+	{
+		while (!m_events->IsEmpty ())
+		{
+			Scheduler::Event next = m_events->RemoveNext ();
+			scheduler->Insert (next);
+		}
+	}
+	m_events = scheduler;
+}
+
+void
+ShmSimulatorImpl::ProcessOneEvent (void)
+{
+	Scheduler::Event next = m_events->RemoveNext ();
+
+	NS_ASSERT (next.key.m_ts >= m_currentTs);
+	m_unscheduledEvents--;
+
+	m_currentTs = next.key.m_ts;
+	m_currentContext = next.key.m_context;
+	m_currentUid = next.key.m_uid;
+	next.impl->Invoke ();
+	next.impl->Unref ();
+}
+
+bool
+ShmSimulatorImpl::IsFinished (void) const
+{
+	return m_globalFinished;
+}
+
+bool
+ShmSimulatorImpl::IsLocalFinished (void) const
+{
+	return m_events->IsEmpty () || m_stop;
+}
+
+Time
+ShmSimulatorImpl::Next (void) const
+{
+	if (m_events->IsEmpty ())
+	{
+		return GetMaximumSimulationTime ();
+	}
+
+	return TimeStep (m_events->PeekNext ().key.m_ts);
+}
+
+void
+ShmSimulatorImpl::Run (void)
+{
+	Time lookAhead = ShmInterface::GetLookAhead ();
+
+	m_stop = false;
+	m_globalFinished = false;
+
+	while (!m_globalFinished)
+	{
+		Time next = Next ();
+
+		// Past the granted time a packet from another process may still
+		// arrive earlier than our next event, so wait for the others. A
+		// finished process keeps synchronising until all are finished
+		if (next > m_grantedTime || IsLocalFinished ())
+		{
+			ShmInterface::Barrier ();
+			ShmInterface::ReceiveMessages ();
+
+			Time smallest = ShmInterface::Exchange (Next (), IsLocalFinished (), m_globalFinished);
+
+			if (lookAhead == GetMaximumSimulationTime ()
+					|| smallest > GetMaximumSimulationTime () - lookAhead)
+			{
+				m_grantedTime = GetMaximumSimulationTime ();
+			}
+			else
+			{
+				m_grantedTime = smallest + lookAhead;
+			}
+
+			m_windows++;
+			continue;
+		}
+
+		ProcessOneEvent ();
+	}
+
+	NS_LOG_INFO ("Process " << GetSystemId () << " finished after " << m_windows << " windows");
+}
+
+uint64_t
+ShmSimulatorImpl::GetWindows (void) const
+{
+	return m_windows;
+}
+
+void
+ShmSimulatorImpl::Stop (void)
+{
+	m_stop = true;
+}
+
+void
+ShmSimulatorImpl::Stop (Time const &time)
+{
+	Simulator::Schedule (time, &Simulator::Stop);
+}
+
+EventId
+ShmSimulatorImpl::Schedule (Time const &time, EventImpl *event)
+{
+	Time tAbsolute = time + TimeStep (m_currentTs);
+
+	NS_ASSERT (tAbsolute.IsPositive ());
+	NS_ASSERT (tAbsolute >= TimeStep (m_currentTs));
+
+	Scheduler::Event ev;
+	ev.impl = event;
+	ev.key.m_ts = static_cast<uint64_t> (tAbsolute.GetTimeStep ());
+	ev.key.m_context = GetContext ();
+	ev.key.m_uid = m_uid;
+	m_uid++;
+	m_unscheduledEvents++;
+	m_events->Insert (ev);
+	return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+ShmSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event)
+{
+	NS_ASSERT (time.IsPositive ());
+
+	Scheduler::Event ev;
+	ev.impl = event;
+	ev.key.m_ts = m_currentTs + time.GetTimeStep ();
+	ev.key.m_context = context;
+	ev.key.m_uid = m_uid;
+	m_uid++;
+	m_unscheduledEvents++;
+	m_events->Insert (ev);
+}
+
+EventId
+ShmSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+	Scheduler::Event ev;
+	ev.impl = event;
+	ev.key.m_ts = m_currentTs;
+	ev.key.m_context = GetContext ();
+	ev.key.m_uid = m_uid;
+	m_uid++;
+	m_unscheduledEvents++;
+	m_events->Insert (ev);
+	return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+EventId
+ShmSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+	EventId id (Ptr<EventImpl> (event, false), m_currentTs, 0xffffffff, 2);
+	m_destroyEvents.push_back (id);
+	m_uid++;
+	return id;
+}
+
+Time
+ShmSimulatorImpl::Now (void) const
+{
+	return TimeStep (m_currentTs);
+}
+
+Time
+ShmSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+	if (IsExpired (id))
+	{
+		return TimeStep (0);
+	}
+
+	return TimeStep (id.GetTs () - m_currentTs);
+}
+
+void
+ShmSimulatorImpl::Remove (const EventId &id)
+{
+	if (id.GetUid () == 2)
+	{
+		// destroy events.
+		for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+		{
+			if (*i == id)
+			{
+				m_destroyEvents.erase (i);
+				break;
+			}
+		}
+		return;
+	}
+
+	if (IsExpired (id))
+	{
+		return;
+	}
+
+	Scheduler::Event event;
+	event.impl = id.PeekEventImpl ();
+	event.key.m_ts = id.GetTs ();
+	event.key.m_context = id.GetContext ();
+	event.key.m_uid = id.GetUid ();
+	m_events->Remove (event);
+	event.impl->Cancel ();
+	// whenever we remove an event from the event list, we have to unref it.
+	event.impl->Unref ();
+
+	m_unscheduledEvents--;
+}
+
+void
+ShmSimulatorImpl::Cancel (const EventId &id)
+{
+	if (!IsExpired (id))
+	{
+		id.PeekEventImpl ()->Cancel ();
+	}
+}
+
+bool
+ShmSimulatorImpl::IsExpired (const EventId &ev) const
+{
+	if (ev.GetUid () == 2)
+	{
+		if (ev.PeekEventImpl () == 0 || ev.PeekEventImpl ()->IsCancelled ())
+		{
+			return true;
+		}
+
+		// destroy events.
+		for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+		{
+			if (*i == ev)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	return ev.PeekEventImpl () == 0
+		|| ev.GetTs () < m_currentTs
+		|| (ev.GetTs () == m_currentTs && ev.GetUid () <= m_currentUid)
+		|| ev.PeekEventImpl ()->IsCancelled ();
+}
+
+Time
+ShmSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+	return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+ShmSimulatorImpl::GetSystemId (void) const
+{
+	return ShmInterface::GetSystemId ();
+}
+
+uint32_t
+ShmSimulatorImpl::GetContext (void) const
+{
+	return m_currentContext;
+}
+
+} // namespace ns3
@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * shm-simulator-impl.h
+ *
+ *  Conservative parallel simulator for the processes of ShmInterface. It
+ *  follows DistributedSimulatorImpl: events are run up to a granted time,
+ *  the smallest next event time of all processes plus the lookahead, then
+ *  every process waits for the others, takes in the packets sent to it and
+ *  agrees on the next granted time.
+ */
+
+#ifndef SHM_SIMULATOR_IMPL_H_
+#define SHM_SIMULATOR_IMPL_H_
+
+#include <list>
+
+#include <ns3-dev/ns3/event-id.h>
+#include <ns3-dev/ns3/event-impl.h>
+#include <ns3-dev/ns3/nstime.h>
+#include <ns3-dev/ns3/ptr.h>
+#include <ns3-dev/ns3/scheduler.h>
+#include <ns3-dev/ns3/simulator-impl.h>
+
+namespace ns3 {
+
+class ShmSimulatorImpl : public SimulatorImpl
+{
+public:
+	static TypeId GetTypeId (void);
+
+	ShmSimulatorImpl ();
+	virtual ~ShmSimulatorImpl ();
+
+	virtual void Destroy ();
+	virtual bool IsFinished (void) const;
+	virtual void Stop (void);
+	virtual void Stop (Time const &time);
+	virtual EventId Schedule (Time const &time, EventImpl *event);
+	virtual void ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event);
+	virtual EventId ScheduleNow (EventImpl *event);
+	virtual EventId ScheduleDestroy (EventImpl *event);
+	virtual void Remove (const EventId &id);
+	virtual void Cancel (const EventId &id);
+	virtual bool IsExpired (const EventId &id) const;
+	virtual void Run (void);
+	virtual Time Now (void) const;
+	virtual Time GetDelayLeft (const EventId &id) const;
+	virtual Time GetMaximumSimulationTime (void) const;
+	virtual void SetScheduler (ObjectFactory schedulerFactory);
+	virtual uint32_t GetSystemId (void) const;
+	virtual uint32_t GetContext (void) const;
+
+	// Number of synchronisations done by Run ()
+	uint64_t GetWindows (void) const;
+
+private:
+	virtual void DoDispose (void);
+
+	void ProcessOneEvent (void);
+	Time Next (void) const;
+	bool IsLocalFinished (void) const;
+
+	typedef std::list<EventId> DestroyEvents;
+
+	DestroyEvents m_destroyEvents;
+	bool m_stop;
+	bool m_globalFinished;
+	Ptr<Scheduler> m_events;
+	uint32_t m_uid;
+	uint32_t m_currentUid;
+	uint64_t m_currentTs;
+	uint32_t m_currentContext;
+	int m_unscheduledEvents;
+	Time m_grantedTime;
+	uint64_t m_windows;
+};
+
+} // namespace ns3
+
+#endif /* SHM_SIMULATOR_IMPL_H_ */
@@ -0,0 +1,251 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * unit-disk-channel.cc
+ *
+ *  Range based delivery between UnitDiskNetDevices.
+ */
+
+#include "unit-disk-channel.h"
+
+#include <cmath>
+
+#include <ns3-dev/ns3/abort.h>
+#include <ns3-dev/ns3/boolean.h>
+#include <ns3-dev/ns3/double.h>
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/node.h>
+#include <ns3-dev/ns3/simulator.h>
+
+#include "unit-disk-net-device.h"
+
+NS_LOG_COMPONENT_DEFINE ("UnitDiskChannel");
+
+namespace ns3 {
+
+namespace {
+
+const double kSpeedOfLight = 299792458.0;
+
+uint64_t
+MakeCell (int32_t x, int32_t y)
+{
+	return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
+
+} // anonymous namespace
+
+NS_OBJECT_ENSURE_REGISTERED (UnitDiskChannel);
+
+TypeId
+UnitDiskChannel::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::UnitDiskChannel")
+		.SetParent<Channel> ()
+		.AddConstructor<UnitDiskChannel> ()
+		.AddAttribute ("Range",
+				"Meters up to which frames are received",
+				DoubleValue (100.0),
+				MakeDoubleAccessor (&UnitDiskChannel::m_range),
+				MakeDoubleChecker<double> (0.0))
+		.AddAttribute ("LossRate",
+				"Probability of a receiver in range missing a frame",
+				DoubleValue (0.0),
+				MakeDoubleAccessor (&UnitDiskChannel::m_lossRate),
+				MakeDoubleChecker<double> (0.0, 1.0))
+		.AddAttribute ("Collisions",
+				"Lose frames overlapping at a receiver",
+				BooleanValue (true),
+				MakeBooleanAccessor (&UnitDiskChannel::m_collisions),
+				MakeBooleanChecker ())
+		.AddAttribute ("Margin",
+				"Meters added to the cell size, more than twice what a node travels in UpdateInterval",
+				DoubleValue (20.0),
+				MakeDoubleAccessor (&UnitDiskChannel::m_margin),
+				MakeDoubleChecker<double> (0.0))
+		.AddAttribute ("UpdateInterval",
+				"Longest time between two cell indexes of the devices, zero for no index",
+				TimeValue (Seconds (0.5)),
+				MakeTimeAccessor (&UnitDiskChannel::m_updateInterval),
+				MakeTimeChecker ())
+		;
+	return tid;
+}
+
+UnitDiskChannel::UnitDiskChannel ()
+	: m_random (CreateObject<UniformRandomVariable> ())
+	, m_indexed (false)
+{
+}
+
+UnitDiskChannel::~UnitDiskChannel ()
+{
+}
+
+uint32_t
+UnitDiskChannel::Add (Ptr<UnitDiskNetDevice> device)
+{
+	Member member;
+	member.device = device;
+	m_members.push_back (member);
+	m_indexed = false;
+	return m_members.size () - 1;
+}
+
+bool
+UnitDiskChannel::GetCollisions (void) const
+{
+	return m_collisions;
+}
+
+double
+UnitDiskChannel::GetRange (void) const
+{
+	return m_range;
+}
+
+int64_t
+UnitDiskChannel::AssignStreams (int64_t stream)
+{
+	m_random->SetStream (stream);
+	return 1;
+}
+
+uint32_t
+UnitDiskChannel::GetNDevices (void) const
+{
+	return m_members.size ();
+}
+
+Ptr<NetDevice>
+UnitDiskChannel::GetDevice (uint32_t i) const
+{
+	return m_members[i].device;
+}
+
+void
+UnitDiskChannel::DoDispose (void)
+{
+	m_members.clear ();
+	m_cells.clear ();
+	m_random = 0;
+	Channel::DoDispose ();
+}
+
+Ptr<MobilityModel>
+UnitDiskChannel::GetMobility (uint32_t member)
+{
+	// Mobility is usually installed after the devices
+	Member &m = m_members[member];
+	if (m.mobility == 0)
+	{
+		m.mobility = m.device->GetNode ()->GetObject<MobilityModel> ();
+		NS_ABORT_MSG_UNLESS (m.mobility != 0, "Node " << m.device->GetNode ()->GetId ()
+				<< " on a UnitDiskChannel has no MobilityModel");
+	}
+	return m.mobility;
+}
+
+uint64_t
+UnitDiskChannel::GetCell (const Vector &position) const
+{
+	double size = m_range + m_margin;
+	return MakeCell ((int32_t)std::floor (position.x / size), (int32_t)std::floor (position.y / size));
+}
+
+void
+UnitDiskChannel::Index (void)
+{
+	m_cells.clear ();
+	for (uint32_t i = 0; i < m_members.size (); i++)
+	{
+		m_cells[GetCell (GetMobility (i)->GetPosition ())].push_back (i);
+	}
+	m_indexed = true;
+	m_indexTime = Simulator::Now ();
+
+	NS_LOG_DEBUG ("Indexed " << m_members.size () << " devices in " << m_cells.size () << " cells");
+}
+
+void
+UnitDiskChannel::Send (uint32_t sender, Ptr<const Packet> packet, uint16_t protocol,
+		Mac48Address to, Mac48Address from, Time duration)
+{
+	if (m_updateInterval.IsZero ())
+	{
+		for (uint32_t i = 0; i < m_members.size (); i++)
+		{
+			Deliver (sender, i, packet, protocol, to, from, duration);
+		}
+		return;
+	}
+
+	if (!m_indexed || Simulator::Now () - m_indexTime >= m_updateInterval)
+	{
+		Index ();
+	}
+
+	// Nodes are within Margin / 2 of where they were indexed, so any
+	// receiver in range is indexed in one of the 3x3 cells around the sender
+	double size = m_range + m_margin;
+	Vector position = GetMobility (sender)->GetPosition ();
+	int32_t x = (int32_t)std::floor (position.x / size);
+	int32_t y = (int32_t)std::floor (position.y / size);
+
+	for (int32_t dx = -1; dx <= 1; dx++)
+	{
+		for (int32_t dy = -1; dy <= 1; dy++)
+		{
+			std::map<uint64_t, std::vector<uint32_t> >::const_iterator c = m_cells.find (MakeCell (x + dx, y + dy));
+			if (c == m_cells.end ())
+			{
+				continue;
+			}
+
+			for (size_t i = 0; i < c->second.size (); i++)
+			{
+				Deliver (sender, c->second[i], packet, protocol, to, from, duration);
+			}
+		}
+	}
+}
+
+void
+UnitDiskChannel::Deliver (uint32_t sender, uint32_t receiver, Ptr<const Packet> packet, uint16_t protocol,
+		Mac48Address to, Mac48Address from, Time duration)
+{
+	if (receiver == sender)
+	{
+		return;
+	}
+
+	double distance = GetMobility (sender)->GetDistanceFrom (GetMobility (receiver));
+	if (distance > m_range)
+	{
+		return;
+	}
+
+	if (m_lossRate > 0 && m_random->GetValue () < m_lossRate)
+	{
+		NS_LOG_LOGIC ("Frame from " << from << " lost on the way to device " << receiver);
+		return;
+	}
+
+	Ptr<UnitDiskNetDevice> device = m_members[receiver].device;
+	Simulator::ScheduleWithContext (device->GetNode ()->GetId (), Seconds (distance / kSpeedOfLight),
+			&UnitDiskNetDevice::StartReceive, device, packet->Copy (), protocol, to, from, duration);
+}
+
+} // namespace ns3
@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * unit-disk-channel.h
+ *
+ *  Broadcast medium of UnitDiskNetDevices. A frame reaches every device
+ *  within Range of the sender, after the speed of light delay, unless it is
+ *  dropped with probability LossRate. There is no fading, interference or
+ *  capture: with Collisions, frames overlapping at a receiver are all lost.
+ *
+ *  Devices are looked up in a grid of cells of Range + Margin meters,
+ *  rebuilt at most every UpdateInterval, so a transmission costs in
+ *  proportion to the devices around the sender. Margin must be more than
+ *  twice the distance a node travels in UpdateInterval. An UpdateInterval
+ *  of zero checks every device on every frame.
+ */
+
+#ifndef UNIT_DISK_CHANNEL_H_
+#define UNIT_DISK_CHANNEL_H_
+
+#include <map>
+#include <stdint.h>
+#include <vector>
+
+#include <ns3-dev/ns3/channel.h>
+#include <ns3-dev/ns3/mac48-address.h>
+#include <ns3-dev/ns3/mobility-model.h>
+#include <ns3-dev/ns3/nstime.h>
+#include <ns3-dev/ns3/packet.h>
+#include <ns3-dev/ns3/random-variable-stream.h>
+
+namespace ns3 {
+
+class UnitDiskNetDevice;
+
+class UnitDiskChannel : public Channel
+{
+public:
+	static TypeId GetTypeId (void);
+
+	UnitDiskChannel ();
+	virtual ~UnitDiskChannel ();
+
+	// Returns the index the device sends with
+	uint32_t Add (Ptr<UnitDiskNetDevice> device);
+
+	// Delivers packet, which takes duration to transmit, to the devices in
+	// range of device sender
+	void Send (uint32_t sender, Ptr<const Packet> packet, uint16_t protocol,
+			Mac48Address to, Mac48Address from, Time duration);
+
+	bool GetCollisions (void) const;
+	double GetRange (void) const;
+
+	// Uses stream for the loss draws, returns the number of streams used
+	int64_t AssignStreams (int64_t stream);
+
+	virtual uint32_t GetNDevices (void) const;
+	virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
+
+protected:
+	virtual void DoDispose (void);
+
+private:
+	struct Member
+	{
+		Ptr<UnitDiskNetDevice> device;
+		Ptr<MobilityModel> mobility;
+	};
+
+	Ptr<MobilityModel> GetMobility (uint32_t member);
+	uint64_t GetCell (const Vector &position) const;
+	void Index (void);
+	void Deliver (uint32_t sender, uint32_t receiver, Ptr<const Packet> packet, uint16_t protocol,
+			Mac48Address to, Mac48Address from, Time duration);
+
+	double m_range;
+	double m_margin;
+	double m_lossRate;
+	bool m_collisions;
+	Time m_updateInterval;
+	Ptr<UniformRandomVariable> m_random;
+
+	std::vector<Member> m_members;
+	std::map<uint64_t, std::vector<uint32_t> > m_cells;
+	bool m_indexed;
+	Time m_indexTime;
+};
+
+} // namespace ns3
+
+#endif /* UNIT_DISK_CHANNEL_H_ */
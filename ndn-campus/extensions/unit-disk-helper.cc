@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * unit-disk-helper.cc
+ *
+ *  Installs UnitDiskNetDevices on one shared UnitDiskChannel.
+ */
+
+#include "unit-disk-helper.h"
+
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/node.h>
+
+#include "unit-disk-net-device.h"
+
+NS_LOG_COMPONENT_DEFINE ("UnitDiskHelper");
+
+namespace ns3 {
+
+UnitDiskHelper::UnitDiskHelper ()
+{
+	m_channelFactory.SetTypeId ("ns3::UnitDiskChannel");
+	m_deviceFactory.SetTypeId ("ns3::UnitDiskNetDevice");
+}
+
+void
+UnitDiskHelper::SetChannelAttribute (const std::string &name, const AttributeValue &value)
+{
+	m_channelFactory.Set (name, value);
+	if (m_channel != 0)
+	{
+		m_channel->SetAttribute (name, value);
+	}
+}
+
+void
+UnitDiskHelper::SetDeviceAttribute (const std::string &name, const AttributeValue &value)
+{
+	m_deviceFactory.Set (name, value);
+}
+
+Ptr<UnitDiskChannel>
+UnitDiskHelper::GetChannel (void)
+{
+	if (m_channel == 0)
+	{
+		m_channel = m_channelFactory.Create<UnitDiskChannel> ();
+	}
+	return m_channel;
+}
+
+NetDeviceContainer
+UnitDiskHelper::Install (Ptr<Node> node)
+{
+	Ptr<UnitDiskNetDevice> device = m_deviceFactory.Create<UnitDiskNetDevice> ();
+	node->AddDevice (device);
+	device->SetChannel (GetChannel ());
+	return NetDeviceContainer (device);
+}
+
+NetDeviceContainer
+UnitDiskHelper::Install (const NodeContainer &nodes)
+{
+	NetDeviceContainer devices;
+	for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+	{
+		devices.Add (Install (*i));
+	}
+
+	NS_LOG_INFO ("Installed " << nodes.GetN () << " devices, " << GetChannel ()->GetNDevices ()
+			<< " on the channel");
+	return devices;
+}
+
+int64_t
+UnitDiskHelper::AssignStreams (const NetDeviceContainer &devices, int64_t stream)
+{
+	int64_t current = stream;
+	for (NetDeviceContainer::Iterator i = devices.Begin (); i != devices.End (); ++i)
+	{
+		Ptr<UnitDiskNetDevice> device = DynamicCast<UnitDiskNetDevice> (*i);
+		if (device != 0)
+		{
+			current += device->AssignStreams (current);
+		}
+	}
+	current += GetChannel ()->AssignStreams (current);
+	return current - stream;
+}
+
+} // namespace ns3
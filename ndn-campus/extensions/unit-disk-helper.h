@@ -0,0 +1,68 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * unit-disk-helper.h
+ *
+ *  Installs UnitDiskNetDevices in place of a WifiHelper. Every Install ()
+ *  of a helper puts the devices on the same UnitDiskChannel, created with
+ *  the channel attributes set so far:
+ *
+ *    UnitDiskHelper unitDisk;
+ *    unitDisk.SetChannelAttribute ("Range", DoubleValue (150));
+ *    unitDisk.SetDeviceAttribute ("DataRate", StringValue ("6Mbps"));
+ *    NetDeviceContainer devices = unitDisk.Install (nodes);
+ */
+
+#ifndef UNIT_DISK_HELPER_H_
+#define UNIT_DISK_HELPER_H_
+
+#include <string>
+
+#include <ns3-dev/ns3/attribute.h>
+#include <ns3-dev/ns3/net-device-container.h>
+#include <ns3-dev/ns3/node-container.h>
+#include <ns3-dev/ns3/object-factory.h>
+
+#include "unit-disk-channel.h"
+
+namespace ns3 {
+
+class UnitDiskHelper
+{
+public:
+	UnitDiskHelper ();
+
+	void SetChannelAttribute (const std::string &name, const AttributeValue &value);
+	void SetDeviceAttribute (const std::string &name, const AttributeValue &value);
+
+	NetDeviceContainer Install (Ptr<Node> node);
+	NetDeviceContainer Install (const NodeContainer &nodes);
+
+	// Channel of the devices installed by this helper
+	Ptr<UnitDiskChannel> GetChannel (void);
+
+	// Uses streams from stream on for the devices installed so far and
+	// their channel, returns the number of streams used
+	int64_t AssignStreams (const NetDeviceContainer &devices, int64_t stream);
+
+private:
+	ObjectFactory m_channelFactory;
+	ObjectFactory m_deviceFactory;
+	Ptr<UnitDiskChannel> m_channel;
+};
+
+} // namespace ns3
+
+#endif /* UNIT_DISK_HELPER_H_ */
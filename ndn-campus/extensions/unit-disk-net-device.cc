@@ -0,0 +1,444 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * unit-disk-net-device.cc
+ *
+ *  Queue, carrier sense and collisions of a UnitDiskNetDevice.
+ */
+
+#include "unit-disk-net-device.h"
+
+#include <algorithm>
+
+#include <ns3-dev/ns3/abort.h>
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/node.h>
+#include <ns3-dev/ns3/simulator.h>
+#include <ns3-dev/ns3/trace-source-accessor.h>
+#include <ns3-dev/ns3/uinteger.h>
+
+NS_LOG_COMPONENT_DEFINE ("UnitDiskNetDevice");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (UnitDiskNetDevice);
+
+TypeId
+UnitDiskNetDevice::GetTypeId (void)
+{
+	static TypeId tid = TypeId ("ns3::UnitDiskNetDevice")
+		.SetParent<NetDevice> ()
+		.AddConstructor<UnitDiskNetDevice> ()
+		.AddAttribute ("DataRate",
+				"Rate frames are transmitted at",
+				DataRateValue (DataRate ("6Mbps")),
+				MakeDataRateAccessor (&UnitDiskNetDevice::m_dataRate),
+				MakeDataRateChecker ())
+		.AddAttribute ("QueueSize",
+				"Frames waiting to be transmitted beyond which new ones are dropped",
+				UintegerValue (100),
+				MakeUintegerAccessor (&UnitDiskNetDevice::m_queueSize),
+				MakeUintegerChecker<uint32_t> (1))
+		.AddAttribute ("Difs",
+				"Idle time sensed before each frame, the 802.11a DIFS by default",
+				TimeValue (MicroSeconds (34)),
+				MakeTimeAccessor (&UnitDiskNetDevice::m_difs),
+				MakeTimeChecker ())
+		.AddAttribute ("MaxBackoff",
+				"Longest random wait after Difs, zero for none",
+				TimeValue (MicroSeconds (135)),
+				MakeTimeAccessor (&UnitDiskNetDevice::m_maxBackoff),
+				MakeTimeChecker ())
+		.AddAttribute ("Mtu",
+				"Largest payload of a frame",
+				UintegerValue (2296),
+				MakeUintegerAccessor (&UnitDiskNetDevice::SetMtu, &UnitDiskNetDevice::GetMtu),
+				MakeUintegerChecker<uint16_t> (1))
+		.AddTraceSource ("MacTx",
+				"Frame accepted for transmission",
+				MakeTraceSourceAccessor (&UnitDiskNetDevice::m_macTxTrace))
+		.AddTraceSource ("MacTxDrop",
+				"Frame dropped because the queue is full",
+				MakeTraceSourceAccessor (&UnitDiskNetDevice::m_macTxDropTrace))
+		.AddTraceSource ("MacRx",
+				"Frame received and passed up",
+				MakeTraceSourceAccessor (&UnitDiskNetDevice::m_macRxTrace))
+		.AddTraceSource ("PhyRxDrop",
+				"Frame lost in a collision",
+				MakeTraceSourceAccessor (&UnitDiskNetDevice::m_phyRxDropTrace))
+		;
+	return tid;
+}
+
+UnitDiskNetDevice::UnitDiskNetDevice ()
+	: m_channelIndex (0)
+	, m_ifIndex (0)
+	, m_address (Mac48Address::Allocate ())
+	, m_mtu (2296)
+	, m_backoff (CreateObject<UniformRandomVariable> ())
+	, m_transmitting (false)
+{
+}
+
+UnitDiskNetDevice::~UnitDiskNetDevice ()
+{
+}
+
+void
+UnitDiskNetDevice::SetChannel (Ptr<UnitDiskChannel> channel)
+{
+	m_channel = channel;
+	m_channelIndex = channel->Add (this);
+}
+
+int64_t
+UnitDiskNetDevice::AssignStreams (int64_t stream)
+{
+	m_backoff->SetStream (stream);
+	return 1;
+}
+
+void
+UnitDiskNetDevice::DoDispose (void)
+{
+	m_transmit.Cancel ();
+	m_queue.clear ();
+	m_receptions.clear ();
+	m_node = 0;
+	m_channel = 0;
+	m_backoff = 0;
+	m_rxCallback = MakeNullCallback<bool, Ptr<NetDevice>, Ptr<const Packet>, uint16_t, const Address &> ();
+	m_promiscRxCallback = MakeNullCallback<bool, Ptr<NetDevice>, Ptr<const Packet>, uint16_t,
+			const Address &, const Address &, NetDevice::PacketType> ();
+	NetDevice::DoDispose ();
+}
+
+bool
+UnitDiskNetDevice::IsBusy (void)
+{
+	Time now = Simulator::Now ();
+	while (!m_receptions.empty () && m_receptions.front ()->end <= now)
+	{
+		m_receptions.erase (m_receptions.begin ());
+	}
+	return !m_receptions.empty ();
+}
+
+bool
+UnitDiskNetDevice::SendFrom (Ptr<Packet> packet, const Address &source, const Address &dest,
+		uint16_t protocolNumber)
+{
+	NS_LOG_FUNCTION (this << packet << source << dest << protocolNumber);
+	NS_ABORT_MSG_UNLESS (m_channel != 0, "UnitDiskNetDevice of node " << m_node->GetId () << " has no channel");
+
+	if (m_queue.size () >= m_queueSize)
+	{
+		m_macTxDropTrace (packet);
+		return false;
+	}
+
+	Frame frame;
+	frame.packet = packet;
+	frame.protocol = protocolNumber;
+	frame.to = Mac48Address::ConvertFrom (dest);
+	frame.from = Mac48Address::ConvertFrom (source);
+	m_queue.push_back (frame);
+	m_macTxTrace (packet);
+
+	if (!m_transmitting && !m_transmit.IsRunning ())
+	{
+		Defer ();
+	}
+	return true;
+}
+
+bool
+UnitDiskNetDevice::Send (Ptr<Packet> packet, const Address &dest, uint16_t protocolNumber)
+{
+	return SendFrom (packet, m_address, dest, protocolNumber);
+}
+
+void
+UnitDiskNetDevice::Defer (void)
+{
+	if (m_queue.empty ())
+	{
+		return;
+	}
+
+	// Wait for the end of what we hear, if anything, then Difs and a backoff.
+	// Relays of one broadcast hear it end together and must not send together
+	Time wait = m_difs;
+	if (IsBusy ())
+	{
+		Time end = m_receptions.front ()->end;
+		for (size_t i = 1; i < m_receptions.size (); i++)
+		{
+			end = std::max (end, m_receptions[i]->end);
+		}
+		wait += end - Simulator::Now ();
+	}
+	if (!m_maxBackoff.IsZero ())
+	{
+		wait += Seconds (m_backoff->GetValue (0, m_maxBackoff.GetSeconds ()));
+	}
+
+	m_transmit = Simulator::Schedule (wait, &UnitDiskNetDevice::TryTransmit, this);
+}
+
+void
+UnitDiskNetDevice::TryTransmit (void)
+{
+	if (m_queue.empty ())
+	{
+		return;
+	}
+
+	// Carrier sense: someone started during our wait
+	if (IsBusy ())
+	{
+		Defer ();
+		return;
+	}
+
+	Frame frame = m_queue.front ();
+	m_queue.pop_front ();
+
+	Time duration = Seconds (m_dataRate.CalculateTxTime (frame.packet->GetSize ()));
+	m_transmitting = true;
+
+	m_channel->Send (m_channelIndex, frame.packet, frame.protocol, frame.to, frame.from, duration);
+	m_transmit = Simulator::Schedule (duration, &UnitDiskNetDevice::TransmitComplete, this);
+}
+
+void
+UnitDiskNetDevice::TransmitComplete (void)
+{
+	m_transmitting = false;
+	Defer ();
+}
+
+void
+UnitDiskNetDevice::StartReceive (Ptr<Packet> packet, uint16_t protocol, Mac48Address to, Mac48Address from,
+		Time duration)
+{
+	Ptr<Reception> reception = Create<Reception> ();
+	reception->end = Simulator::Now () + duration;
+	reception->collided = false;
+
+	// Half duplex: nothing is received while sending, with or without
+	// collisions
+	if (m_transmitting)
+	{
+		reception->collided = true;
+	}
+
+	// Frames heard at the same time garble each other
+	if (m_channel->GetCollisions () && IsBusy ())
+	{
+		reception->collided = true;
+		for (size_t i = 0; i < m_receptions.size (); i++)
+		{
+			m_receptions[i]->collided = true;
+		}
+	}
+
+	// Kept sorted by end, IsBusy () drops the finished ones from the front
+	std::vector<Ptr<Reception> >::iterator i = m_receptions.end ();
+	while (i != m_receptions.begin () && (*(i - 1))->end > reception->end)
+	{
+		--i;
+	}
+	m_receptions.insert (i, reception);
+
+	Simulator::Schedule (duration, &UnitDiskNetDevice::EndReceive, this, packet, protocol, to, from, reception);
+}
+
+void
+UnitDiskNetDevice::EndReceive (Ptr<Packet> packet, uint16_t protocol, Mac48Address to, Mac48Address from,
+		Ptr<Reception> reception)
+{
+	if (reception->collided)
+	{
+		NS_LOG_LOGIC ("Frame from " << from << " lost in a collision or while transmitting");
+		m_phyRxDropTrace (packet);
+		return;
+	}
+
+	NetDevice::PacketType type;
+	if (to.IsBroadcast ())
+	{
+		type = NetDevice::PACKET_BROADCAST;
+	}
+	else if (to.IsGroup ())
+	{
+		type = NetDevice::PACKET_MULTICAST;
+	}
+	else if (to == m_address)
+	{
+		type = NetDevice::PACKET_HOST;
+	}
+	else
+	{
+		type = NetDevice::PACKET_OTHERHOST;
+	}
+
+	m_macRxTrace (packet);
+
+	if (!m_promiscRxCallback.IsNull ())
+	{
+		m_promiscRxCallback (this, packet, protocol, from, to, type);
+	}
+
+	if (type != NetDevice::PACKET_OTHERHOST && !m_rxCallback.IsNull ())
+	{
+		m_rxCallback (this, packet, protocol, from);
+	}
+}
+
+void
+UnitDiskNetDevice::SetIfIndex (const uint32_t index)
+{
+	m_ifIndex = index;
+}
+
+uint32_t
+UnitDiskNetDevice::GetIfIndex (void) const
+{
+	return m_ifIndex;
+}
+
+Ptr<Channel>
+UnitDiskNetDevice::GetChannel (void) const
+{
+	return m_channel;
+}
+
+void
+UnitDiskNetDevice::SetAddress (Address address)
+{
+	m_address = Mac48Address::ConvertFrom (address);
+}
+
+Address
+UnitDiskNetDevice::GetAddress (void) const
+{
+	return m_address;
+}
+
+bool
+UnitDiskNetDevice::SetMtu (const uint16_t mtu)
+{
+	m_mtu = mtu;
+	return true;
+}
+
+uint16_t
+UnitDiskNetDevice::GetMtu (void) const
+{
+	return m_mtu;
+}
+
+bool
+UnitDiskNetDevice::IsLinkUp (void) const
+{
+	return m_channel != 0;
+}
+
+void
+UnitDiskNetDevice::AddLinkChangeCallback (Callback<void> callback)
+{
+	// The link never changes
+}
+
+bool
+UnitDiskNetDevice::IsBroadcast (void) const
+{
+	return true;
+}
+
+Address
+UnitDiskNetDevice::GetBroadcast (void) const
+{
+	return Mac48Address::GetBroadcast ();
+}
+
+bool
+UnitDiskNetDevice::IsMulticast (void) const
+{
+	return true;
+}
+
+Address
+UnitDiskNetDevice::GetMulticast (Ipv4Address multicastGroup) const
+{
+	return Mac48Address::GetMulticast (multicastGroup);
+}
+
+Address
+UnitDiskNetDevice::GetMulticast (Ipv6Address addr) const
+{
+	return Mac48Address::GetMulticast (addr);
+}
+
+bool
+UnitDiskNetDevice::IsBridge (void) const
+{
+	return false;
+}
+
+bool
+UnitDiskNetDevice::IsPointToPoint (void) const
+{
+	return false;
+}
+
+Ptr<Node>
+UnitDiskNetDevice::GetNode (void) const
+{
+	return m_node;
+}
+
+void
+UnitDiskNetDevice::SetNode (Ptr<Node> node)
+{
+	m_node = node;
+}
+
+bool
+UnitDiskNetDevice::NeedsArp (void) const
+{
+	return true;
+}
+
+void
+UnitDiskNetDevice::SetReceiveCallback (NetDevice::ReceiveCallback cb)
+{
+	m_rxCallback = cb;
+}
+
+void
+UnitDiskNetDevice::SetPromiscReceiveCallback (NetDevice::PromiscReceiveCallback cb)
+{
+	m_promiscRxCallback = cb;
+}
+
+bool
+UnitDiskNetDevice::SupportsSendFrom (void) const
+{
+	return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * unit-disk-net-device.h
+ *
+ *  Half duplex broadcast NetDevice on a UnitDiskChannel, standing in for a
+ *  Wi-Fi card when thousands of nodes make 802.11 too slow to simulate.
+ *  Frames go out one at a time from a queue of QueueSize packets, taking
+ *  their size over DataRate. There is no association, acknowledgement or
+ *  retransmission, only carrier sense: every frame waits Difs plus a random
+ *  backoff of up to MaxBackoff after the medium is idle, so neighbours
+ *  relaying the same broadcast do not all send at once.
+ *
+ *  Any stack that works over a broadcast NetDevice installs unchanged,
+ *  including the ndnSIM one. See UnitDiskHelper.
+ */
+
+#ifndef UNIT_DISK_NET_DEVICE_H_
+#define UNIT_DISK_NET_DEVICE_H_
+
+#include <deque>
+#include <stdint.h>
+#include <vector>
+
+#include <ns3-dev/ns3/data-rate.h>
+#include <ns3-dev/ns3/event-id.h>
+#include <ns3-dev/ns3/mac48-address.h>
+#include <ns3-dev/ns3/net-device.h>
+#include <ns3-dev/ns3/nstime.h>
+#include <ns3-dev/ns3/random-variable-stream.h>
+#include <ns3-dev/ns3/simple-ref-count.h>
+#include <ns3-dev/ns3/traced-callback.h>
+
+#include "unit-disk-channel.h"
+
+namespace ns3 {
+
+class UnitDiskNetDevice : public NetDevice
+{
+public:
+	static TypeId GetTypeId (void);
+
+	UnitDiskNetDevice ();
+	virtual ~UnitDiskNetDevice ();
+
+	void SetChannel (Ptr<UnitDiskChannel> channel);
+
+	// Called by the channel when a frame starts arriving
+	void StartReceive (Ptr<Packet> packet, uint16_t protocol, Mac48Address to, Mac48Address from,
+			Time duration);
+
+	// Uses stream for the backoffs, returns the number of streams used
+	int64_t AssignStreams (int64_t stream);
+
+	virtual void SetIfIndex (const uint32_t index);
+	virtual uint32_t GetIfIndex (void) const;
+	virtual Ptr<Channel> GetChannel (void) const;
+	virtual void SetAddress (Address address);
+	virtual Address GetAddress (void) const;
+	virtual bool SetMtu (const uint16_t mtu);
+	virtual uint16_t GetMtu (void) const;
+	virtual bool IsLinkUp (void) const;
+	virtual void AddLinkChangeCallback (Callback<void> callback);
+	virtual bool IsBroadcast (void) const;
+	virtual Address GetBroadcast (void) const;
+	virtual bool IsMulticast (void) const;
+	virtual Address GetMulticast (Ipv4Address multicastGroup) const;
+	virtual Address GetMulticast (Ipv6Address addr) const;
+	virtual bool IsBridge (void) const;
+	virtual bool IsPointToPoint (void) const;
+	virtual bool Send (Ptr<Packet> packet, const Address &dest, uint16_t protocolNumber);
+	virtual bool SendFrom (Ptr<Packet> packet, const Address &source, const Address &dest,
+			uint16_t protocolNumber);
+	virtual Ptr<Node> GetNode (void) const;
+	virtual void SetNode (Ptr<Node> node);
+	virtual bool NeedsArp (void) const;
+	virtual void SetReceiveCallback (NetDevice::ReceiveCallback cb);
+	virtual void SetPromiscReceiveCallback (NetDevice::PromiscReceiveCallback cb);
+	virtual bool SupportsSendFrom (void) const;
+
+protected:
+	virtual void DoDispose (void);
+
+private:
+	struct Frame
+	{
+		Ptr<Packet> packet;
+		uint16_t protocol;
+		Mac48Address to;
+		Mac48Address from;
+	};
+
+	// Shared with the pending end of reception event, so a frame can be
+	// marked lost once newer ones have taken its place
+	struct Reception : public SimpleRefCount<Reception>
+	{
+		Time end;
+		bool collided;
+	};
+
+	bool IsBusy (void);
+	void Defer (void);
+	void TryTransmit (void);
+	void TransmitComplete (void);
+	void EndReceive (Ptr<Packet> packet, uint16_t protocol, Mac48Address to, Mac48Address from,
+			Ptr<Reception> reception);
+
+	Ptr<Node> m_node;
+	Ptr<UnitDiskChannel> m_channel;
+	uint32_t m_channelIndex;
+	uint32_t m_ifIndex;
+	Mac48Address m_address;
+	uint16_t m_mtu;
+
+	DataRate m_dataRate;
+	uint32_t m_queueSize;
+	Time m_difs;
+	Time m_maxBackoff;
+	Ptr<UniformRandomVariable> m_backoff;
+
+	std::deque<Frame> m_queue;
+	bool m_transmitting;
+	EventId m_transmit;
+	std::vector<Ptr<Reception> > m_receptions;
+
+	NetDevice::ReceiveCallback m_rxCallback;
+	NetDevice::PromiscReceiveCallback m_promiscRxCallback;
+
+	TracedCallback<Ptr<const Packet> > m_macTxTrace;
+	TracedCallback<Ptr<const Packet> > m_macTxDropTrace;
+	TracedCallback<Ptr<const Packet> > m_macRxTrace;
+	TracedCallback<Ptr<const Packet> > m_phyRxDropTrace;
+};
+
+} // namespace ns3
+
+#endif /* UNIT_DISK_NET_DEVICE_H_ */
@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * variant-runner.cc
+ *
+ *  Fork after setup execution of scenario variants.
+ */
+
+#include "variant-runner.h"
+
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <ns3-dev/ns3/log.h>
+#include <ns3-dev/ns3/simulator.h>
+
+NS_LOG_COMPONENT_DEFINE ("VariantRunner");
+
+namespace ns3 {
+
+VariantRunner::VariantRunner (const std::string &variants)
+: m_succeeded (true)
+{
+	std::istringstream list (variants);
+	std::string variant;
+
+	while (std::getline (list, variant, ','))
+	{
+		if (!variant.empty ())
+		{
+			m_variants.push_back (variant);
+		}
+	}
+}
+
+uint32_t
+VariantRunner::GetN (void) const
+{
+	return m_variants.size ();
+}
+
+const std::vector<std::string> &
+VariantRunner::GetVariants (void) const
+{
+	return m_variants;
+}
+
+bool
+VariantRunner::Fork (void)
+{
+	NS_ASSERT_MSG (Simulator::Now ().IsZero (), "Variants must be forked before the simulation runs");
+
+	// Whatever is buffered would be written once by every process
+	std::cout.flush ();
+	std::cerr.flush ();
+	fflush (0);
+
+	std::vector<pid_t> children;
+
+	for (size_t i = 0; i < m_variants.size (); ++i)
+	{
+		pid_t pid = fork ();
+		if (pid < 0)
+		{
+			std::cerr << "Could not fork variant " << m_variants[i] << std::endl;
+			m_succeeded = false;
+			break;
+		}
+
+		if (pid == 0)
+		{
+			m_variant = m_variants[i];
+			NS_LOG_INFO ("Running variant " << m_variant << " as " << getpid ());
+			return true;
+		}
+
+		children.push_back (pid);
+	}
+
+	for (size_t i = 0; i < children.size (); ++i)
+	{
+		int status;
+		if (waitpid (children[i], &status, 0) != children[i]
+				|| !WIFEXITED (status) || WEXITSTATUS (status) != 0)
+		{
+			std::cerr << "Variant " << m_variants[i] << " failed" << std::endl;
+			m_succeeded = false;
+		}
+	}
+
+	return false;
+}
+
+const std::string &
+VariantRunner::GetVariant (void) const
+{
+	return m_variant;
+}
+
+bool
+VariantRunner::Succeeded (void) const
+{
+	return m_succeeded;
+}
+
+} // namespace ns3
@@ -0,0 +1,66 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * variant-runner.h
+ *
+ *  Runs several variants of a scenario from one setup. The scenario builds
+ *  everything the variants share, then Fork () starts one process per
+ *  variant, which installs what is particular to it and runs. Every
+ *  variant starts from the same nodes, positions and random number
+ *  streams, and the shared setup is only done once.
+ */
+
+#ifndef VARIANT_RUNNER_H_
+#define VARIANT_RUNNER_H_
+
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace ns3 {
+
+class VariantRunner
+{
+public:
+	// variants is a comma separated list, e.g. "flood,smart,bestr"
+	VariantRunner (const std::string &variants);
+
+	uint32_t GetN (void) const;
+
+	// Variants in the order given, so the caller can check them before
+	// anything is forked
+	const std::vector<std::string> & GetVariants (void) const;
+
+	// Forks one process per variant and returns true in them. The calling
+	// process waits for all of them and returns false. Nothing may have
+	// been simulated yet
+	bool Fork (void);
+
+	// Variant of this process
+	const std::string & GetVariant (void) const;
+
+	// In the calling process, whether every variant exited cleanly
+	bool Succeeded (void) const;
+
+private:
+	std::vector<std::string> m_variants;
+	std::string m_variant;
+	bool m_succeeded;
+};
+
+} // namespace ns3
+
+#endif /* VARIANT_RUNNER_H_ */
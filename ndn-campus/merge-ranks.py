@@ -0,0 +1,84 @@
+#!/usr/bin/env python
+# -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+
+# Joins the per rank (or per process) outputs of a distributed run, named
+# <name>-rank<N>.<ext>, into <name>.<ext>. Tables whose rows start with the
+# time are merged in time order under a single header and replace the
+# target, as the tracers do. Anything else is concatenated in rank order and
+# appended to the target, so records such as the --timing ones accumulate
+# over runs as they do without ranks.
+
+import argparse
+import heapq
+import os
+import re
+import sys
+
+RANK = re.compile(r'^(.*)-rank(\d+)(\.[^./]*)?$')
+
+parser = argparse.ArgumentParser(description='Merge per rank output files')
+parser.add_argument('dir', type=str, nargs='?', default='results', help='Directory holding the -rank<N> files')
+parser.add_argument('-k', '--keep', dest='keep', action='store_true', default=False,
+                    help='Keep the per rank files')
+
+args = parser.parse_args()
+
+def timestamp(line):
+    try:
+        return float(line.split(None, 1)[0])
+    except (ValueError, IndexError):
+        return None
+
+def read(filename):
+    with open(filename) as f:
+        return f.readlines()
+
+groups = {}
+for entry in os.listdir(args.dir):
+    match = RANK.match(entry)
+    if match:
+        name, rank, ext = match.groups()
+        groups.setdefault((name, ext or ''), []).append((int(rank), os.path.join(args.dir, entry)))
+
+for (name, ext), ranks in sorted(groups.items()):
+    ranks.sort()
+    target = os.path.join(args.dir, name + ext)
+    contents = [read(filename) for rank, filename in ranks]
+
+    header = None
+    first = contents[0]
+    if first and timestamp(first[0]) is None:
+        header = first[0]
+
+    rows = []
+    for lines in contents:
+        if header is not None and lines and lines[0] == header:
+            lines = lines[1:]
+        rows.append(lines)
+
+    table = all(timestamp(line) is not None for lines in rows for line in lines if line.strip())
+    if table:
+        # heapq.merge keeps rank order for equal times
+        merged = heapq.merge(*[[(timestamp(line), i, n, line) for n, line in enumerate(lines)]
+                               for i, lines in enumerate(rows)])
+        body = [entry[3] for entry in merged]
+    else:
+        body = [line for lines in rows for line in lines]
+
+    append = not table and os.path.exists(target)
+    if append and header is not None:
+        # Same header as the records already there, keep it once
+        with open(target) as f:
+            if f.readline() == header:
+                header = None
+
+    with open(target, 'a' if append else 'w') as out:
+        if header is not None:
+            out.write(header)
+        out.writelines(body)
+
+    sys.stderr.write("%s: %s %d ranks\n" % (target, 'appended' if append else 'merged', len(ranks)))
+
+    if not args.keep:
+        for rank, filename in ranks:
+            os.remove(filename)
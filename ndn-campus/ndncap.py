@@ -0,0 +1,68 @@
+#!/usr/bin/env python
+# -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+
+# Prints the records of an NdnCapture dump (.ndncap) as a tab separated table
+
+import argparse
+import struct
+import sys
+
+HEADER = struct.Struct('<8sIIQQ')
+RECORD = struct.Struct('<qIIIIIBBH')
+MAGIC = b'NDNCAP\x00\x01'
+
+TYPES = {1: 'InInterest', 2: 'OutInterest', 3: 'DropInterest',
+         4: 'InData', 5: 'OutData', 6: 'DropData', 7: 'Timeout'}
+
+FROM_CACHE = 1
+HAS_SEQUENCE = 2
+
+parser = argparse.ArgumentParser(description='NdnCapture dump reader')
+parser.add_argument('dump', type=str, help='.ndncap file to read')
+parser.add_argument('-n', '--node', dest='node', type=int, default=None,
+                    help='Only print records of this node')
+parser.add_argument('-t', '--type', dest='type', type=str, default=None,
+                    help='Only print records of this type, e.g. OutData')
+parser.add_argument('-s', '--summary', dest='summary', action='store_true', default=False,
+                    help='Print counts per node and type instead of records')
+
+args = parser.parse_args()
+
+with open(args.dump, 'rb') as f:
+    magic, version, size, count, captured = HEADER.unpack(f.read(HEADER.size))
+
+    if magic != MAGIC or size != RECORD.size:
+        sys.exit("%s is not an NdnCapture dump" % args.dump)
+
+    sys.stderr.write("%d records, %d captured in total\n" % (count, captured))
+
+    summary = {}
+
+    if not args.summary:
+        print("Time\tNode\tFace\tType\tNameHash\tSeq\tNonce\tHops\tFlags")
+
+    for i in range(count):
+        time, node, face, name, nonce, seq, kind, hops, flags = RECORD.unpack(f.read(RECORD.size))
+        kind = TYPES.get(kind, str(kind))
+
+        if args.node is not None and node != args.node:
+            continue
+        if args.type is not None and kind != args.type:
+            continue
+
+        if args.summary:
+            summary[(node, kind)] = summary.get((node, kind), 0) + 1
+            continue
+
+        print("%.9f\t%d\t%s\t%s\t%08x\t%s\t%d\t%d\t%s" % (
+            time * 1e-9, node,
+            '-' if face == 0xffffffff else face,
+            kind, name,
+            seq if flags & HAS_SEQUENCE else '-',
+            nonce, hops,
+            'cache' if flags & FROM_CACHE else '-'))
+
+    if args.summary:
+        print("Node\tType\tCount")
+        for (node, kind) in sorted(summary):
+            print("%d\t%s\t%d" % (node, kind, summary[(node, kind)]))
@@ -24,7 +24,6 @@ mt19937_64 gen;
 
 int main(int ac, char* av[])
 {
-	gen.seed(std::time(0) + (long long)getpid() << 32);
 	po::variables_map vm;
 
 	try {
@@ -32,6 +31,7 @@ int main(int ac, char* av[])
 		po::options_description desc("Allowed options");
 		desc.add_options()
 	            		("help", "Produce this help message")
+	            		("seed", po::value<unsigned long long>(), "Seed, same seed gives the same output. Random if not set")
 	            		("avg", po::value<double>(), "Set average size (MB) for the geometric distribution")
 	            		;
 
@@ -56,6 +56,11 @@ int main(int ac, char* av[])
 		cerr << "Exception of unknown type!\n";
 	}
 
+	if (vm.count("seed"))
+		gen.seed(vm["seed"].as<unsigned long long>());
+	else
+		gen.seed(std::time(0) + (long long)getpid() << 32);
+
 	double average = 1.0/ (vm["avg"].as<double>() * 1048576);
 	geometric_distribution<> size_dist(average);
 
@@ -0,0 +1,178 @@
+/*
+ *
+ * manifest-generator.cc
+ *
+ *  Generates every random input of a sweep in one go. Writes one row per
+ *  replication with the RngRun to give the scenario, a content size drawn
+ *  from the same geometric distribution as content-size-generator, a
+ *  position drawn like position-generator and, with --urls, a URL picked
+ *  from the output of url-generator.
+ *
+ *  Each row only depends on the master seed and its run number, so asking
+ *  for more runs keeps the rows already given out.
+ *
+ *  Output is tab separated, comment lines start with #:
+ *
+ *    # run	rngrun	size	pos	url
+ *    1	1832410398	9541213	7	/foo/bar
+ */
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <stdint.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+using namespace std;
+namespace po = boost::program_options;
+
+// SplitMix64. Tiny state, so each row can have its own generator without
+// the cost of seeding a Mersenne twister 100k times
+struct RowGen {
+	uint64_t state;
+
+	RowGen(uint64_t seed, uint64_t run)
+	{
+		state = seed;
+		state = next() ^ (run * 0x9E3779B97F4A7C15ULL);
+	}
+
+	uint64_t next()
+	{
+		uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	// Uniform in [0, 1)
+	double uniform()
+	{
+		return (next() >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	// Uniform in [min, max]
+	long long uniform(long long min, long long max)
+	{
+		return min + (long long)(uniform() * (double)(max - min + 1));
+	}
+};
+
+int main(int ac, char* av[])
+{
+	po::variables_map vm;
+
+	try {
+
+		po::options_description desc("Allowed options");
+		desc.add_options()
+	            		("help", "Produce this help message")
+	            		("seed", po::value<unsigned long long>(), "Master seed, same seed gives the same manifest. Random if not set")
+	            		("runs", po::value<int>()->default_value(1), "Number of rows (replications) to generate")
+	            		("first", po::value<int>()->default_value(1), "Run number of the first row")
+	            		("avg", po::value<double>()->default_value(10), "Average size (MB) for the geometric distribution")
+	            		("min", po::value<int>()->default_value(0), "Min position")
+	            		("max", po::value<int>()->default_value(0), "Max position")
+	            		("urls", po::value<string>(), "File with one URL per line to pick from (url-generator output)")
+	            		("out", po::value<string>(), "Output file, stdout if not set")
+	            		;
+
+		po::store(po::parse_command_line(ac, av, desc), vm);
+		po::notify(vm);
+
+		if (vm.count("help")) {
+			cout << desc << endl;
+			return 0;
+		}
+	}
+	catch(std::exception& e) {
+		cerr << "error: " << e.what() << endl;
+		return 1;
+	}
+	catch(...) {
+		cerr << "Exception of unknown type!" << endl;
+		return 1;
+	}
+
+	uint64_t seed;
+	if (vm.count("seed"))
+		seed = vm["seed"].as<unsigned long long>();
+	else
+		seed = std::time(0) + ((uint64_t)getpid() << 32);
+
+	int runs = vm["runs"].as<int>();
+	int first = vm["first"].as<int>();
+	double avg = vm["avg"].as<double>();
+	int minP = vm["min"].as<int>();
+	int maxP = vm["max"].as<int>();
+
+	if (runs < 0 || avg <= 0 || maxP < minP) {
+		cerr << "Need runs >= 0, avg > 0 and min <= max" << endl;
+		return 1;
+	}
+
+	vector<string> urls;
+	if (vm.count("urls")) {
+		string filename = vm["urls"].as<string>();
+		ifstream in_stream(filename.c_str());
+
+		if (!in_stream) {
+			cerr << "File " << filename << " Does not exist!" << endl;
+			return 1;
+		}
+
+		string line;
+		while (getline(in_stream, line))
+			if (!line.empty())
+				urls.push_back(line);
+
+		if (urls.empty()) {
+			cerr << "No URLs in " << filename << endl;
+			return 1;
+		}
+	}
+
+	FILE *out = stdout;
+	if (vm.count("out")) {
+		out = fopen(vm["out"].as<string>().c_str(), "w");
+		if (!out) {
+			cerr << "Could not open " << vm["out"].as<string>() << " for writing" << endl;
+			return 1;
+		}
+	}
+
+	// Same parametrisation as content-size-generator
+	double logq = log(1.0 - 1.0 / (avg * 1048576));
+
+	fprintf(out, "# manifest-generator seed=%llu runs=%d first=%d avg=%g min=%d max=%d urls=%s\n",
+			(unsigned long long)seed, runs, first, avg, minP, maxP,
+			vm.count("urls") ? vm["urls"].as<string>().c_str() : "-");
+	fprintf(out, "# run\trngrun\tsize\tpos\turl\n");
+
+	for (int run = first; run < first + runs; run++)
+	{
+		RowGen gen(seed, (uint64_t)run);
+
+		// ns-3 takes any run number, keep it positive and in 31 bits so
+		// shell arithmetic and Python agree on it
+		unsigned long rngrun = (unsigned long)(gen.next() & 0x7fffffff);
+		if (rngrun == 0)
+			rngrun = 1;
+
+		unsigned long long size = (unsigned long long)floor(log(1.0 - gen.uniform()) / logq);
+		long long pos = gen.uniform(minP, maxP);
+		const char *url = urls.empty() ? "-" : urls[gen.uniform(0, urls.size() - 1)].c_str();
+
+		fprintf(out, "%d\t%lu\t%llu\t%lld\t%s\n", run, rngrun, size, pos, url);
+	}
+
+	if (out != stdout)
+		fclose(out);
+
+	return 0;
+}
@@ -24,7 +24,6 @@ mt19937_64 gen;
 
 int main(int ac, char* av[])
 {
-	gen.seed(std::time(0) + (long long)getpid() << 32);
 	po::variables_map vm;
 
 	try {
@@ -32,6 +31,7 @@ int main(int ac, char* av[])
 		po::options_description desc("Allowed options");
 		desc.add_options()
 	            		("help", "Produce this help message")
+	            		("seed", po::value<unsigned long long>(), "Seed, same seed gives the same output. Random if not set")
 	            		("min", po::value<double>(), "Min value for uniform distribution")
 	            		("max", po::value<double>(), "Max value for uniform distribution")
 	            		;
@@ -61,6 +61,11 @@ int main(int ac, char* av[])
 	catch(...) {
 		cerr << "Exception of unknown type!\n";
 	}
+
+	if (vm.count("seed"))
+		gen.seed(vm["seed"].as<unsigned long long>());
+	else
+		gen.seed(std::time(0) + (long long)getpid() << 32);
 	
 	double minP = vm["min"].as<double>();
 	double maxP = vm["max"].as<double>();
@@ -2,43 +2,331 @@
  *
  * url-generator.cc
  *
- *  Simple command line program to generate a random list of URLs given an
- *  amount of desired URLs, a mean and standard deviation for their lengths and
- *  a dictionary file.
+ *  Command line program to generate a random list of URLs (NDN names) from
+ *  a dictionary file. The number of components of a name and the length of
+ *  each component follow configurable distributions, or, with --avg and
+ *  --std, words are added until the name reaches a normally distributed
+ *  total length.
+ *
+ *  The dictionary is memory mapped and indexed by word length once. Names
+ *  are generated in chunks on several threads, every chunk with its own
+ *  generator derived from the seed and the chunk number, so the output
+ *  only depends on the seed and never on the number of threads.
+ *
+ *  Names can be written as text, one per line, and/or pre-encoded in NDN
+ *  TLV or ndnSIM wire format, one encoded name after the other.
  *
  *  Created on: June 24, 2014
  *      Author: Jairo Eduardo Lopez
  */
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
 #include <ctime>
 #include <iostream>
-#include <iterator>
-#include <fstream>
-#include <sys/stat.h>
+#include <stdint.h>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/geometric_distribution.hpp>
+#include <boost/random/normal_distribution.hpp>
 #include <boost/random/uniform_int_distribution.hpp>
-#include <boost/random/variate_generator.hpp>
 #include <boost/program_options.hpp>
 
-using namespace boost::random;
 using namespace std;
+namespace br = boost::random;
 namespace po = boost::program_options;
 
-mt19937_64 gen;
+// Names generated by a thread at a time
+const size_t kChunk = 1 << 16;
+
+// Memory mapped dictionary with its words indexed by length
+struct Dictionary {
+	struct Word {
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	const char *base;
+	size_t size;
+	vector<Word> words;
+	// Words of each length, and the closest length having words
+	vector<vector<uint32_t> > byLen;
+	vector<uint32_t> nearest;
+
+	Dictionary() : base(0), size(0) {}
+
+	~Dictionary()
+	{
+		if (base)
+			munmap((void *)base, size);
+	}
+
+	bool load(const string &filename)
+	{
+		int fd = open(filename.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+
+		struct stat st;
+		if (fstat(fd, &st) < 0 || st.st_size == 0) {
+			close(fd);
+			return false;
+		}
+
+		size = st.st_size;
+		void *map = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (map == MAP_FAILED) {
+			size = 0;
+			return false;
+		}
+		base = (const char *)map;
+
+		// Whitespace separated words, as operator>> read them
+		size_t i = 0;
+		while (i < size) {
+			while (i < size && isspace((unsigned char)base[i]))
+				i++;
+			size_t start = i;
+			while (i < size && !isspace((unsigned char)base[i]))
+				i++;
+			if (i > start) {
+				Word w = { (uint32_t)start, (uint32_t)(i - start) };
+				words.push_back(w);
+			}
+		}
+
+		if (words.empty())
+			return false;
+
+		for (uint32_t w = 0; w < words.size(); w++) {
+			if (words[w].size >= byLen.size())
+				byLen.resize(words[w].size + 1);
+			byLen[words[w].size].push_back(w);
+		}
+
+		nearest.resize(byLen.size());
+		for (uint32_t len = 0; len < byLen.size(); len++) {
+			uint32_t best = 0;
+			for (uint32_t d = 0; d < byLen.size(); d++) {
+				if (len >= d && !byLen[len - d].empty()) { best = len - d; break; }
+				if (len + d < byLen.size() && !byLen[len + d].empty()) { best = len + d; break; }
+			}
+			nearest[len] = best;
+		}
+
+		return true;
+	}
+
+	uint32_t longest() const
+	{
+		return byLen.size() - 1;
+	}
+};
+
+// Integer distribution given as kind:param[:param]
+struct Dist {
+	enum Kind { ANY, FIXED, UNIFORM, NORMAL, GEOMETRIC } kind;
+	double a, b;
 
-struct length {
-	bool operator() ( const string& a, const string& b )
+	Dist() : kind(ANY), a(0), b(0) {}
+
+	bool parse(const string &spec)
 	{
-		return a.size() < b.size();
+		vector<double> p;
+		string name = spec.substr(0, spec.find(':'));
+		for (size_t pos = spec.find(':'); pos != string::npos; pos = spec.find(':', pos + 1))
+			p.push_back(atof(spec.c_str() + pos + 1));
+
+		if (name == "any" && p.size() == 0)
+			kind = ANY;
+		else if (name == "fixed" && p.size() == 1)
+			kind = FIXED;
+		else if (name == "uniform" && p.size() == 2 && p[0] <= p[1])
+			kind = UNIFORM;
+		else if (name == "normal" && p.size() == 2 && p[1] >= 0)
+			kind = NORMAL;
+		else if (name == "geometric" && p.size() == 1 && p[0] >= 1)
+			kind = GEOMETRIC;
+		else
+			return false;
+
+		a = p.size() > 0 ? p[0] : 0;
+		b = p.size() > 1 ? p[1] : 0;
+		return true;
+	}
+
+	// Value of at least 1
+	int sample(br::mt19937_64 &gen) const
+	{
+		int v = 1;
+		switch (kind) {
+		case FIXED:
+			v = (int)a;
+			break;
+		case UNIFORM:
+			v = br::uniform_int_distribution<int>((int)a, (int)b)(gen);
+			break;
+		case NORMAL:
+			v = (int)(br::normal_distribution<double>(a, b)(gen) + 0.5);
+			break;
+		case GEOMETRIC:
+			// Number of trials, mean a
+			v = 1 + (a > 1 ? br::geometric_distribution<int>(1.0 / a)(gen) : 0);
+			break;
+		case ANY:
+			break;
+		}
+		return max(v, 1);
 	}
 };
 
+enum WireFormat { WIRE_TLV, WIRE_NDNSIM };
+
+struct Settings {
+	const Dictionary *dict;
+	uint64_t seed;
+	bool legacy;
+	Dist depth;
+	Dist complen;
+	Dist total;
+	bool text;
+	bool wire;
+	WireFormat format;
+};
+
+// Generated names of one chunk
+struct Chunk {
+	string text;
+	string wire;
+};
+
+uint64_t mix(uint64_t z)
+{
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+void putVarNumber(string &out, uint64_t n)
+{
+	if (n < 253) {
+		out += (char)n;
+	}
+	else if (n <= 0xFFFF) {
+		out += (char)253;
+		out += (char)(n >> 8);
+		out += (char)n;
+	}
+	else {
+		out += (char)254;
+		for (int shift = 24; shift >= 0; shift -= 8)
+			out += (char)(n >> shift);
+	}
+}
+
+size_t varNumberSize(uint64_t n)
+{
+	return n < 253 ? 1 : (n <= 0xFFFF ? 3 : 5);
+}
+
+// ndnSIM writes its lengths with Buffer::Iterator::WriteU16, low byte first
+void putU16(string &out, uint16_t n)
+{
+	out += (char)n;
+	out += (char)(n >> 8);
+}
+
+uint32_t pickWord(const Settings &s, br::mt19937_64 &gen)
+{
+	const Dictionary &d = *s.dict;
+
+	if (s.complen.kind == Dist::ANY)
+		return br::uniform_int_distribution<uint32_t>(0, d.words.size() - 1)(gen);
+
+	uint32_t len = min((uint32_t)s.complen.sample(gen), d.longest());
+	const vector<uint32_t> &candidates = d.byLen[d.nearest[len]];
+	return candidates[br::uniform_int_distribution<uint32_t>(0, candidates.size() - 1)(gen)];
+}
+
+void generate(const Settings &s, uint64_t chunk, size_t count, Chunk &out)
+{
+	const Dictionary &d = *s.dict;
+	br::mt19937_64 gen(mix(s.seed + mix(chunk + 1)));
+	vector<uint32_t> comps;
+
+	out.text.clear();
+	out.wire.clear();
+
+	for (size_t i = 0; i < count; i++) {
+		comps.clear();
+		size_t chars = 0;
+
+		if (s.legacy) {
+			// Add words until the total length is reached
+			size_t target = s.total.sample(gen);
+			while (chars < target) {
+				uint32_t w = pickWord(s, gen);
+				comps.push_back(w);
+				chars += 1 + d.words[w].size;
+			}
+		}
+		else {
+			int depth = s.depth.sample(gen);
+			for (int c = 0; c < depth; c++)
+				comps.push_back(pickWord(s, gen));
+		}
+
+		if (s.text) {
+			for (size_t c = 0; c < comps.size(); c++) {
+				out.text += '/';
+				out.text.append(d.base + d.words[comps[c]].offset, d.words[comps[c]].size);
+			}
+			out.text += '\n';
+		}
+
+		if (s.wire) {
+			size_t value = 0;
+			for (size_t c = 0; c < comps.size(); c++) {
+				uint32_t len = d.words[comps[c]].size;
+				value += s.format == WIRE_TLV ? 1 + varNumberSize(len) + len : 2 + len;
+			}
+
+			if (s.format == WIRE_TLV) {
+				// Name and NameComponent TLVs of the NDN packet format
+				out.wire += (char)0x07;
+				putVarNumber(out.wire, value);
+			}
+			else {
+				putU16(out.wire, value);
+			}
+
+			for (size_t c = 0; c < comps.size(); c++) {
+				uint32_t len = d.words[comps[c]].size;
+				if (s.format == WIRE_TLV) {
+					out.wire += (char)0x08;
+					putVarNumber(out.wire, len);
+				}
+				else {
+					putU16(out.wire, len);
+				}
+				out.wire.append(d.base + d.words[comps[c]].offset, len);
+			}
+		}
+	}
+}
+
 int main(int ac, char* av[])
 {
-	gen.seed(std::time(0) + (long long)getpid() << 32);
 	po::variables_map vm;
 
 	try {
@@ -46,11 +334,18 @@ int main(int ac, char* av[])
 		po::options_description desc("Allowed options");
 		desc.add_options()
 	            		("help", "Produce this help message")
-	            		("avg", po::value<int>(), "Set average length of the URL")
-	            		("std", po::value<int>(), "Set URL length standard deviation")
-	            		("num", po::value<int>(), "Set number of URLs to generate")
+	            		("seed", po::value<unsigned long long>(), "Seed, same seed gives the same output. Random if not set")
+	            		("num", po::value<long long>(), "Set number of URLs to generate")
 	            		("file", po::value<string>(), "Dictionary file")
-	            		("out", po::value<string>(), "Output file for generated data")
+	            		("out", po::value<string>(), "Output file for the URLs as text, one per line")
+	            		("wire", po::value<string>(), "Output file for the URLs in wire format")
+	            		("wire-format", po::value<string>()->default_value("tlv"), "Wire format, tlv (NDN packet format) or ndnsim")
+	            		("append", "Append to the output files instead of overwriting them")
+	            		("depth", po::value<string>()->default_value("uniform:1:6"), "Distribution of the number of components")
+	            		("complen", po::value<string>()->default_value("any"), "Distribution of the component length, any picks words uniformly")
+	            		("avg", po::value<int>(), "Set average length of the URL, instead of --depth")
+	            		("std", po::value<int>(), "Set URL length standard deviation, with --avg")
+	            		("threads", po::value<unsigned>()->default_value(max(1u, thread::hardware_concurrency())), "Threads generating URLs")
 	            		;
 
 		po::store(po::parse_command_line(ac, av, desc), vm);
@@ -58,21 +353,17 @@ int main(int ac, char* av[])
 
 		if (vm.count("help")) {
 			cout << desc << endl;
+			cout << "Distributions: any, fixed:N, uniform:MIN:MAX, normal:MEAN:STD, geometric:MEAN" << endl;
 			return 0;
 		}
 
-		if (! vm.count("avg")) {
-			cout << "URL avg length not set!." << endl;;
-			return 1;
-		}
-
-		if (! vm.count("std")) {
-			cout << "URL standard deviation length not set!." << endl;;
+		if (vm.count("avg") != vm.count("std")) {
+			cout << "URL avg length and standard deviation go together!." << endl;
 			return 1;
 		}
 
 		if (! vm.count("num")) {
-			cout << "Number of URLs to generate not set!." << endl;;
+			cout << "Number of URLs to generate not set!." << endl;
 			return 1;
 		}
 
@@ -81,7 +372,7 @@ int main(int ac, char* av[])
 			return 1;
 		}
 
-		if (! vm.count("out")) {
+		if (! vm.count("out") && ! vm.count("wire")) {
 			cout << "Output file not set!." << endl;
 			return 1;
 		}
@@ -92,102 +383,114 @@ int main(int ac, char* av[])
 	}
 	catch(...) {
 		cerr << "Exception of unknown type!" << endl;
+		return 1;
 	}
 
-	vector<string> list;
+	Settings s;
 
-	string filename = vm["file"].as<string>();
-	string outputfile = vm["out"].as<string>();
-	int numURLs = vm["num"].as<int>();
-	int mean = vm["avg"].as<int>();
-	int std = vm["std"].as<int>();
+	if (vm.count("seed"))
+		s.seed = vm["seed"].as<unsigned long long>();
+	else
+		s.seed = std::time(0) + ((uint64_t)getpid() << 32);
 
-	// Try opening the dictionary file
-	ifstream in_stream(filename.c_str());
+	s.legacy = vm.count("avg") > 0;
+	if (s.legacy)
+		s.total.parse("normal:" + to_string(vm["avg"].as<int>()) + ":" + to_string(vm["std"].as<int>()));
 
-	if (in_stream)
-	{
-		string line;
-
-		while(!in_stream.eof())
-		{
-			in_stream >> line;
-			list.push_back(line);
-		}
-	}
-	else
-	{
-		cout << "File " << filename << " Does not exist!" << endl;
+	if (!s.depth.parse(vm["depth"].as<string>())) {
+		cout << "Bad --depth " << vm["depth"].as<string>() << endl;
 		return 1;
 	}
 
-	// Close the dictionary file
-	in_stream.close();
-
-	// Sort the vector by the longest string
-	sort ( list.begin(), list.end(), length());
-
-	int longestStr = list.back().size();
-	int dictSize = list.size()-1;
-
-	int minURLlen = longestStr;
-	int maxURLlen = mean + std;
-
-	cout << "Longest string given was: " << longestStr << endl;
-	cout << "Size of dictionary is: " << dictSize << endl;
-	cout << "Generating " << numURLs << " URLs" << endl;
-
-	// Random to get the size of the URL to produce
-	uniform_int_distribution<> url_len(minURLlen, maxURLlen);
-
-	variate_generator<mt19937_64&, uniform_int_distribution<> > url_size_gen(gen, url_len);
-
-	// Random to get the a string from the vector we created
-	uniform_int_distribution<> dict_num(0, dictSize);
-
-	variate_generator<mt19937_64&, uniform_int_distribution<> > dict_var_gen(gen, dict_num);
-
-	// Try to open our output file for appending
-	ofstream fout(outputfile.c_str(), ios::app);
+	if (!s.complen.parse(vm["complen"].as<string>())) {
+		cout << "Bad --complen " << vm["complen"].as<string>() << endl;
+		return 1;
+	}
 
-	if (!fout)
-	{
-		cout << " Could not open " << outputfile << "for writing...\n";
-		return(1);
+	string format = vm["wire-format"].as<string>();
+	if (format == "tlv")
+		s.format = WIRE_TLV;
+	else if (format == "ndnsim")
+		s.format = WIRE_NDNSIM;
+	else {
+		cout << "Unknown wire format " << format << endl;
+		return 1;
 	}
 
-	for (int i = 0; i < numURLs; i++)
-	{
-		// Generate a URL length
-		int url_curr_len = url_size_gen();
+	string filename = vm["file"].as<string>();
+	if (vm["num"].as<long long>() < 0) {
+		cout << "Number of URLs can not be negative!." << endl;
+		return 1;
+	}
+	uint64_t numURLs = vm["num"].as<long long>();
+	unsigned threads = max(1u, vm["threads"].as<unsigned>());
 
-		//cout << "URL size will start as " << url_curr_len << endl;
+	Dictionary dict;
+	if (!dict.load(filename)) {
+		cout << "File " << filename << " Does not exist or has no words!" << endl;
+		return 1;
+	}
+	s.dict = &dict;
 
-		string tmp = "";
+	cout << "Longest string given was: " << dict.longest() << endl;
+	cout << "Size of dictionary is: " << dict.words.size() << endl;
+	cout << "Generating " << numURLs << " URLs on " << threads << " threads" << endl;
 
-		while (url_curr_len > minURLlen)
-		{
-			// Generate a number to choose a string
-			int dict_curr_var = dict_var_gen();
+	const char *mode = vm.count("append") ? "ab" : "wb";
+	FILE *textOut = 0;
+	FILE *wireOut = 0;
 
-			// Add the new string to final result
-			tmp += "/" + list[dict_curr_var];
+	s.text = vm.count("out") > 0;
+	if (s.text && !(textOut = fopen(vm["out"].as<string>().c_str(), mode))) {
+		cout << "Could not open " << vm["out"].as<string>() << " for writing..." << endl;
+		return 1;
+	}
 
-			// Subtract the string length and head for next round
-			url_curr_len -= (list[dict_curr_var].size());
+	s.wire = vm.count("wire") > 0;
+	if (s.wire && !(wireOut = fopen(vm["wire"].as<string>().c_str(), mode))) {
+		cout << "Could not open " << vm["wire"].as<string>() << " for writing..." << endl;
+		return 1;
+	}
 
-			//cout << "Added " << tmp << endl;
-			//cout << "We have " << url_curr_len << " characters remaining" << endl;
+	// A few chunks per thread at a time, written in order once all are done
+	uint64_t chunks = (numURLs + kChunk - 1) / kChunk;
+	vector<Chunk> batch(threads * 4);
+
+	for (uint64_t first = 0; first < chunks; first += batch.size()) {
+		uint64_t last = min(chunks, first + batch.size());
+		atomic<uint64_t> next(first);
+
+		vector<thread> workers;
+		for (unsigned t = 0; t < threads; t++) {
+			workers.push_back(thread([&]() {
+				for (uint64_t c = next++; c < last; c = next++) {
+					size_t count = min<uint64_t>(kChunk, numURLs - c * kChunk);
+					generate(s, c, count, batch[c - first]);
+				}
+			}));
+		}
+		for (size_t t = 0; t < workers.size(); t++)
+			workers[t].join();
+
+		for (uint64_t c = first; c < last; c++) {
+			const Chunk &chunk = batch[c - first];
+			if (textOut)
+				fwrite(chunk.text.data(), 1, chunk.text.size(), textOut);
+			if (wireOut)
+				fwrite(chunk.wire.data(), 1, chunk.wire.size(), wireOut);
 		}
+	}
 
-		//cout << "Resulting string " << tmp << endl;
+	bool failed = false;
+	if (textOut)
+		failed |= fclose(textOut) != 0;
+	if (wireOut)
+		failed |= fclose(wireOut) != 0;
 
-		// With the string created, we send it to the file
-		 fout << tmp << endl;
+	if (failed) {
+		cout << "Error writing the output" << endl;
+		return 1;
 	}
 
-	// Close the dictionary file
-	fout.close();
-
 	return 0;
 }
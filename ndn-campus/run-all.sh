@@ -12,6 +12,7 @@ RFLAG=1
 TFLAG=""
 XFLAG=""
 DFLAG="results"
+JFLAG=$(getconf _NPROCESSORS_ONLN)
 
 function usage() {
     echo "Script to automize running a continuous set of ns3 scenarios"
@@ -27,10 +28,14 @@ function usage() {
     echo "    -t        Run TCP scenario. Default [$TFLAG]"
     echo "    -x        Run NDN scenario. Default [$XFLAG]"
     echo "    -d DIR    Directory to place the results. Default [$DFLAG]"
+    echo "    -j NUM    Number of simulations to run at once. Default [$JFLAG]"
+    echo ""
+    echo "Runs every combination in parallel through run.py, see ./run.py --help"
+    echo "for more sweep options."
     echo ""
 }
 
-while getopts "r:d:c:s:n:p:htx" OPT
+while getopts "r:d:c:s:n:p:j:htx" OPT
 do
     case $OPT in
     c)
@@ -57,6 +62,9 @@ do
     r)
         RFLAG=$OPTARG
         ;;
+    j)
+        JFLAG=$OPTARG
+        ;;
     \?)
         echo "Invalid option: -$OPTARG" >&2
         exit 1
@@ -76,13 +84,12 @@ do
     esac
 done
 
-for i in $(seq 1 $NFLAG)
-do
-    for j in $(seq 1 $PFLAG)
-    do
-        for k in $(seq 1 $CFLAG)
-        do
-            $WAFDIR/run-sim.sh -n $i -p $j -c $k -r $RFLAG -d $DFLAG -r $RFLAG -s $SFLAG $TFLAG $XFLAG
-        done
-    done
-done
+if [ -z "$TFLAG" ] && [ -z "$XFLAG" ]; then
+    echo "No -t or -x flag set! No simulations to run!"
+    exit 0
+fi
+
+# Build once, run.py then starts the binaries directly
+$WAF build || exit 1
+
+$WAFDIR/run.py -n 1:$NFLAG -p 1:$PFLAG -c 1:$CFLAG -r $RFLAG -s $SFLAG -d $DFLAG -j $JFLAG $TFLAG $XFLAG
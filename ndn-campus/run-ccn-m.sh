@@ -3,7 +3,7 @@
 WAFDIR=$(pwd)
 WAF=${WAFDIR}/waf
 PRINTF=$(which printf)
-POSGEN=${WAFDIR}/random/position-generator
+MANGEN=${WAFDIR}/random/manifest-generator
 
 CFLAG=1
 PFLAG=1
@@ -13,6 +13,7 @@ RFLAG=10
 TFLAG=0
 XFLAG=0
 DFLAG="results"
+EFLAG=1
 
 function checkRun() {
     echo "Checking for $1"
@@ -27,34 +28,34 @@ if [ $? -ne 0 ]; then
     exit 1
 fi
 
-if [ ! -x $POSGEN ]; then
-    echo "No $POSGEN! Compiling..."
+if [ ! -x $MANGEN ]; then
+    echo "No $MANGEN! Compiling..."
     cd random/
     make
     cd $WAF
 fi
 
 
-TYPE=( "" "--smart" "--bestr" ) 
+# Positions of all rounds, written once before running anything
+mkdir -p $DFLAG
+MANIFEST=$DFLAG/manifest.txt
+$MANGEN --seed $EFLAG --runs $RFLAG --min 0 --max 11 --out $MANIFEST
+
+# Strategies compared on each position, run in parallel from one setup
+VARIANTS="flood,smart,bestr"
 
 for i in $(seq 1 $RFLAG)
 do
-    POS=$($POSGEN --min 0 --max 11)
-
-    for j in "${TYPE[@]}"
-    do
-        RUN=$($PRINTF "$DFLAG/run-%02d" $i)
-        $PRINTF "Saving in %s\n" $RUN
+    set -- $(awk -v run=$i '$1 == run' $MANIFEST)
+    RNGRUN=$2
+    POS=$4
 
-        if [ ! -d $RUN ]; then
-            mkdir -p $RUN
-        fi
+    RUN=$($PRINTF "$DFLAG/run-%02d" $i)
+    $PRINTF "Saving in %s\n" $RUN
 
-         $WAF --run "$NDNSIM --results=$RUN --pos=$POS --trace $j"
-         #echo "----------"
-         #echo "Round $i"
-         #echo "Arg $j"
-         #echo "Position $POS"
+    if [ ! -d $RUN ]; then
+        mkdir -p $RUN
+    fi
 
-     done
+    $WAF --run "$NDNSIM --results=$RUN --pos=$POS --trace --variants=$VARIANTS --RngRun=$RNGRUN"
 done
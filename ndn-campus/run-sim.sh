@@ -2,7 +2,7 @@
 
 WAFDIR=$(pwd)
 WAF=${WAFDIR}/waf
-CONTSIZE=${WAFDIR}/random/content-size-generator
+MANGEN=${WAFDIR}/random/manifest-generator
 PRINTF=$(which printf)
 
 CFLAG=1
@@ -13,6 +13,7 @@ RFLAG=1
 TFLAG=0
 XFLAG=0
 DFLAG="results"
+EFLAG=1
 
 function usage() {
     echo "Tiny script to automize running of a ns3 scenario"
@@ -25,6 +26,7 @@ function usage() {
     echo "    -t        Run TCP scenario. Default [$TFLAG]"
     echo "    -x        Run NDN scenario. Default [$XFLAG]"
     echo "    -d DIR    Directory to place the results. Default [$DFLAG]"
+    echo "    -e NUM    Master seed of the sweep manifest. Default [$EFLAG]"
     echo ""
 }
 
@@ -33,7 +35,7 @@ function checkRun() {
     $WAF list 2>&1 > /dev/null | grep $1 2>&1 > /dev/null
 }
 
-while getopts "r:d:c:s:n:p:htx" OPT
+while getopts "r:d:e:c:s:n:p:htx" OPT
 do
     case $OPT in
     c)
@@ -60,6 +62,9 @@ do
     r)
         RFLAG=$OPTARG
         ;;
+    e)
+        EFLAG=$OPTARG
+        ;;
     \?)
         echo "Invalid option: -$OPTARG" >&2
         exit 1
@@ -79,8 +84,8 @@ do
     esac
 done
 
-if [ ! -x $CONTSIZE ]; then
-    echo "No $CONTSIZE! Compiling..."
+if [ ! -x $MANGEN ]; then
+    echo "No $MANGEN! Compiling..."
     cd random/
     make
     cd $WAF
@@ -93,6 +98,11 @@ fi
 
 source $WAFDIR/sims.conf
 
+# Every random input of all rounds, written once before running anything
+mkdir -p $DFLAG
+MANIFEST=$DFLAG/manifest.txt
+$MANGEN --seed $EFLAG --runs $RFLAG --avg $SFLAG --out $MANIFEST
+
 for i in $(seq 1 $RFLAG)
 do
 
@@ -101,7 +111,10 @@ do
         exit 0
     fi
 
-    BYTES=$($CONTSIZE --avg $SFLAG)
+    # Row i holds run, RngRun, content size, position and URL of round i
+    set -- $(awk -v run=$i '$1 == run' $MANIFEST)
+    RNGRUN=$2
+    BYTES=$3
 
     $PRINTF "Running %d clients, %d servers, %d networks, %d contentsize, Round %d\n" $CFLAG $PFLAG $NFLAG $BYTES $RFLAG
 
@@ -125,7 +138,7 @@ do
             exit 1
         fi
 
-        $WAF --run "$TCPSIM --clients=$CFLAG --contentsize=$BYTES --networks=$NFLAG --servers=$PFLAG  --results=$RUN"
+        $WAF --run "$TCPSIM --clients=$CFLAG --contentsize=$BYTES --networks=$NFLAG --servers=$PFLAG  --results=$RUN --RngRun=$RNGRUN"
     fi
 
     if [ $XFLAG -eq 1 ]; then
@@ -140,6 +153,6 @@ do
             exit 1
         fi
 
-        $WAF --run "$NDNSIM --clients=$CFLAG --contentsize=$BYTES --networks=$NFLAG --servers=$PFLAG  --results=$RUN"
+        $WAF --run "$NDNSIM --clients=$CFLAG --contentsize=$BYTES --networks=$NFLAG --servers=$PFLAG  --results=$RUN --RngRun=$RNGRUN"
     fi
 done
@@ -1,102 +1,313 @@
 #!/usr/bin/env python
 # -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
 
-from subprocess import call
-from sys import argv
+# Parameter sweep runner. Expands a grid of scenario parameters and a number
+# of replications into jobs and runs the built scenario binaries on all cores.
+#
+# Every job gets a deterministic RngRun and content size, derived from its
+# grid point and replication only, so the TCP and NDN scenarios of the same
+# point see the same random numbers and a job rerun gives the same results.
+# Each job writes into its own directory:
+#
+#   <results>/<scenario>/<param>-<value>_.../run-<NN>/
+#
+# with job.json (command line, seed, status) and job.log (output). Finished
+# jobs are skipped when the sweep is run again, failed ones are retried.
+
+from __future__ import print_function
+
+import argparse
+import hashlib
+import itertools
+import json
+import math
+import multiprocessing
 import os
+import random
+import re
+import signal
 import subprocess
-import workerpool
-import multiprocessing
-import argparse
+import sys
+import time
 
 ######################################################################
 ######################################################################
 ######################################################################
 
-parser = argparse.ArgumentParser(description='Simulation runner')
+parser = argparse.ArgumentParser(description='Simulation sweep runner')
 parser.add_argument('scenarios', metavar='scenario', type=str, nargs='*',
-                    help='Scenario to run')
+                    help='Scenarios to run, as built in build/')
 
 parser.add_argument('-l', '--list', dest="list", action='store_true', default=False,
                     help='Get list of available scenarios')
 
-parser.add_argument('-s', '--simulate', dest="simulate", action='store_true', default=False,
-                    help='Run simulation and postprocessing (false by default)')
+parser.add_argument('-t', '--tcp', dest="tcp", action='store_true', default=False,
+                    help='Run the TCP scenario of sims.conf ($TCPSIM)')
+parser.add_argument('-x', '--ndn', dest="ndn", action='store_true', default=False,
+                    help='Run the NDN scenario of sims.conf ($NDNSIM)')
 
-parser.add_argument('-g', '--no-graph', dest="graph", action='store_false', default=True,
-                    help='Do not build a graph for the scenario (builds a graph by default)')
+parser.add_argument('-n', '--networks', dest="networks", type=str, default="1",
+                    help='Networks to sweep, e.g. 4, 1:4 or 1,2,4 [1]')
+parser.add_argument('-p', '--servers', dest="servers", type=str, default="1",
+                    help='Servers (producers) to sweep [1]')
+parser.add_argument('-c', '--clients', dest="clients", type=str, default="1",
+                    help='Clients (consumers) to sweep [1]')
+parser.add_argument('-P', '--param', dest="params", type=str, action='append', default=[],
+                    help='Extra scenario parameter to sweep, as name=values (repeatable)')
 
-args = parser.parse_args()
+parser.add_argument('-r', '--runs', dest="runs", type=int, default=1,
+                    help='Replications of every grid point [1]')
+parser.add_argument('-s', '--size', dest="size", type=float, default=10,
+                    help='Average content size in MB, 0 to not pass --contentsize [10]')
+parser.add_argument('-d', '--results', dest="results", type=str, default="results",
+                    help='Directory to place the results [results]')
+parser.add_argument('--seed', dest="seed", type=int, default=1,
+                    help='Base seed, changes every RngRun and content size of the sweep [1]')
+parser.add_argument('-m', '--manifest', dest="manifest", type=str, default=None,
+                    help='Take RngRun and content size of replication N from row N of a '
+                         'random/manifest-generator file instead of deriving them')
 
-if not args.list and len(args.scenarios)==0:
-    print "ERROR: at least one scenario need to be specified"
-    parser.print_help()
-    exit (1)
+parser.add_argument('-j', '--jobs', dest="jobs", type=int, default=multiprocessing.cpu_count(),
+                    help='Jobs to run at once [%d]' % multiprocessing.cpu_count())
+parser.add_argument('--retries', dest="retries", type=int, default=2,
+                    help='Times to rerun a job that crashed [2]')
+parser.add_argument('--timeout', dest="timeout", type=float, default=0,
+                    help='Wall clock seconds after which a job is killed, 0 never [0]')
+parser.add_argument('-f', '--force', dest="force", action='store_true', default=False,
+                    help='Rerun jobs which already finished')
+parser.add_argument('--dry-run', dest="dry", action='store_true', default=False,
+                    help='Only print the jobs')
 
-if args.list:
-    print "Available scenarios: "
-else:
-    if args.simulate:
-        print "Simulating the following scenarios: " + ",".join (args.scenarios)
+parser.add_argument('-g', '--graph', dest="graph", action='store_true', default=False,
+                    help='Build the graphs/<scenario>.R graphs after the sweep')
+
+args = parser.parse_args()
 
-    if args.graph:
-        print "Building graphs for the following scenarios: " + ",".join (args.scenarios)
+BUILD = "build"
 
 ######################################################################
 ######################################################################
 ######################################################################
 
-class SimulationJob (workerpool.Job):
-    "Job to simulate things"
-    def __init__ (self, cmdline):
-        self.cmdline = cmdline
-    def run (self):
-        print (" ".join (self.cmdline))
-        subprocess.call (self.cmdline)
+def available():
+    "Scenario binaries present in the build directory"
+    scenarios = os.path.join(os.path.dirname(os.path.abspath(__file__)), "scenarios")
+    names = [f[:-3] for f in os.listdir(scenarios) if f.endswith(".cc")]
+    return sorted(n for n in names if os.access(os.path.join(BUILD, n), os.X_OK))
+
+def sims_conf():
+    "TCPSIM and NDNSIM from sims.conf, as used by run-sim.sh"
+    conf = {}
+    if os.path.exists("sims.conf"):
+        for line in open("sims.conf"):
+            match = re.match(r'^\s*(?:export\s+)?(\w+)=["\']?([^"\'#\s]*)', line)
+            if match:
+                conf[match.group(1)] = match.group(2)
+    return conf
+
+def values(spec):
+    "Expands 4, 1:4, 1:8:2 or 1,2,4 into a list of strings"
+    result = []
+    for part in spec.split(','):
+        if ':' in part:
+            bounds = [int(b) for b in part.split(':')]
+            step = bounds[2] if len(bounds) > 2 else 1
+            result.extend(str(v) for v in range(bounds[0], bounds[1] + 1, step))
+        else:
+            result.append(part)
+    return result
 
-pool = workerpool.WorkerPool(size = multiprocessing.cpu_count())
+def derive(*key):
+    "31 bit number derived from key, stable across runs and Python versions"
+    digest = hashlib.sha1(repr(key).encode('utf-8')).hexdigest()
+    return int(digest[:8], 16) & 0x7fffffff
 
-class Processor:
-    def run (self):
-        if args.list:
-            print "    " + self.name
-            return
+def manifest(path):
+    "Rows of a manifest-generator file, by run number"
+    rows = {}
+    for line in open(path):
+        if line.startswith('#') or not line.strip():
+            continue
+        run, rngrun, size, pos, url = line.rstrip('\n').split('\t')
+        rows[int(run)] = {"rngrun": int(rngrun), "contentsize": int(size), "pos": int(pos), "url": url}
+    return rows
 
-        if "all" not in args.scenarios and self.name not in args.scenarios:
-            return
+def content_size(seed, average):
+    "Geometric content size in bytes, like random/content-size-generator"
+    p = 1.0 / (average * 1048576)
+    u = random.Random(seed).random()
+    return int(math.floor(math.log(1.0 - u) / math.log(1.0 - p)))
 
-        if args.list:
-            pass
+######################################################################
+######################################################################
+######################################################################
+
+class Job:
+    "One run of a scenario at one grid point"
+    def __init__(self, scenario, point, replication):
+        self.scenario = scenario
+        self.point = point
+        self.replication = replication
+
+        # Independent of the scenario, so scenarios can be compared point by point
+        if MANIFEST:
+            row = MANIFEST[replication]
+            self.rngrun = row["rngrun"]
+            self.contentsize = row["contentsize"] if args.size > 0 else None
         else:
-            if args.simulate:
-                self.simulate ()
-                pool.join ()
-                self.postprocess ()
-            if args.graph:
-                self.graph ()
-
-    def graph (self):
-        subprocess.call ("./graphs/%s.R" % self.name, shell=True)
-
-class Scenario (Processor):
-    def __init__ (self, name):
-        self.name = name
-        # other initialization, if any
-
-    def simulate (self):
-        cmdline = ["./build/SCENARIO_TO_RUN"]
-        job = SimulationJob (cmdline)
-        pool.put (job)
-
-    def postprocess (self):
-        # any postprocessing, if any
-        pass
+            key = (args.seed, sorted(point.items()), replication)
+            self.rngrun = derive('rngrun', key) or 1
+            self.contentsize = content_size(derive('contentsize', key), args.size) if args.size > 0 else None
 
-try:
-    # Simulation, processing, and graph building
-    fig = Scenario (name="NAME_TO_CONFIGURE")
-    fig.run ()
+        name = "_".join("%s-%s" % (k, point[k]) for k in sorted(point)) or "default"
+        self.dir = os.path.join(args.results, scenario, name, "run-%02d" % replication)
+
+    def cmdline(self):
+        cmd = [os.path.join(BUILD, self.scenario)]
+        for k in sorted(self.point):
+            cmd.append("--%s=%s" % (k, self.point[k]))
+        if self.contentsize is not None:
+            cmd.append("--contentsize=%d" % self.contentsize)
+        cmd.append("--results=%s" % self.dir)
+        cmd.append("--RngRun=%d" % self.rngrun)
+        return cmd
+
+    def status(self):
+        try:
+            with open(os.path.join(self.dir, "job.json")) as f:
+                return json.load(f).get("status")
+        except (IOError, ValueError):
+            return None
+
+def run(job):
+    "Runs a job in a worker process, retrying crashes. Returns (job, record)"
+    if not os.path.isdir(job.dir):
+        os.makedirs(job.dir)
+
+    record = {
+        "scenario": job.scenario,
+        "parameters": job.point,
+        "replication": job.replication,
+        "rngrun": job.rngrun,
+        "contentsize": job.contentsize,
+        "cmdline": " ".join(job.cmdline()),
+        "attempts": [],
+    }
+
+    for attempt in range(args.retries + 1):
+        start = time.time()
+        with open(os.path.join(job.dir, "job.log"), "w") as log:
+            proc = subprocess.Popen(job.cmdline(), stdout=log, stderr=subprocess.STDOUT)
+            code = None
+            while code is None:
+                time.sleep(0.2)
+                code = proc.poll()
+                if code is None and args.timeout > 0 and time.time() - start > args.timeout:
+                    proc.kill()
+                    code = proc.wait()
+
+        record["attempts"].append({"code": code, "seconds": round(time.time() - start, 3)})
 
+        if code == 0:
+            break
+
+        # Keep the output of the failed attempt around
+        os.rename(os.path.join(job.dir, "job.log"), os.path.join(job.dir, "job-%d.log" % attempt))
+
+    record["status"] = "done" if code == 0 else "failed"
+    with open(os.path.join(job.dir, "job.json"), "w") as f:
+        json.dump(record, f, indent=1, sort_keys=True)
+
+    return job, record
+
+def init_worker():
+    # Ctrl-C is handled by the main process
+    signal.signal(signal.SIGINT, signal.SIG_IGN)
+
+######################################################################
+######################################################################
+######################################################################
+
+if args.list:
+    print("Available scenarios: ")
+    for name in available():
+        print("    " + name)
+    exit(0)
+
+scenarios = list(args.scenarios)
+conf = sims_conf()
+for flag, var in ((args.tcp, "TCPSIM"), (args.ndn, "NDNSIM")):
+    if flag:
+        if var not in conf:
+            print("ERROR: sims.conf does not declare $%s" % var)
+            exit(1)
+        scenarios.append(conf[var])
+
+if len(scenarios) == 0:
+    print("ERROR: at least one scenario need to be specified (or -t/-x)")
+    parser.print_help()
+    exit(1)
+
+# Checked once, not once per run
+for scenario in scenarios:
+    if not os.access(os.path.join(BUILD, scenario), os.X_OK):
+        print("ERROR: no %s binary, build it first with ./waf" % os.path.join(BUILD, scenario))
+        exit(1)
+
+MANIFEST = None
+if args.manifest:
+    MANIFEST = manifest(args.manifest)
+    missing = [r for r in range(1, args.runs + 1) if r not in MANIFEST]
+    if missing:
+        print("ERROR: %s has no row for run %d, generate at least %d runs" %
+              (args.manifest, missing[0], args.runs))
+        exit(1)
+
+axes = [("networks", values(args.networks)),
+        ("servers", values(args.servers)),
+        ("clients", values(args.clients))]
+for param in args.params:
+    name, spec = param.split("=", 1)
+    axes.append((name, values(spec)))
+
+names = [a[0] for a in axes]
+points = [dict(zip(names, combo)) for combo in itertools.product(*[a[1] for a in axes])]
+
+jobs = [Job(s, p, r) for s in scenarios for p in points for r in range(1, args.runs + 1)]
+todo = [j for j in jobs if args.force or j.status() != "done"]
+
+print("%d scenarios x %d points x %d runs = %d jobs, %d to run on %d cores" %
+      (len(scenarios), len(points), args.runs, len(jobs), len(todo), args.jobs))
+
+if args.dry:
+    for job in todo:
+        print(" ".join(job.cmdline()))
+    exit(0)
+
+failed = 0
+start = time.time()
+pool = multiprocessing.Pool(args.jobs, init_worker)
+
+try:
+    for n, (job, record) in enumerate(pool.imap_unordered(run, todo), 1):
+        attempts = record["attempts"]
+        if record["status"] != "done":
+            failed += 1
+        print("[%d/%d %.0fs] %s %s: %s after %d attempt(s), %.1fs" %
+              (n, len(todo), time.time() - start, job.scenario, job.dir, record["status"],
+               len(attempts), attempts[-1]["seconds"]))
+        sys.stdout.flush()
+    pool.close()
+except KeyboardInterrupt:
+    print("Interrupted, finished jobs are kept")
+    pool.terminate()
+    exit(1)
 finally:
-    pool.join ()
-    pool.shutdown ()
+    pool.join()
+
+if args.graph:
+    for scenario in scenarios:
+        if os.path.exists("./graphs/%s.R" % scenario):
+            subprocess.call("./graphs/%s.R" % scenario, shell=True)
+
+exit(1 if failed else 0)
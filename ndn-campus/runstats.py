@@ -0,0 +1,73 @@
+# -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+
+# Shared by the scripts comparing ways of running a scenario, such as
+# bench-fastmac.py, validate-phy.py, bench-placement.py and
+# bench-breadcrumbs.py: runs one replication into its own directory, sums
+# the NDN metrics of its app delay traces and reads its other traces.
+
+from __future__ import print_function
+
+import glob
+import os
+import subprocess
+import sys
+import time
+
+def run(cmd, results):
+    """Runs cmd with its output in <results>/run.log, after clearing the
+    traces of an earlier run there. Exits on failure, returns the wall clock
+    seconds taken."""
+    if not os.path.isdir(results):
+        os.makedirs(results)
+    for old in glob.glob(os.path.join(results, '*-app-delays-*')) + glob.glob(os.path.join(results, 'timing.json')):
+        os.remove(old)
+
+    start = time.time()
+    with open(os.path.join(results, 'run.log'), 'w') as log:
+        if subprocess.call(cmd, stdout=log, stderr=subprocess.STDOUT) != 0:
+            sys.exit('%s failed, see %s/run.log' % (' '.join(cmd), results))
+    return time.time() - start
+
+def delays(results):
+    """Satisfied Interests, and the sums of their delay, retransmissions and
+    hops"""
+    stats = [0, 0.0, 0.0, 0.0]
+    for filename in glob.glob(os.path.join(results, '*-app-delays-*')):
+        with open(filename) as f:
+            for line in f:
+                cols = line.split()
+                if len(cols) < 9 or cols[4] != 'FullDelay':
+                    continue
+                stats[0] += 1
+                stats[1] += float(cols[5])
+                stats[2] += float(cols[7])
+                stats[3] += float(cols[8])
+    return stats
+
+def summary(samples):
+    """Averages replications given as (values, delays) pairs: each key of
+    the values dict over the replications, interests per replication, and
+    delay, retx and hops per satisfied Interest."""
+    n = len(samples)
+    result = {}
+    for key in samples[0][0]:
+        result[key] = sum(s[0][key] for s in samples) / float(n)
+
+    count = sum(s[1][0] for s in samples)
+    mean = lambda i: sum(s[1][i] for s in samples) / count if count else 0.0
+    result.update({'interests': float(count) / n, 'delay': mean(1), 'retx': mean(2), 'hops': mean(3)})
+    return result
+
+def rows(results, pattern):
+    """Rows of the tab separated traces matching pattern in results, without
+    their header"""
+    for filename in glob.glob(os.path.join(results, pattern)):
+        with open(filename) as f:
+            for line in f:
+                cols = [col.strip() for col in line.split('\t')]
+                if cols and cols[0] != 'Time':
+                    yield cols
+
+def change(before, after):
+    """Change from before to after, in percent"""
+    return (after - before) / before * 100 if before else 0.0
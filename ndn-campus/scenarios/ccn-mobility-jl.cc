@@ -19,6 +19,7 @@
 // Standard C++ modules
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <fstream>
 #include <iterator>
@@ -50,28 +51,31 @@
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-rate-l3-tracer.h>
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-seqs-app-tracer.h>
 
+// Extensions
+#include "cached-propagation-loss-model.h"
+#include "grid-wifi-channel.h"
+#include "handoff-controller.h"
+#include "host-uplink-strategy.h"
+#include "mobility-trace.h"
+#include "phase-timer.h"
+#include "producer-mobility.h"
+#include "rng-streams.h"
+#include "unit-disk-helper.h"
+#include "variant-runner.h"
+
 using namespace ns3;
 using namespace boost;
 
 namespace br = boost::random;
 
-typedef struct timeval TIMER_TYPE;
-#define TIMER_NOW(_t) gettimeofday (&_t,NULL);
-#define TIMER_SECONDS(_t) ((double)(_t).tv_sec + (_t).tv_usec*1e-6)
-#define TIMER_DIFF(_t1, _t2) (TIMER_SECONDS (_t1)-TIMER_SECONDS (_t2))
-
 char scenario[250] = "CCNWireless";
 
 NS_LOG_COMPONENT_DEFINE (scenario);
 
-// Number generator
-br::mt19937_64 gen;
-
 // Obtains a random number from a uniform distribution between min and max.
-// Must seed number generator to ensure randomness at runtime.
+// Drawn from the placement stream, so it only depends on --RngRun.
 int obtain_Num(int min, int max) {
-    br::uniform_int_distribution<> dist(min, max);
-    return dist(gen);
+    return RngStreams::GetInteger ("placement", min, max);
 }
 
 std::vector<Ptr<Node> > getVector(NodeContainer node) {
@@ -192,9 +196,21 @@ int main (int argc, char *argv[])
 	bool traceFiles = false;			// Tells to run the simulation with traceFiles
 	bool smart = false;					// Tells to run the simulation with SmartFlooding
 	bool bestr = false;					// Tells to run the simulation with BestRoute
+	bool grid = false;					// Only deliver Wi-Fi frames to PHYs in range
+	bool fastmac = false;				// Ideal association, no beacons or probes
+	bool nearest = false;				// Ideal association with the closest AP
+	double outage = 0.0;				// Seconds without link on each ideal handoff
+	std::string phy = "wifi";			// Wireless model, wifi or unitdisk
+	std::string mobilityFile;			// Waypoint and handoff trace of the terminals
+	uint32_t mobileClients = 0;			// Mobile terminals running consumers
+	bool breadcrumbs = false;			// FIB entries following the producers
+	double expiry = 0.0;				// Seconds the previous breadcrumbs are kept
+	bool hostStack = false;				// Stateless forwarding on the user nodes
 
 	char results[250] = "results";
 	char buffer[250];
+	std::string timingFile;
+	std::string variants;				// Strategies to run from one setup
 
 	CommandLine cmd;
 
@@ -212,14 +228,81 @@ int main (int argc, char *argv[])
 	cmd.AddValue ("trace", "Enable trace files", traceFiles);
 	cmd.AddValue ("smart", "Enable SmartFlooding forwarding", smart);
 	cmd.AddValue ("bestr", "Enable BestRoute forwarding", bestr);
+	cmd.AddValue ("variants", "Comma separated strategies (flood, smart, bestr) to run in parallel from one setup", variants);
+	cmd.AddValue ("timing", "Append phase timings as a JSON record to this file", timingFile);
+	cmd.AddValue ("grid", "Use a GridWifiChannel, delivering only to PHYs in range", grid);
+	cmd.AddValue ("fastmac", "Ideal association: no beacon or probe frames, every AP on its own channel", fastmac);
+	cmd.AddValue ("nearest", "With --fastmac, associate with the closest AP instead of following the schedule", nearest);
+	cmd.AddValue ("outage", "With --fastmac, seconds a terminal is unreachable on each handoff", outage);
+	cmd.AddValue ("phy", "Wireless model of the terminals and APs: wifi (802.11a) or unitdisk", phy);
+	cmd.AddValue ("mobility", "Waypoint and handoff trace of the mobile terminals, see mobility-trace.h", mobilityFile);
+	cmd.AddValue ("mobileclients", "Mobile terminals running a consumer instead of a producer", mobileClients);
+	cmd.AddValue ("breadcrumbs", "Point the router FIBs at the AP of each producer on every association", breadcrumbs);
+	cmd.AddValue ("expiry", "With --breadcrumbs, seconds routers keep pointing at the previous AP", expiry);
+	cmd.AddValue ("hoststack", "User nodes pass packets between their apps and uplink, without PIT or FIB lookups", hostStack);
 	cmd.Parse (argc,argv);
 
+	if (mobileClients > mobile)
+	{
+		std::cerr << "Only " << mobile << " mobile terminals for " << mobileClients << " mobile clients" << std::endl;
+		return 1;
+	}
+
+	if (phy != "wifi" && phy != "unitdisk")
+	{
+		std::cerr << "Unknown wireless model " << phy << ", use wifi or unitdisk" << std::endl;
+		return 1;
+	}
+
+	// A bad variant name has to fail here, not in a child after the whole
+	// setup has been done
+	VariantRunner runner (variants);
+	for (uint32_t i = 0; i < runner.GetN (); i++)
+	{
+		const std::string &variant = runner.GetVariants ()[i];
+		if (variant != "flood" && variant != "smart" && variant != "bestr")
+		{
+			std::cerr << "Unknown strategy " << variant << ", use flood, smart or bestr" << std::endl;
+			return 1;
+		}
+	}
+
+	// Unit disk devices hear every AP in range, there is no 802.11 to
+	// speed up or associate
+	bool unitdisk = (phy == "unitdisk");
+	grid = grid && !unitdisk;
+	fastmac = fastmac && !unitdisk;
+
+	// Only the ideal association knows where the APs are
+	nearest = nearest && fastmac;
+
+	// Breadcrumbs follow the associations of the handoff controller
+	breadcrumbs = breadcrumbs && !unitdisk;
+
+	if (timingFile.empty ())
+	{
+		timingFile = std::string (results) + "/timing.json";
+	}
+
+	// Wall clock time spent in each phase of the run
+	PhaseTimer timer ("ccn-mobility-jl");
+	timer.SetParameter ("aps", aps);
+	timer.SetParameter ("mobile", mobile);
+	timer.SetParameter ("clients", clients);
+	timer.SetParameter ("nodes", nodes);
+	timer.SetParameter ("contentsize", contentsize);
+	timer.SetParameter ("fastmac", fastmac);
+	timer.SetParameter ("outage", outage);
+	timer.SetParameter ("phy", phy);
+	timer.SetParameter ("mobileclients", mobileClients);
+	timer.SetParameter ("breadcrumbs", breadcrumbs);
+	timer.SetParameter ("hoststack", hostStack);
+	timer.Begin ("topology");
+
 	// Node definitions for mobile terminals
 	NodeContainer mobileTerminalContainer;
 	mobileTerminalContainer.Create(mobile);
 
-	uint32_t mtId = mobileTerminalContainer.Get (0)->GetId();
-
 	// Nodes for APs
 	NodeContainer apsContainer;
 	apsContainer.Create (aps);
@@ -247,8 +330,6 @@ int main (int argc, char *argv[])
 	allUserNodes.Add (mobileTerminalContainer);
 	allUserNodes.Add (networkNodes);
 
-	// Make sure to seed our random
-	gen.seed(std::time(0));
 
 	// With the network assigned, time to randomly obtain clients and servers
 	NS_LOG_INFO ("Obtaining the clients and servers");
@@ -338,28 +419,50 @@ int main (int argc, char *argv[])
 	//mobilityTerminals.SetMobilityModel("ns3::ConstantPositionMobilityModel");
 	mobilityTerminals.Install(mobileTerminalContainer);
 
-	Ptr<WaypointMobilityModel> staWaypointMobility = DynamicCast<WaypointMobilityModel>(mobileTerminalContainer.Get (0)->GetObject<MobilityModel> ());
+	// Waypoints and handoffs of every terminal, by default all of them
+	// visiting the APs in turn
+	MobilityTrace mobilityTrace;
+
+	if (!mobilityFile.empty ())
+	{
+		mobilityTrace.Load (mobilityFile);
+		sec = mobilityTrace.GetEnd ().GetSeconds ();
+	}
+	else
+	{
+		sprintf(buffer, "Assigning waypoints - start: %f, pause: %f, travel: %f", sec, waitint, travelTime);
+
+		NS_LOG_INFO (buffer);
 
-	sprintf(buffer, "Assigning waypoints - start: %f, pause: %f, travel: %f", sec, waitint, travelTime);
+		double apsec = 0.0;
 
-	NS_LOG_INFO (buffer);
+		for (int j = 0; j < aps; j++)
+		{
+			mob = apsContainer.Get (j)->GetObject<MobilityModel>();
 
-	for (int j = 0; j < aps; j++)
-	{
-		mob = apsContainer.Get (j)->GetObject<MobilityModel>();
+			Vector wayP = mob->GetPosition ();
 
-		Vector wayP = mob->GetPosition ();
+			wayP.x += diff.x;
+			wayP.y += diff.y;
+			wayP.z += diff.z;
 
-		wayP.x += diff.x;
-		wayP.y += diff.y;
-		wayP.z += diff.z;
+			sprintf(buffer, "Setting mobile nodes to AP %i at %2f seconds", j, apsec);
+			NS_LOG_INFO (buffer);
 
-		staWaypointMobility->AddWaypoint (Waypoint(Seconds(sec), wayP));
-		staWaypointMobility->AddWaypoint (Waypoint(Seconds(sec + waitint), wayP));
+			for (uint32_t t = 0; t < mobile; t++)
+			{
+				mobilityTrace.AddWaypoint (t, Seconds (sec), wayP);
+				mobilityTrace.AddWaypoint (t, Seconds (sec + waitint), wayP);
+				mobilityTrace.AddHandoff (t, Seconds (apsec), j);
+			}
 
-		sec += waitint + travelTime;
+			sec += waitint + travelTime;
+			apsec += waitint + travelTime;
+		}
 	}
 
+	mobilityTrace.Install (mobileTerminalContainer);
+
 	NS_LOG_INFO ("Creating Wireless cards");
 
 	WifiHelper wifi = WifiHelper::Default ();
@@ -367,15 +470,36 @@ int main (int argc, char *argv[])
 
 	YansWifiChannelHelper wifiChannel;
 	wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
-	wifiChannel.AddPropagationLoss ("ns3::ThreeLogDistancePropagationLossModel");
+	// Same path loss, computed once between the static APs and routers
+	wifiChannel.AddPropagationLoss ("ns3::CachedPropagationLossModel",
+			"Model", PointerValue (CreateObject<ThreeLogDistancePropagationLossModel> ()));
 	wifiChannel.AddPropagationLoss ("ns3::NakagamiPropagationLossModel");
 
 	//YansWifiPhy wifiPhy = YansWifiPhy::Default();
 	YansWifiPhyHelper wifiPhyHelper = YansWifiPhyHelper::Default ();
-	wifiPhyHelper.SetChannel (wifiChannel.Create ());
+	Ptr<GridWifiChannel> gridChannel;
+	if (grid)
+	{
+		// Range of the mean path loss at our TX power, 10 dB kept for fading
+		gridChannel = GridWifiChannel::Create (wifiChannel);
+		double range = GridWifiChannel::GetRange (CreateObject<ThreeLogDistancePropagationLossModel> (), 5, -96 - 10);
+		gridChannel->SetAttribute ("MaxRange", DoubleValue (range));
+		wifiPhyHelper.SetChannel (gridChannel);
+	}
+	else
+	{
+		wifiPhyHelper.SetChannel (wifiChannel.Create ());
+	}
 	wifiPhyHelper.Set("TxPowerStart", DoubleValue(5));
 	wifiPhyHelper.Set("TxPowerEnd", DoubleValue(5));
 
+	// Same mean range and rate as the Wi-Fi cards, 6 Mbps being the
+	// default mode of ConstantRateWifiManager
+	UnitDiskHelper unitDisk;
+	unitDisk.SetChannelAttribute ("Range",
+			DoubleValue (GridWifiChannel::GetRange (CreateObject<ThreeLogDistancePropagationLossModel> (), 5, -96)));
+	unitDisk.SetDeviceAttribute ("DataRate", StringValue ("6Mbps"));
+
 	NqosWifiMacHelper wifiMacHelper = NqosWifiMacHelper::Default ();
 
 	std::vector<Ssid> ssidV;
@@ -393,21 +517,41 @@ int main (int argc, char *argv[])
 	//		"Ssid", SsidValue(ssidV[3]),
 			"ActiveProbing", BooleanValue (true));
 
-	NetDeviceContainer wifiMTNetDevices = wifi.Install (wifiPhyHelper, wifiMacHelper, mobileTerminalContainer);
+	// No association at all, the handoff controller picks the channel
+	if (fastmac)
+	{
+		wifiMacHelper.SetType ("ns3::AdhocWifiMac");
+	}
+
+	NetDeviceContainer wifiMTNetDevices = unitdisk ? unitDisk.Install (mobileTerminalContainer)
+			: wifi.Install (wifiPhyHelper, wifiMacHelper, mobileTerminalContainer);
 
 	NS_LOG_INFO ("Assigning AP wireless cards");
 	std::vector<NetDeviceContainer> wifiAPNetDevices;
 	for (int i = 0; i < aps; i++)
 	{
-		wifiMacHelper.SetType ("ns3::ApWifiMac",
-	                       "Ssid", SsidValue (ssidV[i]),
-	                       "BeaconGeneration", BooleanValue (true),
-	                       "BeaconInterval", TimeValue (Seconds (0.1)));
+		if (!fastmac)
+		{
+			wifiMacHelper.SetType ("ns3::ApWifiMac",
+		                       "Ssid", SsidValue (ssidV[i]),
+		                       "BeaconGeneration", BooleanValue (true),
+		                       "BeaconInterval", TimeValue (Seconds (0.1)));
+		}
 
-		wifiAPNetDevices.push_back (wifi.Install (wifiPhyHelper, wifiMacHelper, apsContainer.Get (i)));
+		wifiAPNetDevices.push_back (unitdisk ? unitDisk.Install (apsContainer.Get (i))
+				: wifi.Install (wifiPhyHelper, wifiMacHelper, apsContainer.Get (i)));
 
 	}
 
+	if (grid)
+	{
+		gridChannel->Add (wifiMTNetDevices);
+		for (int i = 0; i < aps; i++)
+		{
+			gridChannel->Add (wifiAPNetDevices[i]);
+		}
+	}
+
 	NS_LOG_INFO ("Creating Ptp connections");
 	NetDeviceContainer p2pAPDevices;
 
@@ -483,41 +627,94 @@ int main (int argc, char *argv[])
 
 	char routeType[250];
 
+	if (smart) {
+		snprintf(routeType, sizeof (routeType), "%s", "smart");
+	} else if (bestr) {
+		snprintf(routeType, sizeof (routeType), "%s", "bestr");
+	} else {
+		snprintf(routeType, sizeof (routeType), "%s", "flood");
+	}
+
+	// Everything up to here is the same for every strategy. With variants,
+	// each strategy continues in its own process from this point
+	if (runner.GetN () > 0)
+	{
+		if (!runner.Fork ())
+		{
+			return runner.Succeeded () ? 0 : 1;
+		}
+
+		snprintf(routeType, sizeof (routeType), "%s", runner.GetVariant ().c_str ());
+	}
+
+	timer.Begin ("stack");
+
 	// Now install content stores and the rest on the middle node. Leave
 	// out clients and the mobile node
 	NS_LOG_INFO ("Installing NDN stack on routers");
 	ndn::StackHelper ndnHelperRouters;
 
-	if (smart) {
-		sprintf(routeType, "%s", "smart");
+	if (strcmp (routeType, "smart") == 0) {
 		NS_LOG_INFO ("NDN Utilizing SmartFlooding");
 		ndnHelperRouters.SetForwardingStrategy ("ns3::ndn::fw::SmartFlooding::PerOutFaceLimits", "Limit", "ns3::ndn::Limits::Window");
-	} else if (bestr) {
-		sprintf(routeType, "%s", "bestr");
+	} else if (strcmp (routeType, "bestr") == 0) {
 		NS_LOG_INFO ("NDN Utilizing BestRoute");
 		ndnHelperRouters.SetForwardingStrategy ("ns3::ndn::fw::BestRoute::PerOutFaceLimits", "Limit", "ns3::ndn::Limits::Window");
-	} else {
-		sprintf(routeType, "%s", "flood");
+	} else if (strcmp (routeType, "flood") == 0) {
 		NS_LOG_INFO ("NDN Utilizing Flooding");
 		ndnHelperRouters.SetForwardingStrategy ("ns3::ndn::fw::Flooding::PerOutFaceLimits", "Limit", "ns3::ndn::Limits::Window");
+	} else {
+		std::cerr << "Unknown strategy " << routeType << ", use flood, smart or bestr" << std::endl;
+		return 1;
 	}
 
 	ndnHelperRouters.SetContentStore ("ns3::ndn::cs::Freshness::Lru", "MaxSize", "1000");
 	ndnHelperRouters.SetDefaultRoutes (true);
 	ndnHelperRouters.Install (allRouters);
 
+	timer.SetParameter ("strategy", routeType);
+
+	// Users only run one application behind their uplink. The host stack
+	// skips the PIT and the FIB on the way up and down, only the producers
+	// need FIB entries, for their own prefix
 	ndn::StackHelper ndnHelperUsers;
-	ndnHelperUsers.SetForwardingStrategy ("ns3::ndn::fw::BestRoute");
+	if (hostStack)
+	{
+		NS_LOG_INFO ("NDN Utilizing HostUplink on the users");
+		ndnHelperUsers.SetForwardingStrategy ("ns3::ndn::fw::HostUplink");
+		ndnHelperUsers.SetDefaultRoutes (false);
+	}
+	else
+	{
+		ndnHelperUsers.SetForwardingStrategy ("ns3::ndn::fw::BestRoute");
+		ndnHelperUsers.SetDefaultRoutes (true);
+	}
 	ndnHelperUsers.SetContentStore ("ns3::ndn::cs::Nocache");
-	ndnHelperUsers.SetDefaultRoutes (true);
 	ndnHelperUsers.Install (allUserNodes);
 
+	timer.Begin ("apps");
+
 	NS_LOG_INFO ("Installing Producer Application");
-	// Create the producer on the mobile node
+	// Create the producers on the mobile nodes, the last mobileClients of
+	// them consume instead
+	NodeContainer mobileProducers;
+	NodeContainer mobileConsumers;
+	for (uint32_t i = 0; i < mobile; i++)
+	{
+		if (i < mobile - mobileClients)
+		{
+			mobileProducers.Add (mobileTerminalContainer.Get (i));
+		}
+		else
+		{
+			mobileConsumers.Add (mobileTerminalContainer.Get (i));
+		}
+	}
+
 	ndn::AppHelper producerHelper ("ns3::ndn::Producer");
 	producerHelper.SetPrefix ("/waseda/sato");
 	producerHelper.SetAttribute("StopTime", TimeValue (Seconds(sec)));
-	producerHelper.Install (mobileTerminalContainer);
+	producerHelper.Install (mobileProducers);
 
 	NS_LOG_INFO ("Installing Consumer Application");
 	// Create the consumer on the randomly selected node
@@ -527,6 +724,7 @@ int main (int argc, char *argv[])
 	consumerHelper.SetAttribute("StartTime", TimeValue (Seconds(travelTime /2)));
 	consumerHelper.SetAttribute("StopTime", TimeValue (Seconds(sec-1)));
 	consumerHelper.Install (clientNodes);
+	consumerHelper.Install (mobileConsumers);
 
 	sprintf(buffer, "Ending time! %f", sec-1);
 	NS_LOG_INFO(buffer);
@@ -580,29 +778,81 @@ int main (int argc, char *argv[])
 
 	NS_LOG_INFO ("Scheduling events - Getting objects");
 
-	char configbuf[250];
-	// This causes the device in mtId to change the SSID, forcing AP change
-	sprintf(configbuf, "/NodeList/%d/DeviceList/0/$ns3::WifiNetDevice/Mac/Ssid", mtId);
+	// Changing the SSID of the mobile terminal forces the AP change. With
+	// --fastmac its PHY moves to the channel of the AP instead
+	HandoffController handoffs;
+	ndn::ProducerMobility producerMobility ("/waseda/sato");
 
-	// Schedule AP Changes
-	double apsec = 0.0;
-
-	NS_LOG_INFO ("Scheduling events - Installing events");
-	for (int j = 0; j < aps; j++)
+	// Unit disk terminals reach whichever AP their mobility takes them to
+	if (!unitdisk)
 	{
-		sprintf(buffer, "Setting mobile node to AP %i at %2f seconds", j, apsec);
-		NS_LOG_INFO (buffer);
+		if (fastmac)
+		{
+			handoffs.SetIdeal (Seconds (outage));
+		}
+		uint32_t terminal = handoffs.AddTerminals (wifiMTNetDevices);
+		for (int i = 0; i < aps; i++)
+		{
+			if (fastmac)
+			{
+				handoffs.AddAps (wifiAPNetDevices[i]);
+			}
+			else
+			{
+				handoffs.AddAp (ssidV[i]);
+			}
+		}
 
-		Simulator::Schedule (Seconds(apsec), Config::Set, configbuf, SsidValue (ssidV[j]));
+		// Routes from the LAN routers down to the AP of each producer
+		if (breadcrumbs)
+		{
+			producerMobility.AddRouters (allRouters);
+			producerMobility.AddAnchors (lanrouterNodes);
+			for (int i = 0; i < aps; i++)
+			{
+				producerMobility.AddAps (wifiAPNetDevices[i]);
+			}
+			for (uint32_t t = 0; t < mobile - mobileClients; t++)
+			{
+				producerMobility.AddProducer (terminal + t);
+			}
+			producerMobility.SetExpiry (Seconds (expiry));
+			producerMobility.Install (handoffs);
+		}
+
+		// Schedule AP Changes
+		NS_LOG_INFO ("Scheduling events - Installing events");
+		if (!nearest)
+		{
+			mobilityTrace.AddHandoffs (handoffs, terminal);
+		}
+		handoffs.Install ();
 
-		apsec += waitint + travelTime;
+		if (nearest)
+		{
+			handoffs.FollowNearest (MilliSeconds (100));
+		}
 	}
 
 	NS_LOG_INFO ("Ready for execution!");
 
-	Simulator::Stop (Seconds (28.0));
+	// The built-in waypoints end at 24 s and the run goes on 4 s past
+	// them. A loaded trace gets the same slack after its own end
+	Simulator::Stop (Seconds (mobilityFile.empty () ? 28.0 : sec + 4.0));
+	timer.Begin ("run");
 	Simulator::Run ();
+	timer.Begin ("teardown");
+
+	if (breadcrumbs)
+	{
+		NS_LOG_INFO ("Breadcrumbs moved " << producerMobility.GetHandoffs () << " times, "
+				<< producerMobility.GetUpdates () << " FIB updates");
+	}
 	Simulator::Destroy ();
+	timer.End ();
+
+	timer.Print (std::cout);
+	timer.Write (timingFile);
 }
 
 
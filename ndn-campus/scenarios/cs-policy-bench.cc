@@ -0,0 +1,242 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * cs-policy-bench.cc
+ *
+ *  Microbenchmark of the content store policies, without any network. The
+ *  lookups mix a few hot alert objects with sequential fetches of whole
+ *  contents, as the disaster clients walking MaxSeq segments do, and every
+ *  miss is added as the forwarding would. Each policy reports lookups per
+ *  second, hit ratios and heap bytes per stored entry after the lookups.
+ *
+ *  All stores are bounded to the same number of entries, the byte stores
+ *  also get MaxBytes for that many entries of the largest name.
+ *
+ *    ./waf --run "cs-policy-bench --policies=Lru,Arc,TwoQueue,WTinyLfu"
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <malloc.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <ns3-dev/ns3/core-module.h>
+#include <ns3-dev/ns3/network-module.h>
+
+#include <ns3-dev/ns3/ndnSIM-module.h>
+
+// Extensions
+#include "byte-content-store.h"
+#include "phase-timer.h"
+#include "rng-streams.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("CsPolicyBench");
+
+namespace {
+
+struct Object
+{
+	Ptr<ndn::Interest> interest;
+	Ptr<ndn::Data> data;
+	bool hot;
+};
+
+Object
+MakeObject (const std::string &uri, uint32_t payload, bool hot)
+{
+	Ptr<ndn::Name> name = Create<ndn::Name> (uri);
+
+	Object object;
+	object.interest = Create<ndn::Interest> ();
+	object.interest->SetName (name);
+	object.data = Create<ndn::Data> (Create<Packet> (payload));
+	object.data->SetName (name);
+	object.hot = hot;
+	return object;
+}
+
+// Heap bytes in use
+uint64_t
+HeapBytes (void)
+{
+	struct mallinfo info = mallinfo ();
+	return (unsigned int)info.uordblks;
+}
+
+} // anonymous namespace
+
+int main (int argc, char *argv[])
+{
+	std::string policies = "Lru,Arc,TwoQueue,WTinyLfu,Gdsf";
+	uint32_t entries = 3072;			// Entries every store holds
+	uint32_t payload = 1024;			// Bytes of each Data
+	uint32_t hot = 1000;				// Hot alert objects
+	double hotShare = 0.2;				// Share of lookups for them
+	uint32_t contents = 4;				// Contents fetched in turn
+	uint32_t maxSeq = 10240;			// Segments of each content
+	uint32_t lookups = 1000000;
+	std::string timingFile;
+
+	CommandLine cmd;
+	cmd.AddValue ("policies", "Comma separated ns3::ndn::cs types, without the namespace", policies);
+	cmd.AddValue ("entries", "Entries every store holds", entries);
+	cmd.AddValue ("payload", "Bytes of payload of each Data", payload);
+	cmd.AddValue ("hot", "Number of hot alert objects", hot);
+	cmd.AddValue ("hotshare", "Share of the lookups for the hot objects", hotShare);
+	cmd.AddValue ("contents", "Contents fetched sequentially in turn", contents);
+	cmd.AddValue ("maxseq", "Segments of each content", maxSeq);
+	cmd.AddValue ("lookups", "Lookups per policy", lookups);
+	cmd.AddValue ("timing", "Append phase timings as a JSON record to this file", timingFile);
+	cmd.Parse (argc, argv);
+
+	if (hot == 0 || contents == 0 || maxSeq == 0 || hotShare < 0.0 || hotShare > 1.0)
+	{
+		std::cerr << "Need hot objects, contents, segments and a hot share between 0 and 1" << std::endl;
+		return 1;
+	}
+
+	PhaseTimer timer ("cs-policy-bench");
+	timer.SetParameter ("entries", entries);
+	timer.SetParameter ("payload", payload);
+	timer.SetParameter ("hot", hot);
+	timer.SetParameter ("hotshare", hotShare);
+	timer.SetParameter ("contents", contents);
+	timer.SetParameter ("maxseq", maxSeq);
+	timer.SetParameter ("lookups", lookups);
+	timer.Begin ("workload");
+
+	// Hot objects first, then the segments of each content
+	std::vector<Object> objects;
+	uint32_t longestName = 0;
+	for (uint32_t i = 0; i < hot; i++)
+	{
+		std::ostringstream uri;
+		uri << "/waseda/alert/" << i;
+		objects.push_back (MakeObject (uri.str (), payload, true));
+	}
+	for (uint32_t c = 0; c < contents; c++)
+	{
+		for (uint32_t seq = 0; seq < maxSeq; seq++)
+		{
+			std::ostringstream uri;
+			uri << "/waseda/content" << c << "/" << seq;
+			objects.push_back (MakeObject (uri.str (), payload, false));
+		}
+	}
+	for (size_t i = 0; i < objects.size (); i++)
+	{
+		longestName = std::max (longestName, ndn::cs::ByteStore::GetCost (objects[i].data) - payload);
+	}
+
+	// The same sequence for every policy
+	std::vector<uint32_t> sequence;
+	sequence.reserve (lookups);
+	uint32_t next = 0;
+	for (uint32_t i = 0; i < lookups; i++)
+	{
+		if (RngStreams::Get ("workload")->GetValue () < hotShare)
+		{
+			sequence.push_back (RngStreams::GetInteger ("workload", 0, hot - 1));
+		}
+		else
+		{
+			sequence.push_back (hot + next);
+			next = (next + 1) % (contents * maxSeq);
+		}
+	}
+	timer.End ();
+
+	std::cout << std::left << std::setw (12) << "Policy" << std::right
+			<< std::setw (14) << "Lookups/s" << std::setw (10) << "Hits" << std::setw (10) << "HotHits"
+			<< std::setw (14) << "Bytes/entry" << std::endl;
+
+	std::istringstream list (policies);
+	std::string policy;
+	while (std::getline (list, policy, ','))
+	{
+		std::string type = "ns3::ndn::cs::" + policy;
+		TypeId tid;
+		if (!TypeId::LookupByNameFailSafe (type, &tid))
+		{
+			std::cerr << "Unknown content store " << type << std::endl;
+			return 1;
+		}
+
+		ObjectFactory factory;
+		factory.SetTypeId (tid);
+		factory.Set ("MaxSize", UintegerValue (entries));
+
+		struct TypeId::AttributeInformation info;
+		if (tid.LookupAttributeByName ("MaxBytes", &info))
+		{
+			factory.Set ("MaxBytes", UintegerValue ((uint64_t)entries * (payload + longestName)));
+		}
+
+		// Heap held by the store, the Data already exist
+		uint64_t heap = HeapBytes ();
+		Ptr<ndn::ContentStore> cs = factory.Create<ndn::ContentStore> ();
+		for (uint32_t i = 0; i < entries && i < objects.size (); i++)
+		{
+			cs->Add (objects[objects.size () - 1 - i].data);
+		}
+
+		uint32_t hits = 0;
+		uint32_t hotLookups = 0;
+		uint32_t hotHits = 0;
+
+		timer.Begin (policy);
+		for (uint32_t i = 0; i < sequence.size (); i++)
+		{
+			const Object &object = objects[sequence[i]];
+			bool hit = cs->Lookup (object.interest) != 0;
+			if (!hit)
+			{
+				cs->Add (object.data);
+			}
+
+			hits += hit;
+			hotLookups += object.hot;
+			hotHits += hit && object.hot;
+		}
+		timer.End ();
+
+		// Measured in steady state, once evictions filled the ghost lists and
+		// segments of the scan resistant policies
+		uint64_t held = std::max (HeapBytes (), heap) - heap;
+		double perEntry = cs->GetSize () ? (double)held / cs->GetSize () : 0.0;
+
+		double elapsed = timer.GetElapsed (policy);
+		std::cout << std::left << std::setw (12) << policy << std::right << std::fixed
+				<< std::setw (14) << std::setprecision (0) << (elapsed > 0.0 ? sequence.size () / elapsed : 0.0)
+				<< std::setw (10) << std::setprecision (4) << (sequence.empty () ? 0.0 : (double)hits / sequence.size ())
+				<< std::setw (10) << (hotLookups ? (double)hotHits / hotLookups : 0.0)
+				<< std::setw (14) << std::setprecision (1) << perEntry << std::endl;
+
+		cs->Dispose ();
+	}
+
+	timer.Print (std::cout);
+	if (!timingFile.empty ())
+	{
+		timer.Write (timingFile);
+	}
+
+	return 0;
+}
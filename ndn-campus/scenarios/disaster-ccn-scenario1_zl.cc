@@ -86,26 +86,29 @@
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-rate-l3-tracer.h>
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-seqs-app-tracer.h>
 
+// Extensions
+#include "cs-checkpoint.h"
+#include "gdsf-content-store.h"
+#include "placement-content-store.h"
+#include "ndn-capture.h"
+#include "phase-timer.h"
+#include "progress-meter.h"
+#include "rng-streams.h"
+
 using namespace ns3;
 using namespace boost;
 
 namespace br = boost::random;
 
-typedef struct timeval TIMER_TYPE;
-#define TIMER_NOW(_t) gettimeofday (&_t,NULL);
 //#define TIMER_SECONDS(_t) ((double)(_t).tv_sec + (_t).tv_usec*1e-6)
 //#define TIMER_DIFF(_t1, _t2) (TIMER_SECONDS (_t1)-TIMER_SECONDS (_t2))
 
 NS_LOG_COMPONENT_DEFINE ("CampusNetworkModel");
 //NS_LOG_INFO ("Obtaining the clients and servers");
-// Number generator
-br::mt19937_64 gen;
-
 // Obtains a random number from a uniform distribution between min and max.
-// Must seed number generator to ensure randomness at runtime.
+// Drawn from the placement stream, so it only depends on --RngRun.
 int obtain_Num(int min, int max) {
-    br::uniform_int_distribution<> dist(min, max);
-    return dist(gen);
+    return RngStreams::GetInteger ("placement", min, max);
 }
 
 
@@ -181,11 +184,6 @@ tuple<std::vector<Ptr<Node> >, std::vector<Ptr<Node> > > assignClientsandServers
 
     
 
-void Progress()
-{
-	Simulator::Schedule (Seconds (0.1), Progress);
-}
-
 template <typename T>
 class Array2D
 {
@@ -247,8 +245,6 @@ private:
 
 int main (int argc, char *argv[])
 {
-    TIMER_TYPE t0;
-	TIMER_NOW (t0);    
     std::cout << " ==== DARPA NMS CAMPUS NETWORK SIMULATION ====" << std::endl;
 
     // These are our scenario arguments
@@ -265,6 +261,23 @@ int main (int argc, char *argv[])
     // Char array for output strings
 	char buffer[250];
 
+    double progress = 10.0;
+    std::string progressFile;
+    std::string timingFile;
+
+    int captureNode = 8;
+    int captureFace = -1;
+    std::string capturePrefix;
+    uint32_t captureSize = 1048576;
+    uint32_t captureTimeouts = 100;
+
+    double duration = 80.0;
+    std::string csSave;
+    double csSaveAt = 80.0;
+    std::string csLoad;
+    uint64_t csBytes = 0;
+    std::string placement;
+
     CommandLine cmd;
 	cmd.AddValue ("CN", "Number of total CNs [2]", nCN);
 	cmd.AddValue ("LAN", "Number of nodes per LAN [42]", nLANClients);
@@ -275,8 +288,48 @@ int main (int argc, char *argv[])
 	cmd.AddValue ("servers", "Total number of servers in the network", servers);
 	cmd.AddValue ("networks", "Number of networks in the simulation", networks);
 	cmd.AddValue ("results", "Directory to place results", results);
+	cmd.AddValue ("progress", "Wall clock seconds between progress reports, 0 disables", progress);
+	cmd.AddValue ("progressfile", "Write progress reports as JSON lines to this file", progressFile);
+	cmd.AddValue ("timing", "Append phase timings as a JSON record to this file", timingFile);
+	cmd.AddValue ("capturenode", "Node to capture NDN packets on, -1 for all", captureNode);
+	cmd.AddValue ("captureface", "Face to capture NDN packets on, -1 for all", captureFace);
+	cmd.AddValue ("captureprefix", "Only capture NDN packets under this prefix", capturePrefix);
+	cmd.AddValue ("capturesize", "Packets kept by the NDN capture, 0 disables it", captureSize);
+	cmd.AddValue ("capturetimeouts", "Interest timeouts per second that dump the capture, 0 never", captureTimeouts);
+	cmd.AddValue ("duration", "Seconds the clients request content for", duration);
+	cmd.AddValue ("cssave", "Save the content stores to this file at --cssaveat", csSave);
+	cmd.AddValue ("cssaveat", "Simulated second at which the content stores are saved", csSaveAt);
+	cmd.AddValue ("csload", "Preload the content stores from a file written with --cssave", csLoad);
+	cmd.AddValue ("csbytes", "Bound the content stores in bytes with GDSF replacement, 0 for 3072 entries of LRU", csBytes);
+	cmd.AddValue ("placement", "Routers keeping a copy of each Data: Always, Lcd, ProbCache or Betweenness", placement);
 	cmd.Parse (argc,argv);
 
+	if (!placement.empty () && placement != "Always" && placement != "Lcd"
+			&& placement != "ProbCache" && placement != "Betweenness")
+	{
+		std::cerr << "Unknown placement " << placement << ", use Always, Lcd, ProbCache or Betweenness" << std::endl;
+		return 1;
+	}
+
+	// Count events for the progress meter, before any Node exists
+	ProgressMeter::EnableEventCounting ();
+
+	if (timingFile.empty ())
+	{
+		timingFile = std::string (results) + "/timing.json";
+	}
+
+	// Wall clock time spent in each phase of the run
+	PhaseTimer timer ("disaster-ccn-scenario1_zl");
+	timer.SetParameter ("networks", networks);
+	timer.SetParameter ("servers", servers);
+	timer.SetParameter ("clients", clients);
+	timer.SetParameter ("contentsize", contentsize);
+	timer.SetParameter ("csbytes", csBytes);
+	timer.SetParameter ("placement", placement);
+	timer.SetParameter ("strategy", "ns3::ndn::fw::Flooding");
+	timer.Begin ("topology");
+
     std::cout << "Number of CNs: " << nCN << ", LAN nodes: " << nLANClients << std::endl;
     
     // NodeContainer Vectors
@@ -596,8 +649,6 @@ int main (int argc, char *argv[])
 		delete[] nodes_ring;
 	}
 
-    // Make sure to seed our random
-	gen.seed(std::time(0));
 
     // With the network assigned, time to randomly obtain clients 
 	NS_LOG_INFO ("Obtaining the clients");
@@ -636,16 +687,47 @@ int main (int argc, char *argv[])
 	serverNodeIds.push_back(server_nodeNum);
 
    
+    timer.Begin ("stack");
+
     ndn::StackHelper ndnHelper;
     // Install Content Store    
-    ndnHelper.SetContentStore("ns3::ndn::cs::Freshness::Lru","MaxSize","3072");// 30% of whole contents
+    std::string store = "ns3::ndn::cs::Freshness::Lru";
+    std::string bound = "MaxSize";
+    std::string size = "3072";// 30% of whole contents
+    if (csBytes > 0)
+    {
+        // Same share of the contents whatever the object sizes
+        store = "ns3::ndn::cs::Gdsf";
+        bound = "MaxBytes";
+        size = boost::lexical_cast<std::string> (csBytes);
+    }
+
+    if (placement.empty ())
+    {
+        ndnHelper.SetContentStore (store, bound, size);
+    }
+    else
+    {
+        // Same store, kept only where the placement decides
+        ndnHelper.SetContentStore ("ns3::ndn::cs::Placement", "Store", store + "[" + bound + "=" + size + "]",
+                "Decision", placement);
+    }
 	ndnHelper.InstallAll ();
+
+    if (placement == "Betweenness")
+    {
+        ndn::cs::Placement::ComputeCentralities (NodeContainer::GetGlobal ());
+    }
 	
+    timer.Begin ("routes");
+
     ndn::GlobalRoutingHelper ndnGlobalRoutingHelper1;
 	ndnGlobalRoutingHelper1.InstallAll ();
 	ndnGlobalRoutingHelper1.AddOrigins ("/Dinfo/tokyo/shinjuku/waseda-u/waseda", serverNodes);
 	ndn::GlobalRoutingHelper::CalculateRoutes ();    
     
+    timer.Begin ("apps");
+
     // Consumer
     ndn::AppHelper consumerHelper ("ns3::ndn::ConsumerCbr");
 	// Consumer will request /prefix/0, /prefix/1, ...
@@ -659,7 +741,7 @@ int main (int argc, char *argv[])
 
 	apps = consumerHelper.Install (clientNodes);
 	apps.Start (Seconds (0.1));
-	apps.Stop (Seconds (80.0)); 
+	apps.Stop (Seconds (duration));
     
 
     // Producer
@@ -710,14 +792,61 @@ int main (int argc, char *argv[])
 	
     ndn::CsTracer::InstallAll (filename, Seconds (0.1));
 
-	//p2p_1gb5ms.EnablePcap ("results/ccn_test0.pcap", nodes_net1[0][5].Get (0)->GetId (), true,true);
-    sprintf (filename, "%s/ccn_server-%02d-%03d-%03d-%0*d.pcap", results, networks, servers, clients, 12, contentsize);
-    p2p_1gb5ms.EnablePcap (filename, 8, true,true);
-	//p2p_1gb5ms.EnablePcap ("results/tcp_test1.pcap", serverNodes.Get(1)->GetId (), true,true);
+	// NDN header capture instead of a full pcap, cheap enough to leave on
+	ndn::NdnCapture capture (captureSize);
+
+	if (captureSize > 0)
+	{
+		if (captureNode >= 0)
+		{
+			capture.AddNode (captureNode);
+		}
+		if (captureFace >= 0)
+		{
+			capture.SetFace (captureFace);
+		}
+		if (!capturePrefix.empty ())
+		{
+			capture.SetPrefix (capturePrefix);
+		}
+		capture.InstallAll ();
+
+		sprintf (filename, "%s/ccn_server-%02d-%03d-%03d-%0*d", results, networks, servers, clients, 12, contentsize);
+		if (captureTimeouts > 0)
+		{
+			capture.SetTimeoutTrigger (captureTimeouts, Seconds (1.0), filename);
+		}
+		capture.DumpAtEnd (std::string (filename) + ".ndncap");
+	}
 	
-    Simulator::Stop (Seconds (90.0));
+	// Warm cache checkpoint, saved at the end of a warm-up run and loaded
+	// by the measurement runs
+	ndn::CsCheckpoint checkpoint;
+
+	if (!csSave.empty ())
+	{
+		checkpoint.InstallAll ();
+		checkpoint.SaveAt (Seconds (csSaveAt), csSave);
+	}
+
+	if (!csLoad.empty () && !checkpoint.Load (csLoad))
+	{
+		return 1;
+	}
+
+    Simulator::Stop (Seconds (duration + 10.0));
+
+	ProgressMeter meter (progress, progressFile);
+	meter.Start ();
+
+	timer.Begin ("run");
 	Simulator::Run ();
+	timer.Begin ("teardown");
 	Simulator::Destroy ();
+	timer.End ();
+
+	timer.Print (std::cout);
+	timer.Write (timingFile);
 	return 0;
 }
 
@@ -74,27 +74,24 @@
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-rate-l3-tracer.h>
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-seqs-app-tracer.h>
 
+// Extensions
+#include "name-table.h"
+#include "phase-timer.h"
+#include "progress-meter.h"
+#include "rng-streams.h"
+
 using namespace ns3;
 using namespace boost;
 using namespace std;
 
 namespace br = boost::random;
 
-typedef struct timeval TIMER_TYPE;
-#define TIMER_NOW(_t) gettimeofday (&_t,NULL);
-#define TIMER_SECONDS(_t) ((double)(_t).tv_sec + (_t).tv_usec*1e-6)
-#define TIMER_DIFF(_t1, _t2) (TIMER_SECONDS (_t1)-TIMER_SECONDS (_t2))
-
 NS_LOG_COMPONENT_DEFINE ("CampusNetworkModel");
 
-// Number generator
-br::mt19937_64 gen;
-
 // Obtains a random number from a uniform distribution between min and max.
-// Must seed number generator to ensure randomness at runtime.
+// Drawn from the placement stream, so it only depends on --RngRun.
 int obtain_Num(int min, int max) {
-    br::uniform_int_distribution<> dist(min, max);
-    return dist(gen);
+    return RngStreams::GetInteger ("placement", min, max);
 }
 
 // Obtains a random list of clients and servers. Must be run once all nodes have been
@@ -157,11 +154,6 @@ tuple<std::vector<Ptr<Node> >, std::vector<Ptr<Node> > > assignClientsandServers
 	return tuple<std::vector<Ptr<Node> >, std::vector<Ptr<Node> > > (ClientContainer,ServerContainer);
 }
 
-void Progress ()
-{
-	Simulator::Schedule (Seconds (0.1), Progress);
-}
-
 template <typename T>
 class Array2D
 {
@@ -223,8 +215,6 @@ private:
 
 int main (int argc, char *argv[])
 {
-	TIMER_TYPE t0, t1, t2;
-	TIMER_NOW (t0);
 	std::cout << " ==== DARPA NMS CAMPUS NETWORK SIMULATION ====" << std::endl;
 
 	// These are our scenario arguments
@@ -243,6 +233,10 @@ int main (int argc, char *argv[])
 
 
 	
+	double progress = 10.0;
+	std::string progressFile;
+	std::string timingFile;
+
 	CommandLine cmd;
 	cmd.AddValue ("CN", "Number of total CNs [2]", nCN);
 	cmd.AddValue ("LAN", "Number of nodes per LAN [42]", nLANClients);
@@ -252,7 +246,27 @@ int main (int argc, char *argv[])
 	cmd.AddValue ("clients", "Total number of clients in the network", clients);
 	cmd.AddValue ("servers", "Total number of servers in the network", servers);
 	cmd.AddValue ("networks", "Number of networks in the simulation", networks);
+	cmd.AddValue ("progress", "Wall clock seconds between progress reports, 0 disables", progress);
+	cmd.AddValue ("progressfile", "Write progress reports as JSON lines to this file", progressFile);
+	cmd.AddValue ("timing", "Append phase timings as a JSON record to this file", timingFile);
 	cmd.Parse (argc,argv);
+
+	// Count events for the progress meter, before any Node exists
+	ProgressMeter::EnableEventCounting ();
+
+	if (timingFile.empty ())
+	{
+		timingFile = std::string (results) + "/timing.json";
+	}
+
+	// Wall clock time spent in each phase of the run
+	PhaseTimer timer ("disaster-ccn-scenario1v1");
+	timer.SetParameter ("networks", networks);
+	timer.SetParameter ("servers", servers);
+	timer.SetParameter ("clients", clients);
+	timer.SetParameter ("contentsize", contentsize);
+	timer.SetParameter ("strategy", "ns3::ndn::fw::BestRoute");
+	timer.Begin ("topology");
 	/*if (nCN < 2)
 	{
 		std::cout << "Number of total CNs (" << nCN << ") lower than minimum of 2"
@@ -569,8 +583,6 @@ int main (int argc, char *argv[])
 		delete[] nodes_ring;
 	}
 
-	// Make sure to seed our random
-	gen.seed(std::time(0));
 	
 	// With the network assigned, time to randomly obtain clients and servers
 	NS_LOG_INFO ("Obtaining the clients and servers");
@@ -598,6 +610,8 @@ int main (int argc, char *argv[])
 	//ApplicationContainer apps;
 	//std::string prefix = "results/congestion-pop-run-";
 	
+	timer.Begin ("stack");
+
 	ndn::StackHelper ndnHelper;
 	
     // Install Content Store
@@ -607,6 +621,8 @@ int main (int argc, char *argv[])
 
 	ndnHelper.InstallAll ();
 	
+	timer.Begin ("routes");
+
 	ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
 	ndnGlobalRoutingHelper.InstallAll ();
 	if (networks == 1){
@@ -628,9 +644,10 @@ int main (int argc, char *argv[])
 	ndn::GlobalRoutingHelper::CalculateRoutes ();
 
 	
+	timer.Begin ("apps");
+
 	//ApplicationContainer apps;
 	ndn::AppHelper producerHelper ("ns3::ndn::Producer");
-	srand((int)time(NULL)); 
     
     // server NodeContainer
     if (servers == 1){
@@ -688,20 +705,18 @@ int main (int argc, char *argv[])
 			clientNodes.Add(tmp);
 			clientNodeIds.push_back(nodeNum);
 			
-			int r = rand()%clients; //generate a random number [1,clients]
+			int r = RngStreams::GetInteger ("prefix", 0, clients - 1); //generate a random number [1,clients]
 			
-			char   newprefix[64]="/Dinfo/tokyo/shinjuku/wasedau/net1/server/";
-			//std::string prefix = "/Dinfo/tokyo/shinjuku/wasedau/net1/server/";
-			sprintf (newprefix, "%s%d", newprefix,r);
+			uint32_t newprefix = ndn::NameTable::Intern ("/Dinfo/tokyo/shinjuku/wasedau/net1/server/" + lexical_cast<std::string> (r));
 			
 			ndn::AppHelper consumerHelper ("ns3::ndn::ConsumerCbr");
 			consumerHelper.SetAttribute ("Frequency", StringValue ("100")); 
 			consumerHelper.SetAttribute ("MaxSeq", IntegerValue (10240));
 			consumerHelper.SetAttribute ("Randomize", StringValue ("exponential"));
-			consumerHelper.SetPrefix (newprefix);
+			ndn::NameTable::SetPrefix (consumerHelper, newprefix);
 			consumerHelper.Install (clientNodes.Get (i));// let every client ask for different content(maybe the same)
 				
-			producerHelper.SetPrefix (newprefix);
+			ndn::NameTable::SetPrefix (producerHelper, newprefix);
 			producerHelper.SetAttribute ("PayloadSize", StringValue("1024"));
 			producerHelper.SetAttribute ("Freshness", TimeValue (Seconds(0)));
 			producerHelper.Install (nodes_net1[0][5].Get (0));
@@ -722,21 +737,19 @@ int main (int argc, char *argv[])
 			
 			
 
-			    int r = rand()%clients; //generate a random number [1,clients]
+			    int r = RngStreams::GetInteger ("prefix", 0, clients - 1); //generate a random number [1,clients]
 			
-			    char   newprefix[64]="/Dinfo/tokyo/shinjuku/wasedau/net1/server/";
-			    //std::string prefix = "/Dinfo/tokyo/shinjuku/wasedau/net1/server/";
-			    sprintf (newprefix, "%s%d", newprefix,r);
+			    uint32_t newprefix = ndn::NameTable::Intern ("/Dinfo/tokyo/shinjuku/wasedau/net1/server/" + lexical_cast<std::string> (r));
 			
 			
 			    ndn::AppHelper consumerHelper ("ns3::ndn::ConsumerCbr");
 			    consumerHelper.SetAttribute ("Frequency", StringValue ("100")); 
 			    consumerHelper.SetAttribute ("MaxSeq", IntegerValue (10240));
 			    consumerHelper.SetAttribute ("Randomize", StringValue ("exponential"));
-			    consumerHelper.SetPrefix (newprefix);
+			    ndn::NameTable::SetPrefix (consumerHelper, newprefix);
 			    consumerHelper.Install (clientNodes.Get (i));// let every client ask for different content(maybe the same)
 				
-			    producerHelper.SetPrefix (newprefix);
+			    ndn::NameTable::SetPrefix (producerHelper, newprefix);
 			    producerHelper.SetAttribute ("PayloadSize", StringValue("1024"));
 			    producerHelper.SetAttribute ("Freshness", TimeValue (Seconds(0)));
 			    producerHelper.Install (nodes_net1[0][5].Get (0));
@@ -753,20 +766,18 @@ int main (int argc, char *argv[])
 			    clientNodes.Add(tmp);
 			    clientNodeIds.push_back(nodeNum);
 			
-			    int r = rand()%clients; //generate a random number [1,clients]
+			    int r = RngStreams::GetInteger ("prefix", 0, clients - 1); //generate a random number [1,clients]
 			
-			    char   newprefix1[64]="/Dinfo/tokyo/shinjuku/nishiwasedau/net1/server/";
-			    //std::string prefix = "/Dinfo/tokyo/shinjuku/wasedau/net1/server/";
-			    sprintf (newprefix1, "%s%d", newprefix1,r);
+			    uint32_t newprefix1 = ndn::NameTable::Intern ("/Dinfo/tokyo/shinjuku/nishiwasedau/net1/server/" + lexical_cast<std::string> (r));
 				
 			    ndn::AppHelper consumerHelper ("ns3::ndn::ConsumerCbr");
 			    consumerHelper.SetAttribute ("Frequency", StringValue ("100")); 
 			    consumerHelper.SetAttribute ("MaxSeq", IntegerValue (10240));
 			    consumerHelper.SetAttribute ("Randomize", StringValue ("exponential"));
-			    consumerHelper.SetPrefix (newprefix1);
+			    ndn::NameTable::SetPrefix (consumerHelper, newprefix1);
 			    consumerHelper.Install (clientNodes.Get (i));// let every client ask for different content(maybe the same)
 				
-			    producerHelper.SetPrefix (newprefix1);
+			    ndn::NameTable::SetPrefix (producerHelper, newprefix1);
 			    producerHelper.SetAttribute ("PayloadSize", StringValue("1024"));
 			    producerHelper.SetAttribute ("Freshness", TimeValue (Seconds(0)));
 			    producerHelper.Install (nodes_net1[1][5].Get (0));
@@ -786,21 +797,19 @@ int main (int argc, char *argv[])
 			
 			
 
-			    int r = rand()%clients; //generate a random number [1,clients]
+			    int r = RngStreams::GetInteger ("prefix", 0, clients - 1); //generate a random number [1,clients]
 			
-			    char   newprefix0[64]="/Dinfo/tokyo/shinjuku/wasedau/net1/server/";
-			    //std::string prefix = "/Dinfo/tokyo/shinjuku/wasedau/net1/server/";
-			    sprintf (newprefix0, "%s%d", newprefix0,r);
+			    uint32_t newprefix0 = ndn::NameTable::Intern ("/Dinfo/tokyo/shinjuku/wasedau/net1/server/" + lexical_cast<std::string> (r));
 			
 			
 			    ndn::AppHelper consumerHelper ("ns3::ndn::ConsumerCbr");
 			    consumerHelper.SetAttribute ("Frequency", StringValue ("100")); 
 			    consumerHelper.SetAttribute ("MaxSeq", IntegerValue (10240));
 			    consumerHelper.SetAttribute ("Randomize", StringValue ("exponential"));
-			    consumerHelper.SetPrefix (newprefix0);
+			    ndn::NameTable::SetPrefix (consumerHelper, newprefix0);
 			    consumerHelper.Install (clientNodes.Get (i));// let every client ask for different content(maybe the same)
 				
-			    producerHelper.SetPrefix (newprefix0);
+			    ndn::NameTable::SetPrefix (producerHelper, newprefix0);
 			    producerHelper.SetAttribute ("PayloadSize", StringValue("1024"));
 			    producerHelper.SetAttribute ("Freshness", TimeValue (Seconds(0)));
 			    producerHelper.Install (nodes_net1[0][5].Get (0));
@@ -819,21 +828,19 @@ int main (int argc, char *argv[])
 			
 			
 
-			    int r = rand()%clients; //generate a random number [1,clients]
+			    int r = RngStreams::GetInteger ("prefix", 0, clients - 1); //generate a random number [1,clients]
 			
-			    char   newprefix1[64]="/Dinfo/tokyo/shinjuku/nishiwasedau/net1/server/";
-			    //std::string prefix = "/Dinfo/tokyo/shinjuku/wasedau/net1/server/";
-			    sprintf (newprefix1, "%s%d", newprefix1,r);
+			    uint32_t newprefix1 = ndn::NameTable::Intern ("/Dinfo/tokyo/shinjuku/nishiwasedau/net1/server/" + lexical_cast<std::string> (r));
 			
 			
 			    ndn::AppHelper consumerHelper ("ns3::ndn::ConsumerCbr");
 			    consumerHelper.SetAttribute ("Frequency", StringValue ("100")); 
 			    consumerHelper.SetAttribute ("MaxSeq", IntegerValue (10240));
 			    consumerHelper.SetAttribute ("Randomize", StringValue ("exponential"));
-			    consumerHelper.SetPrefix (newprefix1);
+			    ndn::NameTable::SetPrefix (consumerHelper, newprefix1);
 			    consumerHelper.Install (clientNodes.Get (i));// let every client ask for different content(maybe the same)
 				
-			    producerHelper.SetPrefix (newprefix1);
+			    ndn::NameTable::SetPrefix (producerHelper, newprefix1);
 			    producerHelper.SetAttribute ("PayloadSize", StringValue("1024"));
 			    producerHelper.SetAttribute ("Freshness", TimeValue (Seconds(0)));
 			    producerHelper.Install (nodes_net1[1][5].Get (0));
@@ -852,21 +859,19 @@ int main (int argc, char *argv[])
 			
 			
 
-			    int r = rand()%clients; //generate a random number [1,clients]
+			    int r = RngStreams::GetInteger ("prefix", 0, clients - 1); //generate a random number [1,clients]
 			
-			    char   newprefix2[64]="/Dinfo/tokyo/shinjuku/toyamawasedau/net1/server/";
-			    //std::string prefix = "/Dinfo/tokyo/shinjuku/wasedau/net1/server/";
-			    sprintf (newprefix2, "%s%d", newprefix2,r);
+			    uint32_t newprefix2 = ndn::NameTable::Intern ("/Dinfo/tokyo/shinjuku/toyamawasedau/net1/server/" + lexical_cast<std::string> (r));
 			
 			
 			    ndn::AppHelper consumerHelper ("ns3::ndn::ConsumerCbr");
 			    consumerHelper.SetAttribute ("Frequency", StringValue ("100")); 
 			    consumerHelper.SetAttribute ("MaxSeq", IntegerValue (10240));
 			    consumerHelper.SetAttribute ("Randomize", StringValue ("exponential"));
-			    consumerHelper.SetPrefix (newprefix2);
+			    ndn::NameTable::SetPrefix (consumerHelper, newprefix2);
 			    consumerHelper.Install (clientNodes.Get (i));// let every client ask for different content(maybe the same)
 				
-			    producerHelper.SetPrefix (newprefix2);
+			    ndn::NameTable::SetPrefix (producerHelper, newprefix2);
 			    producerHelper.SetAttribute ("PayloadSize", StringValue("1024"));
 			    producerHelper.SetAttribute ("Freshness", TimeValue (Seconds(0)));
 			    producerHelper.Install (nodes_net1[2][5].Get (0));
@@ -923,7 +928,17 @@ int main (int argc, char *argv[])
 	//p2p_1gb5ms.EnablePcap ("results/tcp_test1.pcap", serverNodes.Get(1)->GetId (), true,true);
 	
     Simulator::Stop (Seconds (60.0));
+
+	ProgressMeter meter (progress, progressFile);
+	meter.Start ();
+
+	timer.Begin ("run");
 	Simulator::Run ();
+	timer.Begin ("teardown");
 	Simulator::Destroy ();
+	timer.End ();
+
+	timer.Print (std::cout);
+	timer.Write (timingFile);
 	return 0;		
 }
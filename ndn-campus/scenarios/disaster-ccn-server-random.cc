@@ -74,26 +74,23 @@
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-rate-l3-tracer.h>
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-seqs-app-tracer.h>
 
+// Extensions
+#include "name-table.h"
+#include "phase-timer.h"
+#include "progress-meter.h"
+#include "rng-streams.h"
+
 using namespace ns3;
 using namespace boost;
 
 namespace br = boost::random;
 
-typedef struct timeval TIMER_TYPE;
-#define TIMER_NOW(_t) gettimeofday (&_t,NULL);
-#define TIMER_SECONDS(_t) ((double)(_t).tv_sec + (_t).tv_usec*1e-6)
-#define TIMER_DIFF(_t1, _t2) (TIMER_SECONDS (_t1)-TIMER_SECONDS (_t2))
-
 NS_LOG_COMPONENT_DEFINE ("CampusNetworkModel");
 
-// Number generator
-br::mt19937_64 gen;
-
 // Obtains a random number from a uniform distribution between min and max.
-// Must seed number generator to ensure randomness at runtime.
+// Drawn from the placement stream, so it only depends on --RngRun.
 int obtain_Num(int min, int max) {
-    br::uniform_int_distribution<> dist(min, max);
-    return dist(gen);
+    return RngStreams::GetInteger ("placement", min, max);
 }
 
 // Obtains a random list of clients and servers. Must be run once all nodes have been
@@ -156,11 +153,6 @@ tuple<std::vector<Ptr<Node> >, std::vector<Ptr<Node> > > assignClientsandServers
 	return tuple<std::vector<Ptr<Node> >, std::vector<Ptr<Node> > > (ClientContainer,ServerContainer);
 }
 
-void Progress ()
-{
-	Simulator::Schedule (Seconds (0.1), Progress);
-}
-
 template <typename T>
 class Array2D
 {
@@ -222,8 +214,6 @@ private:
 
 int main (int argc, char *argv[])
 {
-	TIMER_TYPE t0, t1, t2;
-	TIMER_NOW (t0);
 	std::cout << " ==== DARPA NMS CAMPUS NETWORK SIMULATION ====" << std::endl;
 	LogComponentEnable ("OnOffApplication", LOG_LEVEL_INFO);
 
@@ -238,6 +228,11 @@ int main (int argc, char *argv[])
 	uint32_t clients = 10; // Number of clients in the network
 	uint32_t servers = 1; // Number of servers in the network
 	uint32_t networks = 1; // Number of additional nodes in the network
+	char results[250] = "results";
+
+	double progress = 10.0;
+	std::string progressFile;
+	std::string timingFile;
 
 	CommandLine cmd;
 	cmd.AddValue ("CN", "Number of total CNs [2]", nCN);
@@ -248,7 +243,28 @@ int main (int argc, char *argv[])
 	cmd.AddValue ("clients", "Total number of clients in the network", clients);
 	cmd.AddValue ("servers", "Total number of servers in the network", servers);
 	cmd.AddValue ("networks", "Number of networks in the simulation", networks);
+	cmd.AddValue ("results", "Directory to place results", results);
+	cmd.AddValue ("progress", "Wall clock seconds between progress reports, 0 disables", progress);
+	cmd.AddValue ("progressfile", "Write progress reports as JSON lines to this file", progressFile);
+	cmd.AddValue ("timing", "Append phase timings as a JSON record to this file", timingFile);
 	cmd.Parse (argc,argv);
+
+	// Count events for the progress meter, before any Node exists
+	ProgressMeter::EnableEventCounting ();
+
+	if (timingFile.empty ())
+	{
+		timingFile = std::string (results) + "/timing.json";
+	}
+
+	// Wall clock time spent in each phase of the run
+	PhaseTimer timer ("disaster-ccn-server-random");
+	timer.SetParameter ("networks", networks);
+	timer.SetParameter ("servers", servers);
+	timer.SetParameter ("clients", clients);
+	timer.SetParameter ("contentsize", contentsize);
+	timer.SetParameter ("strategy", "ns3::ndn::fw::Flooding");
+	timer.Begin ("topology");
 	/*if (nCN < 2)
 	{
 		std::cout << "Number of total CNs (" << nCN << ") lower than minimum of 2"
@@ -565,8 +581,6 @@ int main (int argc, char *argv[])
 		delete[] nodes_ring;
 	}
 
-	// Make sure to seed our random
-	gen.seed(std::time(0));
 	
 	// With the network assigned, time to randomly obtain clients and servers
 	NS_LOG_INFO ("Obtaining the clients and servers");
@@ -591,21 +605,26 @@ int main (int argc, char *argv[])
 	//ApplicationContainer apps;
 	//std::string prefix = "results/congestion-pop-run-";
 	
+	timer.Begin ("stack");
+
 	ndn::StackHelper ndnHelper;
 	//ndnHelper.SetDefaultRoutes (true);
 	// Install Content Store
 	ndnHelper.SetContentStore("ns3::ndn::cs::Lru","MaxSize","10000");
 	ndnHelper.InstallAll ();
 	
+	timer.Begin ("routes");
+
 	ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
 	ndnGlobalRoutingHelper.InstallAll ();
 	ndnGlobalRoutingHelper.AddOrigins ("/Dinfo/tokyo/shinjuku/wasedau/net1/server/", nodes_net1[0][5].Get (0));
 	ndn::GlobalRoutingHelper::CalculateRoutes ();
 
 	
+	timer.Begin ("apps");
+
 	//ApplicationContainer apps;
 	ndn::AppHelper producerHelper ("ns3::ndn::Producer");
-	srand((int)time(NULL)); 
 	
 		for (uint32_t i = 0; i < clients ; i++)
 		{
@@ -621,21 +640,19 @@ int main (int argc, char *argv[])
 			
 			
 
-			int r = rand()%clients;
+			int r = RngStreams::GetInteger ("prefix", 0, clients - 1);
 			
-			char   newprefix[64]="/Dinfo/tokyo/shinjuku/wasedau/net1/server/";
-			//std::string prefix = "/Dinfo/tokyo/shinjuku/wasedau/net1/server/";
-			sprintf (newprefix, "%s%d", newprefix,r);
+			uint32_t newprefix = ndn::NameTable::Intern ("/Dinfo/tokyo/shinjuku/wasedau/net1/server/" + lexical_cast<std::string> (r));
 			
 			
 			ndn::AppHelper consumerHelper ("ns3::ndn::ConsumerCbr");
 			consumerHelper.SetAttribute ("Frequency", StringValue ("1000")); 
 			consumerHelper.SetAttribute ("MaxSeq", IntegerValue (10240));
 			consumerHelper.SetAttribute ("Randomize", StringValue ("exponential"));
-			consumerHelper.SetPrefix (newprefix);
+			ndn::NameTable::SetPrefix (consumerHelper, newprefix);
 			consumerHelper.Install (clientNodes.Get (i));
 				
-			producerHelper.SetPrefix (newprefix);
+			ndn::NameTable::SetPrefix (producerHelper, newprefix);
 			producerHelper.SetAttribute ("PayloadSize", StringValue("1024"));
 			producerHelper.SetAttribute ("Freshness", TimeValue (Seconds(0)));
 			producerHelper.Install (nodes_net1[0][5].Get (0));
@@ -694,7 +711,7 @@ int main (int argc, char *argv[])
 			StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
 	Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (512));
 
-	Ptr<UniformRandomVariable> urng = CreateObject<UniformRandomVariable> ();
+	Ptr<UniformRandomVariable> urng = RngStreams::Get ("arrivals");
 	int r1;
 	double r2;
 	for (int z = 0; z < nCN; ++z)
@@ -839,7 +856,16 @@ int main (int argc, char *argv[])
 	//p2p_1gb5ms.EnablePcap ("results/tcp_test1.pcap", serverNodes.Get(1)->GetId (), true,true);
 	Simulator::Stop (Seconds (20.0));
 
+	ProgressMeter meter (progress, progressFile);
+	meter.Start ();
+
+	timer.Begin ("run");
 	Simulator::Run ();
+	timer.Begin ("teardown");
 	Simulator::Destroy ();
+	timer.End ();
+
+	timer.Print (std::cout);
+	timer.Write (timingFile);
 	return 0;
 }
@@ -49,20 +49,14 @@
 #include <ns3-dev/ns3/ipv4-nix-vector-helper.h>
 #include <ns3-dev/ns3/ndnSIM-module.h>
 
-using namespace ns3;
+// Extensions
+#include "phase-timer.h"
+#include "progress-meter.h"
 
-typedef struct timeval TIMER_TYPE;
-#define TIMER_NOW(_t) gettimeofday (&_t,NULL);
-#define TIMER_SECONDS(_t) ((double)(_t).tv_sec + (_t).tv_usec*1e-6)
-#define TIMER_DIFF(_t1, _t2) (TIMER_SECONDS (_t1)-TIMER_SECONDS (_t2))
+using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("CampusNetworkModel");
 
-void Progress ()
-{
-	Simulator::Schedule (Seconds (0.1), Progress);
-}
-
 template <typename T>
 class Array2D
 {
@@ -124,20 +118,42 @@ private:
 
 int main (int argc, char *argv[])
 {
-	TIMER_TYPE t0, t1, t2;
-	TIMER_NOW (t0);
 	std::cout << " ==== DARPA NMS CAMPUS NETWORK SIMULATION ====" << std::endl;
 	LogComponentEnable ("OnOffApplication", LOG_LEVEL_INFO);
 
 	int nCN = 3, nLANClients = 42;
 	bool nix = true;
 
+	char results[250] = "results";
+	double progress = 10.0;
+	std::string progressFile;
+	std::string timingFile;
+
 	CommandLine cmd;
 	cmd.AddValue ("CN", "Number of total CNs [2]", nCN);
 	cmd.AddValue ("LAN", "Number of nodes per LAN [42]", nLANClients);
 	cmd.AddValue ("NIX", "Toggle nix-vector routing", nix);
+	cmd.AddValue ("results", "Directory to place results", results);
+	cmd.AddValue ("progress", "Wall clock seconds between progress reports, 0 disables", progress);
+	cmd.AddValue ("progressfile", "Write progress reports as JSON lines to this file", progressFile);
+	cmd.AddValue ("timing", "Append phase timings as a JSON record to this file", timingFile);
 	cmd.Parse (argc,argv);
 
+	// Count events for the progress meter, before any Node exists
+	ProgressMeter::EnableEventCounting ();
+
+	if (timingFile.empty ())
+	{
+		timingFile = std::string (results) + "/timing.json";
+	}
+
+	// Wall clock time spent in each phase of the run
+	PhaseTimer timer ("disaster-ccn-with-routing");
+	timer.SetParameter ("networks", nCN);
+	timer.SetParameter ("lan", nLANClients);
+	timer.SetParameter ("strategy", "ns3::ndn::fw::Flooding");
+	timer.Begin ("topology");
+
 	if (nCN < 2)
 	{
 		std::cout << "Number of total CNs (" << nCN << ") lower than minimum of 2"
@@ -557,6 +573,8 @@ int main (int argc, char *argv[])
 
 	delete[] nodes_netLR;*/
 
+	timer.Begin ("stack");
+
 	ndn::StackHelper ndnHelper;
 	
 	//ndnHelper.SetDefaultRoutes (true);
@@ -564,11 +582,15 @@ int main (int argc, char *argv[])
 	ndnHelper.InstallAll ();
 	
 	
+	timer.Begin ("routes");
+
 	ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
 	ndnGlobalRoutingHelper.InstallAll ();
 	ndnGlobalRoutingHelper.AddOrigins ("/Dinfo/tokyo/shinjuku/waseda-u/waseda", nodes_net1[0][5].Get (0));
 	ndn::GlobalRoutingHelper::CalculateRoutes ();
 
+	timer.Begin ("apps");
+
 	// Consumer
 	ndn::AppHelper consumerHelper ("ns3::ndn::ConsumerCbr");
 	// Consumer will request /prefix/0, /prefix/1, ...
@@ -589,7 +611,16 @@ int main (int argc, char *argv[])
 	p2p_1gb5ms.EnablePcap ("test1.pcap", nodes_net1[0][5].Get (0)->GetId (), true,true);
 	Simulator::Stop (Seconds (20.0));
 
+	ProgressMeter meter (progress, progressFile);
+	meter.Start ();
+
+	timer.Begin ("run");
 	Simulator::Run ();
+	timer.Begin ("teardown");
 	Simulator::Destroy ();
+	timer.End ();
+
+	timer.Print (std::cout);
+	timer.Write (timingFile);
 	return 0;
 }
@@ -74,26 +74,22 @@
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-rate-l3-tracer.h>
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-seqs-app-tracer.h>
 
+// Extensions
+#include "phase-timer.h"
+#include "progress-meter.h"
+#include "rng-streams.h"
+
 using namespace ns3;
 using namespace boost;
 
 namespace br = boost::random;
 
-typedef struct timeval TIMER_TYPE;
-#define TIMER_NOW(_t) gettimeofday (&_t,NULL);
-#define TIMER_SECONDS(_t) ((double)(_t).tv_sec + (_t).tv_usec*1e-6)
-#define TIMER_DIFF(_t1, _t2) (TIMER_SECONDS (_t1)-TIMER_SECONDS (_t2))
-
 NS_LOG_COMPONENT_DEFINE ("CampusNetworkModel");
 
-// Number generator
-br::mt19937_64 gen;
-
 // Obtains a random number from a uniform distribution between min and max.
-// Must seed number generator to ensure randomness at runtime.
+// Drawn from the placement stream, so it only depends on --RngRun.
 int obtain_Num(int min, int max) {
-    br::uniform_int_distribution<> dist(min, max);
-    return dist(gen);
+    return RngStreams::GetInteger ("placement", min, max);
 }
 
 // Obtains a random list of clients and servers. Must be run once all nodes have been
@@ -156,9 +152,23 @@ tuple<std::vector<Ptr<Node> >, std::vector<Ptr<Node> > > assignClientsandServers
 	return tuple<std::vector<Ptr<Node> >, std::vector<Ptr<Node> > > (ClientContainer,ServerContainer);
 }
 
-void Progress ()
-{
-	Simulator::Schedule (Seconds (0.1), Progress);
+// Pcap of a point to point device truncated to snaplen bytes, which is
+// enough for the PPP, IPv4 and TCP headers without the payload. Named as
+// PointToPointHelper::EnablePcap () names it from prefix
+void EnableHeaderPcap (std::string prefix, uint32_t nodeId, uint32_t deviceId, uint32_t snaplen) {
+	Ptr<PointToPointNetDevice> device =
+			DynamicCast<PointToPointNetDevice> (NodeList::GetNode (nodeId)->GetDevice (deviceId));
+
+	if (device == 0)
+	{
+		NS_LOG_WARN ("Node " << nodeId << " device " << deviceId << " is not point to point, no pcap");
+		return;
+	}
+
+	PcapHelper pcapHelper;
+	std::string filename = pcapHelper.GetFilenameFromDevice (prefix, device);
+	Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, PcapHelper::DLT_PPP, snaplen);
+	pcapHelper.HookDefaultSink<PointToPointNetDevice> (device, "PromiscSniffer", file);
 }
 
 template <typename T>
@@ -226,8 +236,6 @@ private:
 
 int main (int argc, char *argv[])
 {
-	TIMER_TYPE t0, t1, t2;
-	TIMER_NOW (t0);
 	std::cout << " ==== DARPA NMS CAMPUS NETWORK SIMULATION - TCP Bulk run====" << std::endl;
 	//LogComponentEnable ("OnOffApplication", LOG_LEVEL_INFO);
 
@@ -244,6 +252,12 @@ int main (int argc, char *argv[])
 	uint32_t networks = 1; // Number of additional nodes in the network
 	char results[250] = "results";
 
+	double progress = 10.0;
+	std::string progressFile;
+	std::string timingFile;
+	bool pcap = true;
+	uint32_t snaplen = 96;
+
 	CommandLine cmd;
 	cmd.AddValue ("CN", "Number of total CNs [2]", nCN);
 	cmd.AddValue ("LAN", "Number of nodes per LAN [42]", nLANClients);
@@ -254,8 +268,30 @@ int main (int argc, char *argv[])
 	cmd.AddValue ("servers", "Total number of servers in the network", servers);
 	cmd.AddValue ("networks", "Number of networks in the simulation", networks);
 	cmd.AddValue ("results", "Directory to place results", results);
+	cmd.AddValue ("progress", "Wall clock seconds between progress reports, 0 disables", progress);
+	cmd.AddValue ("progressfile", "Write progress reports as JSON lines to this file", progressFile);
+	cmd.AddValue ("timing", "Append phase timings as a JSON record to this file", timingFile);
+	cmd.AddValue ("pcap", "Capture the server link headers to a pcap file", pcap);
+	cmd.AddValue ("snaplen", "Bytes kept per packet in the pcap file", snaplen);
 	cmd.Parse (argc,argv);
 
+	// Count events for the progress meter, before any Node exists
+	ProgressMeter::EnableEventCounting ();
+
+	if (timingFile.empty ())
+	{
+		timingFile = std::string (results) + "/timing.json";
+	}
+
+	// Wall clock time spent in each phase of the run
+	PhaseTimer timer ("disaster-tcp-onoff-scenario1");
+	timer.SetParameter ("networks", networks);
+	timer.SetParameter ("servers", servers);
+	timer.SetParameter ("clients", clients);
+	timer.SetParameter ("contentsize", contentsize);
+	timer.SetParameter ("strategy", "tcp");
+	timer.Begin ("topology");
+
 	/*if (nCN < 2)
 	{
 		std::cout << "Number of total CNs (" << nCN << ") lower than minimum of 2"
@@ -552,8 +588,8 @@ int main (int argc, char *argv[])
 		delete[] nodes_ring;
 	}
 
-	// Make sure to seed our random
-	gen.seed(std::time(0));
+	timer.Begin ("apps");
+
     
 	// With the network assigned, time to randomly obtain clients and servers
 	NS_LOG_INFO ("Obtaining the clients and servers");
@@ -639,7 +675,7 @@ int main (int argc, char *argv[])
 
 			uint32_t num_ifaces = ipv4Client->GetNInterfaces();
 
-			uint32_t random_iface = obtain_Num(1, num_ifaces-1);
+			uint32_t random_iface = RngStreams::GetInteger ("interface", 1, num_ifaces-1);
 
 			Ptr<NetDevice> tmpDevice = ipv4Client->GetNetDevice(random_iface);
 
@@ -755,13 +791,25 @@ int main (int argc, char *argv[])
 	NS_LOG_INFO ("Printing L2 Drop Tracer");
 	L2RateTracer::InstallAll (filename, Seconds (0.5));
 
-    sprintf (filename, "%s/tcp_server-%02d-%03d-%03d-%0*d.pcap", results, networks, servers, clients, 12, contentsize);
-    p2p_1gb5ms.EnablePcap (filename, 8, true,true);
-    //p2p_1gb5ms.EnablePcap ("results/tcp_server.pcap", 8, true,true);
+	if (pcap)
+	{
+		sprintf (filename, "%s/tcp_server-%02d-%03d-%03d-%0*d.pcap", results, networks, servers, clients, 12, contentsize);
+		EnableHeaderPcap (filename, 8, 1, snaplen);
+	}
 
 	Simulator::Stop (Seconds (100.0));
+
+	ProgressMeter meter (progress, progressFile);
+	meter.Start ();
+
+	timer.Begin ("run");
 	Simulator::Run ();
+	timer.Begin ("teardown");
 	Simulator::Destroy ();
+	timer.End ();
+
+	timer.Print (std::cout);
+	timer.Write (timingFile);
 
 	return 0;
 }
@@ -32,6 +32,9 @@
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-seqs-app-tracer.h>
 #include <ns3-dev/ns3/ndnSIM-module.h>
 
+// Extensions
+#include "rng-streams.h"
+
 using namespace ns3;
 using namespace boost;
 
@@ -44,14 +47,10 @@ typedef struct timeval TIMER_TYPE;
 
 NS_LOG_COMPONENT_DEFINE ("TCPBulkTest");
 
-// Number generator
-br::mt19937_64 gen;
-
 // Obtains a random number from a uniform distribution between min and max.
-// Must seed number generator to ensure randomness at runtime.
+// Drawn from the placement stream, so it only depends on --RngRun.
 int obtain_Num(int min, int max) {
-    br::uniform_int_distribution<> dist(min, max);
-    return dist(gen);
+    return RngStreams::GetInteger ("placement", min, max);
 }
 
 // Obtains a random list of clients and servers. Must be run once all nodes have been
@@ -126,8 +125,6 @@ int main (int argc, char *argv[])
 	// Temporary storage for strings
 	char buffer[250];
 
-	// Make sure to seed our random
-	gen.seed(std::time(0));
 
 	//
 	// Allow the user to override any of the defaults at
@@ -70,26 +70,22 @@
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-rate-l3-tracer.h>
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-seqs-app-tracer.h>
 
+// Extensions
+#include "phase-timer.h"
+#include "progress-meter.h"
+#include "rng-streams.h"
+
 using namespace ns3;
 using namespace boost;
 
 namespace br = boost::random;
 
-typedef struct timeval TIMER_TYPE;
-#define TIMER_NOW(_t) gettimeofday (&_t,NULL);
-#define TIMER_SECONDS(_t) ((double)(_t).tv_sec + (_t).tv_usec*1e-6)
-#define TIMER_DIFF(_t1, _t2) (TIMER_SECONDS (_t1)-TIMER_SECONDS (_t2))
-
 NS_LOG_COMPONENT_DEFINE ("CampusNetworkModel");
 
-// Number generator
-br::mt19937_64 gen;
-
 // Obtains a random number from a uniform distribution between min and max.
-// Must seed number generator to ensure randomness at runtime.
+// Drawn from the placement stream, so it only depends on --RngRun.
 int obtain_Num(int min, int max) {
-    br::uniform_int_distribution<> dist(min, max);
-    return dist(gen);
+    return RngStreams::GetInteger ("placement", min, max);
 }
 
 std::vector<Ptr<Node> > getVector(NodeContainer node) {
@@ -195,11 +191,6 @@ tuple<std::vector<Ptr<Node> >, std::vector<Ptr<Node> > > assignCompleteRandom(in
 	return assignClientsandServers(global, num_clients, num_servers);
 }
 
-void Progress ()
-{
-	Simulator::Schedule (Seconds (0.1), Progress);
-}
-
 template <typename T>
 class Array2D
 {
@@ -265,8 +256,6 @@ private:
 
 int main (int argc, char *argv[])
 {
-	TIMER_TYPE t0, t1, t2;
-	TIMER_NOW (t0);
 	std::cout << " ==== DARPA NMS CAMPUS NETWORK SIMULATION - TCP Bulk run====" << std::endl;
 	//LogComponentEnable ("OnOffApplication", LOG_LEVEL_INFO);
 
@@ -283,6 +272,10 @@ int main (int argc, char *argv[])
 	uint32_t networks = 1; // Number of additional nodes in the network
 	char results[250] = "results";
 
+	double progress = 10.0;
+	std::string progressFile;
+	std::string timingFile;
+
 	CommandLine cmd;
 	cmd.AddValue ("CN", "Number of total CNs [2]", nCN);
 	cmd.AddValue ("LAN", "Number of nodes per LAN [42]", nLANClients);
@@ -293,8 +286,28 @@ int main (int argc, char *argv[])
 	cmd.AddValue ("servers", "Total number of servers in the network", servers);
 	cmd.AddValue ("networks", "Number of networks in the simulation", networks);
 	cmd.AddValue ("results", "Directory to place results", results);
+	cmd.AddValue ("progress", "Wall clock seconds between progress reports, 0 disables", progress);
+	cmd.AddValue ("progressfile", "Write progress reports as JSON lines to this file", progressFile);
+	cmd.AddValue ("timing", "Append phase timings as a JSON record to this file", timingFile);
 	cmd.Parse (argc,argv);
 
+	// Count events for the progress meter, before any Node exists
+	ProgressMeter::EnableEventCounting ();
+
+	if (timingFile.empty ())
+	{
+		timingFile = std::string (results) + "/timing.json";
+	}
+
+	// Wall clock time spent in each phase of the run
+	PhaseTimer timer ("disaster-tcp");
+	timer.SetParameter ("networks", networks);
+	timer.SetParameter ("servers", servers);
+	timer.SetParameter ("clients", clients);
+	timer.SetParameter ("contentsize", contentsize);
+	timer.SetParameter ("strategy", "tcp");
+	timer.Begin ("topology");
+
 	/*if (nCN < 2)
 	{
 		std::cout << "Number of total CNs (" << nCN << ") lower than minimum of 2"
@@ -591,8 +604,8 @@ int main (int argc, char *argv[])
 		delete[] nodes_ring;
 	}
 
-	// Make sure to seed our random
-	gen.seed(std::time(0));
+	timer.Begin ("apps");
+
     
 	// With the network assigned, time to randomly obtain clients and servers
 	NS_LOG_INFO ("Obtaining the clients and servers");
@@ -723,7 +736,7 @@ int main (int argc, char *argv[])
 
 			uint32_t num_ifaces = ipv4Client->GetNInterfaces();
 
-			uint32_t random_iface = obtain_Num(1, num_ifaces-1);
+			uint32_t random_iface = RngStreams::GetInteger ("interface", 1, num_ifaces-1);
 
 			Ptr<NetDevice> tmpDevice = ipv4Client->GetNetDevice(random_iface);
 
@@ -783,7 +796,7 @@ int main (int argc, char *argv[])
 			StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
 	Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (512));
 
-	Ptr<UniformRandomVariable> urng = CreateObject<UniformRandomVariable> ();
+	Ptr<UniformRandomVariable> urng = RngStreams::Get ("arrivals");
 	int r1;
 	double r2;
 	for (int z = 0; z < nCN; ++z)
@@ -1023,8 +1036,18 @@ int main (int argc, char *argv[])
 	L2RateTracer::InstallAll (filename, Seconds (0.5));
 
 	Simulator::Stop (Seconds (20.0));
+
+	ProgressMeter meter (progress, progressFile);
+	meter.Start ();
+
+	timer.Begin ("run");
 	Simulator::Run ();
+	timer.Begin ("teardown");
 	Simulator::Destroy ();
+	timer.End ();
+
+	timer.Print (std::cout);
+	timer.Write (timingFile);
 
 	return 0;
 }
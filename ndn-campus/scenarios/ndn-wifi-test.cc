@@ -32,6 +32,11 @@
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-rate-l3-tracer.h>
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-seqs-app-tracer.h>
 
+// Extensions
+#include "cached-propagation-loss-model.h"
+#include "grid-wifi-channel.h"
+#include "unit-disk-helper.h"
+
 using namespace ns3;
 using namespace boost;
 
@@ -54,6 +59,7 @@ int main (int argc, char *argv[])
 	uint32_t mobile = 1;				// Number of mobile terminals
 	uint32_t clients = 1;				// Number of clients in the network
 	uint32_t nodes = 12;				// Number of nodes in the network
+	std::string phy = "wifi";			// Wireless model, wifi or unitdisk
 
 	char results[250] = "results";
 	char buffer[250];
@@ -67,8 +73,16 @@ int main (int argc, char *argv[])
 	cmd.AddValue ("contentsize",
 			"Total number of bytes for application to send", contentsize);
 	cmd.AddValue ("results", "Directory to place results", results);
+	cmd.AddValue ("phy", "Wireless model of the terminal and AP: wifi (802.11a) or unitdisk", phy);
 	cmd.Parse (argc,argv);
 
+	if (phy != "wifi" && phy != "unitdisk")
+	{
+		std::cerr << "Unknown wireless model " << phy << ", use wifi or unitdisk" << std::endl;
+		return 1;
+	}
+	bool unitdisk = (phy == "unitdisk");
+
 	// Node definitions for mobile terminals
 	NodeContainer mobileTerminalContainer;
 	mobileTerminalContainer.Create(1);
@@ -139,7 +153,9 @@ int main (int argc, char *argv[])
 
 	YansWifiChannelHelper wifiChannel;
 	wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
-	wifiChannel.AddPropagationLoss ("ns3::ThreeLogDistancePropagationLossModel");
+	// Same path loss, computed once between the static APs and routers
+	wifiChannel.AddPropagationLoss ("ns3::CachedPropagationLossModel",
+			"Model", PointerValue (CreateObject<ThreeLogDistancePropagationLossModel> ()));
 	wifiChannel.AddPropagationLoss ("ns3::NakagamiPropagationLossModel");
 
 	YansWifiPhyHelper wifiPhyHelper = YansWifiPhyHelper::Default ();
@@ -147,6 +163,12 @@ int main (int argc, char *argv[])
 	wifiPhyHelper.Set("TxPowerStart", DoubleValue(5));
 	wifiPhyHelper.Set("TxPowerEnd", DoubleValue(5));
 
+	// Same mean range and rate as the Wi-Fi cards
+	UnitDiskHelper unitDisk;
+	unitDisk.SetChannelAttribute ("Range",
+			DoubleValue (GridWifiChannel::GetRange (CreateObject<ThreeLogDistancePropagationLossModel> (), 5, -96)));
+	unitDisk.SetDeviceAttribute ("DataRate", StringValue ("6Mbps"));
+
 	Ssid ssid = Ssid("test");
 
 	NqosWifiMacHelper wifiMacHelper = NqosWifiMacHelper::Default ();
@@ -154,7 +176,8 @@ int main (int argc, char *argv[])
 			"Ssid", SsidValue (ssid),
 			"ActiveProbing", BooleanValue (true));
 
-	NetDeviceContainer wifiMTNetDevices = wifi.Install (wifiPhyHelper, wifiMacHelper, mobileTerminalContainer);
+	NetDeviceContainer wifiMTNetDevices = unitdisk ? unitDisk.Install (mobileTerminalContainer)
+			: wifi.Install (wifiPhyHelper, wifiMacHelper, mobileTerminalContainer);
 
 
 	wifiMacHelper.SetType ("ns3::ApWifiMac",
@@ -162,7 +185,8 @@ int main (int argc, char *argv[])
 			"BeaconGeneration", BooleanValue (true),
 			"BeaconInterval", TimeValue (Seconds (0.1)));
 
-	NetDeviceContainer wifiAPNetDevices = wifi.Install (wifiPhyHelper, wifiMacHelper, routerNode.Get (0));
+	NetDeviceContainer wifiAPNetDevices = unitdisk ? unitDisk.Install (routerNode.Get (0))
+			: wifi.Install (wifiPhyHelper, wifiMacHelper, routerNode.Get (0));
 
 	PointToPointHelper p2p_1gb5ms;
 	p2p_1gb5ms.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
@@ -73,26 +73,22 @@
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-rate-l3-tracer.h>
 #include <ns3-dev/ns3/ndnSIM/utils/tracers/ipv4-seqs-app-tracer.h>
 
+// Extensions
+#include "phase-timer.h"
+#include "progress-meter.h"
+#include "rng-streams.h"
+
 using namespace ns3;
 using namespace boost;
 
 namespace br = boost::random;
 
-typedef struct timeval TIMER_TYPE;
-#define TIMER_NOW(_t) gettimeofday (&_t,NULL);
-#define TIMER_SECONDS(_t) ((double)(_t).tv_sec + (_t).tv_usec*1e-6)
-#define TIMER_DIFF(_t1, _t2) (TIMER_SECONDS (_t1)-TIMER_SECONDS (_t2))
-
 NS_LOG_COMPONENT_DEFINE ("CampusNetworkModel");
 
-// Number generator
-br::mt19937_64 gen;
-
 // Obtains a random number from a uniform distribution between min and max.
-// Must seed number generator to ensure randomness at runtime.
+// Drawn from the placement stream, so it only depends on --RngRun.
 int obtain_Num(int min, int max) {
-    br::uniform_int_distribution<> dist(min, max);
-    return dist(gen);
+    return RngStreams::GetInteger ("placement", min, max);
 }
 
 // Obtains a random list of clients and servers. Must be run once all nodes have been
@@ -155,11 +151,6 @@ tuple<std::vector<Ptr<Node> >, std::vector<Ptr<Node> > > assignClientsandServers
 	return tuple<std::vector<Ptr<Node> >, std::vector<Ptr<Node> > > (ClientContainer,ServerContainer);
 }
 
-void Progress ()
-{
-	Simulator::Schedule (Seconds (0.1), Progress);
-}
-
 template <typename T>
 class Array2D
 {
@@ -221,8 +212,6 @@ private:
 
 int main (int argc, char *argv[])
 {
-	TIMER_TYPE t0, t1, t2;
-	TIMER_NOW (t0);
 	std::cout << " ==== DARPA NMS CAMPUS NETWORK SIMULATION ====" << std::endl;
 	LogComponentEnable ("OnOffApplication", LOG_LEVEL_INFO);
 
@@ -240,6 +229,10 @@ int main (int argc, char *argv[])
 
         char results[250] = "results";
 
+	double progress = 10.0;
+	std::string progressFile;
+	std::string timingFile;
+
 	CommandLine cmd;
 	cmd.AddValue ("CN", "Number of total CNs [2]", nCN);
 	cmd.AddValue ("LAN", "Number of nodes per LAN [42]", nLANClients);
@@ -250,7 +243,27 @@ int main (int argc, char *argv[])
 	cmd.AddValue ("servers", "Total number of servers in the network", servers);
 	cmd.AddValue ("networks", "Number of networks in the simulation", networks);
 	cmd.AddValue ("results", "Directory to place results", results);
+	cmd.AddValue ("progress", "Wall clock seconds between progress reports, 0 disables", progress);
+	cmd.AddValue ("progressfile", "Write progress reports as JSON lines to this file", progressFile);
+	cmd.AddValue ("timing", "Append phase timings as a JSON record to this file", timingFile);
 	cmd.Parse (argc,argv);
+
+	// Count events for the progress meter, before any Node exists
+	ProgressMeter::EnableEventCounting ();
+
+	if (timingFile.empty ())
+	{
+		timingFile = std::string (results) + "/timing.json";
+	}
+
+	// Wall clock time spent in each phase of the run
+	PhaseTimer timer ("nms-disaster-ccn_zl");
+	timer.SetParameter ("networks", networks);
+	timer.SetParameter ("servers", servers);
+	timer.SetParameter ("clients", clients);
+	timer.SetParameter ("contentsize", contentsize);
+	timer.SetParameter ("strategy", "ns3::ndn::fw::Flooding");
+	timer.Begin ("topology");
 	/*if (nCN < 2)
 	{
 		std::cout << "Number of total CNs (" << nCN << ") lower than minimum of 2"
@@ -567,8 +580,6 @@ int main (int argc, char *argv[])
 		delete[] nodes_ring;
 	}
 
-	// Make sure to seed our random
-	gen.seed(std::time(0));
 	
 	// With the network assigned, time to randomly obtain clients and servers
 	NS_LOG_INFO ("Obtaining the clients and servers");
@@ -623,7 +634,7 @@ int main (int argc, char *argv[])
 			StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
 	Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (512));
 
-	Ptr<UniformRandomVariable> urng = CreateObject<UniformRandomVariable> ();
+	Ptr<UniformRandomVariable> urng = RngStreams::Get ("arrivals");
 	int r1;
 	double r2;
 	for (int z = 0; z < nCN; ++z)
@@ -723,6 +734,8 @@ int main (int argc, char *argv[])
 
 	// Calculate routing tables
 	
+		timer.Begin ("stack");
+
 		//std::cout << "Populating Global Static Routing Tables..." << std::endl;
 	//Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
 	ndn::StackHelper ndnHelper;
@@ -732,11 +745,15 @@ int main (int argc, char *argv[])
 	ndnHelper.SetContentStore("ns3::ndn::cs::Lru","MaxSize","10000");
 	ndnHelper.InstallAll ();
 	
+	timer.Begin ("routes");
+
 	ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
 		ndnGlobalRoutingHelper.InstallAll ();
 		ndnGlobalRoutingHelper.AddOrigins ("/Dinfo/tokyo/shinjuku/waseda-u/waseda", serverNodes);
 		ndn::GlobalRoutingHelper::CalculateRoutes ();
 
+	timer.Begin ("apps");
+
 	// Consumer
 	ndn::AppHelper consumerHelper ("ns3::ndn::ConsumerCbr");
 	// Consumer will request /prefix/0, /prefix/1, ...
@@ -831,7 +848,16 @@ int main (int argc, char *argv[])
 	//p2p_1gb5ms.EnablePcap ("results/tcp_test1.pcap", serverNodes.Get(1)->GetId (), true,true);
 	Simulator::Stop (Seconds (120.0));
 
+	ProgressMeter meter (progress, progressFile);
+	meter.Start ();
+
+	timer.Begin ("run");
 	Simulator::Run ();
+	timer.Begin ("teardown");
 	Simulator::Destroy ();
+	timer.End ();
+
+	timer.Print (std::cout);
+	timer.Write (timingFile);
 	return 0;
 }
@@ -0,0 +1,67 @@
+#!/usr/bin/env python
+# -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+
+# Runs one small scenario with --phy=wifi and --phy=unitdisk for the same
+# RngRuns and compares the two wireless models: wall clock time and the
+# NDN metrics of the app delay traces, satisfied Interests, mean full
+# delay, mean retransmissions and mean hop count. Use it before trusting
+# the unit disk model with a new scenario or setting.
+#
+#   ./validate-phy.py -r 5
+#   ./validate-phy.py -b build/ccn-mobility-jl -- --trace --clients=4
+
+from __future__ import print_function
+
+import argparse
+import glob
+import os
+import sys
+
+import runstats
+
+parser = argparse.ArgumentParser(description='Wi-Fi vs unit disk validation')
+parser.add_argument('-b', '--binary', dest='binary', type=str, default='build/ndn-wifi-test',
+                    help='Scenario binary, taking --phy and --results [build/ndn-wifi-test]')
+parser.add_argument('-r', '--runs', dest='runs', type=int, default=3,
+                    help='RngRuns per model [3]')
+parser.add_argument('-d', '--dir', dest='dir', type=str, default='results/validate-phy',
+                    help='Results directory [results/validate-phy]')
+parser.add_argument('-t', '--tolerance', dest='tolerance', type=float, default=10.0,
+                    help='Largest change of a metric, in percent, still reported as OK [10]')
+parser.add_argument('args', metavar='arg', type=str, nargs='*',
+                    help='Extra scenario arguments')
+
+args = parser.parse_args()
+
+def run(phy, rngrun):
+    results = os.path.join(args.dir, phy, 'run-%02d' % rngrun)
+    cmd = [args.binary, '--phy=%s' % phy, '--results=%s' % results,
+           '--RngRun=%d' % rngrun] + args.args
+    time = runstats.run(cmd, results)
+
+    # A run that never connects would otherwise compare 0 with 0 and pass
+    if not glob.glob(os.path.join(results, '*-app-delays-*')):
+        sys.exit('%s wrote no app delay trace, see %s/run.log' % (phy, results))
+    delays = runstats.delays(results)
+    if delays[0] == 0:
+        sys.exit('%s satisfied no Interests, see %s/run.log' % (phy, results))
+    return {'time': time}, delays
+
+wifi = runstats.summary([run('wifi', i) for i in range(1, args.runs + 1)])
+unitdisk = runstats.summary([run('unitdisk', i) for i in range(1, args.runs + 1)])
+
+failed = False
+print('%-12s %12s %12s %10s' % ('', 'wifi', 'unitdisk', 'change'))
+for key, label in [('time', 'time (s)'), ('interests', 'interests'), ('delay', 'delay (s)'),
+                   ('retx', 'retx'), ('hops', 'hops')]:
+    change = runstats.change(wifi[key], unitdisk[key])
+    verdict = ''
+    if key != 'time':
+        verdict = 'OK' if abs(change) <= args.tolerance else 'DIFFERS'
+        failed = failed or verdict != 'OK'
+    print('%-12s %12.4f %12.4f %9.1f%% %s' % (label, wifi[key], unitdisk[key], change, verdict))
+
+if unitdisk['time'] > 0:
+    print('Speedup: %.2fx' % (wifi['time'] / unitdisk['time']))
+
+sys.exit(1 if failed else 0)